@@ -0,0 +1,79 @@
+/**
+ * CPL - Common Portability Library
+ *
+ * Copyright (C) 2024 Merlot.Rain
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <cpl_ports.h>
+#include <chrono>
+#include <cstdio>
+#include <functional>
+
+using namespace CPL;
+
+/// Sum of all hash values, printed at the end so the hashing cannot be elided
+static unsigned long long s_nSink = 0;
+
+/// Runs fn over the buffer for about 200ms and returns the throughput in MB/s
+template<typename Fn>
+static double measure(const std::string &data, size_t nLen, Fn fn)
+{
+    using Clock = std::chrono::steady_clock;
+    const size_t nKeys = data.size() - nLen;
+    unsigned long long nSink = 0;
+    size_t nBytes = 0;
+    Clock::time_point start = Clock::now();
+    Clock::duration elapsed{};
+    do {
+        for (size_t i = 0; i < 4096; ++i)
+        {
+            // vary the offset so the results cannot be hoisted out of the loop
+            nSink += fn(std::string_view(data.data() + (i * 61) % (nKeys + 1), nLen));
+        }
+        nBytes += 4096 * nLen;
+        elapsed = Clock::now() - start;
+    } while (elapsed < std::chrono::milliseconds(200));
+    s_nSink += nSink;
+    return nBytes / std::chrono::duration<double>(elapsed).count() / 1e6;
+}
+
+int main()
+{
+    std::string data(1 << 20, '\0');
+    for (size_t i = 0; i < data.size(); ++i)
+        data[i] = static_cast<char>(Hash::Mix(i));
+
+    std::printf("%10s %16s %16s %16s\n", "bytes", "Hash::String", "std::hash",
+                "HashNoCase");
+    for (size_t nLen: {4, 8, 16, 32, 64, 256, 4096, 65536})
+    {
+        double dHash = measure(data, nLen, [](std::string_view str) {
+            return Hash::String(str);
+        });
+        double dStd = measure(data, nLen, [](std::string_view str) {
+            return static_cast<unsigned long long>(
+                    std::hash<std::string_view>()(str));
+        });
+        double dNoCase = measure(data, nLen, [](std::string_view str) {
+            return static_cast<unsigned long long>(StringHelp::HashNoCase(str));
+        });
+        std::printf("%10zu %11.0f MB/s %11.0f MB/s %11.0f MB/s\n", nLen, dHash,
+                    dStd, dNoCase);
+    }
+    std::printf("checksum %016llx\n", s_nSink);
+    return 0;
+}
@@ -19,21 +19,68 @@
  */
 
 #include "cpl_any.h"
+#include "cpl_hash.h"
 #include "cpl_stringhelp.h"
+#include <atomic>
+#include <new>
 #include <sstream>
 #include <stdexcept>
 
 namespace CPL {
 
+namespace {
+
+/// Header in front of a shared string or blob payload
+struct SharedHeader
+{
+    std::atomic<int> Refs;
+    int Size;
+};
+
+SharedHeader *sharedHeader(const void *pData)
+{
+    return reinterpret_cast<SharedHeader *>(
+                   const_cast<void *>(pData)) - 1;
+}
+
+/// Allocates a shared buffer with one reference, holding the payload and a
+/// terminator, and returns the payload
+char *allocShared(const void *pData, int nSize)
+{
+    void *pBlock = ::operator new(sizeof(SharedHeader) + nSize + 1);
+    SharedHeader *pHeader = new (pBlock) SharedHeader;
+    pHeader->Refs.store(1, std::memory_order_relaxed);
+    pHeader->Size = nSize;
+    char *p = reinterpret_cast<char *>(pHeader + 1);
+    std::memcpy(p, pData, nSize);
+    p[nSize] = '\0';
+    return p;
+}
+
+void retainShared(const void *pData)
+{
+    sharedHeader(pData)->Refs.fetch_add(1, std::memory_order_relaxed);
+}
+
+void releaseShared(const void *pData)
+{
+    SharedHeader *pHeader = sharedHeader(pData);
+    if (pHeader->Refs.fetch_sub(1, std::memory_order_acq_rel) == 1)
+    {
+        pHeader->~SharedHeader();
+        ::operator delete(pHeader);
+    }
+}
+
+}// namespace
+
 Any::~Any()
 {
     switch (Type)
     {
         case eString:
-            delete[] strVal;
-            break;
         case eBinary:
-            delete[] blbVal;
+            releaseData();
             break;
         case eObject:
             delete objVal;
@@ -72,27 +119,21 @@ Any::Any(bool v) : Type(eBool) { boolVal = v; }
 
 Any::Any(RefObject *v) : Type(eObject) { objVal = v; }
 
-Any::Any(const char *v) : Type(eString)
-{
-    strVal = new char[std::strlen(v) + 1];
-    std::strcpy(strVal, v);
-}
+Any::Any(const char *v) : Type(eString) { assignString(v, std::strlen(v)); }
 
 Any::Any(const std::string &str) : Type(eString)
 {
-    strVal = new char[str.size() + 1];
-    std::strcpy(strVal, str.c_str());
+    assignString(str.c_str(), str.size());
 }
 
 Any::Any(const DateTime &v) : Type(eDateTime) { dateVal = v; }
 
 Any::Any(const unsigned char *v, int nLen) : Type(eBinary)
 {
-    blbVal = new unsigned char[nLen];
-    std::memcpy(blbVal, v, nLen);
+    assignBlob(v, nLen);
 }
 
-Any::Any(const Any &rhs) : Type(rhs.Type)
+Any::Any(const Any &rhs) : Type(rhs.Type), m_nBlobSize(rhs.m_nBlobSize)
 {
     switch (rhs.Type)
     {
@@ -133,17 +174,29 @@ Any::Any(const Any &rhs) : Type(rhs.Type)
             objVal = rhs.objVal;
             break;
         case eString:
-            strVal = new char[std::strlen(rhs.strVal) + 1];
-            std::strcpy(strVal, rhs.strVal);
+            if (rhs.m_bShared)
+            {
+                retainShared(rhs.strVal);
+                strVal = rhs.strVal;
+                m_bShared = true;
+            }
+            else if (rhs.m_bInline || rhs.strVal)
+                assignString(rhs.stringData(), std::strlen(rhs.stringData()));
+            else
+                strVal = nullptr;
             break;
         case eBinary:
+            if (rhs.m_bShared)
             {
-                int len =
-                        std::strlen(reinterpret_cast<const char *>(rhs.blbVal));
-                blbVal = new unsigned char[len];
-                std::memcpy(blbVal, rhs.blbVal, len);
-                break;
+                retainShared(rhs.blbVal);
+                blbVal = rhs.blbVal;
+                m_bShared = true;
             }
+            else if (rhs.m_bInline || rhs.blbVal)
+                assignBlob(rhs.blobData(), rhs.m_nBlobSize);
+            else
+                blbVal = nullptr;
+            break;
         case eDateTime:
             dateVal = rhs.dateVal;
             break;
@@ -152,11 +205,7 @@ Any::Any(const Any &rhs) : Type(rhs.Type)
     }
 }
 
-Any::Any(Any &&rhs) noexcept : Type(rhs.Type), cVal(rhs.cVal)
-{
-    // Move the data from rhs to this object
-    rhs.Type = eEmpty;
-}
+Any::Any(Any &&rhs) noexcept : Type(eEmpty) { moveFrom(rhs); }
 
 Any::Any(VarType type) : Type(type)
 {
@@ -203,9 +252,7 @@ Any &Any::operator=(Any &&rhs) noexcept
     if (this != &rhs)
     {
         this->Clear();
-        Type = rhs.Type;
-        rhs.Type = eEmpty;
-        std::memcpy(this, &rhs, sizeof(Any));
+        moveFrom(rhs);
     }
     return *this;
 }
@@ -302,8 +349,7 @@ Any &Any::operator=(const char *v)
 {
     Clear();
     Type = eString;
-    strVal = new char[std::strlen(v) + 1];
-    std::strcpy(strVal, v);
+    assignString(v, std::strlen(v));
     return *this;
 }
 
@@ -311,8 +357,7 @@ Any &Any::operator=(const std::string &str)
 {
     Clear();
     Type = eString;
-    strVal = new char[str.size() + 1];
-    std::strcpy(strVal, str.c_str());
+    assignString(str.c_str(), str.size());
     return *this;
 }
 
@@ -352,9 +397,12 @@ bool Any::operator==(const Any &o) const
         case eBool:
             return boolVal == o.boolVal;
         case eString:
-            return std::strcmp(strVal, o.strVal) == 0;
+            return std::strcmp(stringData(), o.stringData()) == 0;
         case eObject:
             return objVal == o.objVal;
+        case eBinary:
+            return m_nBlobSize == o.m_nBlobSize &&
+                   std::memcmp(blobData(), o.blobData(), m_nBlobSize) == 0;
         case eDateTime:
             return dateVal == o.dateVal;
         default:
@@ -452,7 +500,7 @@ RefObject *Any::AsObj() const
 char *Any::AsString() const
 {
     if (Type != eString) { throw std::invalid_argument("Type is not string."); }
-    return strVal;
+    return stringData();
 }
 
 DateTime Any::AsDateTime() const
@@ -467,9 +515,8 @@ DateTime Any::AsDateTime() const
 int Any::AsBlob(unsigned char *blob) const
 {
     if (Type != eBinary) { throw std::invalid_argument("Type is not binary."); }
-    std::memcpy(blob, blbVal,
-                std::strlen(reinterpret_cast<const char *>(blbVal)));
-    return std::strlen(reinterpret_cast<const char *>(blbVal));
+    std::memcpy(blob, blobData(), m_nBlobSize);
+    return m_nBlobSize;
 }
 
 Any::operator char() const
@@ -553,7 +600,7 @@ Any::operator double() const
 Any::operator const char *() const
 {
     if (Type != eString) { throw std::invalid_argument("Type is not string."); }
-    return strVal;
+    return stringData();
 }
 
 Any::operator RefObject *()
@@ -565,19 +612,24 @@ Any::operator RefObject *()
 void Any::Set(const unsigned char *bBlob, int nLen)
 {
     if (Type != eBinary) { throw std::invalid_argument("Type is not binary."); }
-    std::memcpy(blbVal, bBlob, nLen);
+    detachData();
+    std::memcpy(blobData(), bBlob, nLen);
 }
 
 void Any::Set(const char *str, int nLen)
 {
     if (Type != eString) { throw std::invalid_argument("Type is not string."); }
-    std::memcpy(strVal, str, nLen);
+    detachData();
+    std::memcpy(stringData(), str, nLen);
 }
 
 unsigned char *Any::AllocBlob(int nLen)
 {
     if (Type != eBinary) { throw std::invalid_argument("Type is not binary."); }
-    return blbVal;
+    // Allocate first, so the current payload is kept if that fails.
+    Any blob(static_cast<const unsigned char *>(nullptr), nLen);
+    Swap(blob);
+    return blobData();
 }
 
 int Any::ValueSize() const
@@ -585,9 +637,10 @@ int Any::ValueSize() const
     switch (Type)
     {
         case eString:
-            return std::strlen(strVal);
+            return m_bShared ? sharedHeader(strVal)->Size
+                             : static_cast<int>(std::strlen(stringData()));
         case eBinary:
-            return std::strlen(reinterpret_cast<const char *>(blbVal));
+            return m_nBlobSize;
         default:
             return 0;
     }
@@ -598,9 +651,9 @@ const void *Any::ValuePtr() const
     switch (Type)
     {
         case eString:
-            return strVal;
+            return stringData();
         case eBinary:
-            return blbVal;
+            return blobData();
         default:
             return nullptr;
     }
@@ -608,62 +661,65 @@ const void *Any::ValuePtr() const
 
 unsigned long long Any::HashCode() const
 {
-    unsigned long long hash = Type;
+    unsigned long long nBits = 0;
     switch (Type)
     {
         case eI1:
-            hash ^= cVal;
+            nBits = static_cast<unsigned long long>(cVal);
             break;
         case eUI1:
-            hash ^= ucVal;
+            nBits = ucVal;
             break;
         case eI2:
-            hash ^= sVal;
+            nBits = static_cast<unsigned long long>(sVal);
             break;
         case eUI2:
-            hash ^= usVal;
+            nBits = usVal;
             break;
         case eI4:
-            hash ^= iVal;
+            nBits = static_cast<unsigned long long>(iVal);
             break;
         case eUI4:
-            hash ^= uiVal;
+            nBits = uiVal;
             break;
         case eI8:
-            hash ^= llVal;
+            nBits = static_cast<unsigned long long>(llVal);
             break;
         case eUI8:
-            hash ^= ullVal;
+            nBits = ullVal;
             break;
         case eR4:
-            hash ^= *(reinterpret_cast<const unsigned int *>(&fltVal));
-            break;
+            {
+                // +0.0 and -0.0 compare equal
+                float value = fltVal == 0.0f ? 0.0f : fltVal;
+                unsigned int nFloatBits;
+                std::memcpy(&nFloatBits, &value, sizeof(nFloatBits));
+                nBits = nFloatBits;
+                break;
+            }
         case eR8:
-            hash ^= *(reinterpret_cast<const unsigned long long *>(&dblVal));
-            break;
+            {
+                double value = dblVal == 0.0 ? 0.0 : dblVal;
+                std::memcpy(&nBits, &value, sizeof(nBits));
+                break;
+            }
         case eBool:
-            hash ^= boolVal;
+            nBits = boolVal;
             break;
         case eObject:
-            hash ^= reinterpret_cast<unsigned long long>(objVal);
+            nBits = reinterpret_cast<unsigned long long>(objVal);
             break;
         case eString:
-            for (size_t i = 0; strVal[i] != '\0'; ++i) { hash ^= strVal[i]; }
-            break;
+            return Hash::Bytes(stringData(), std::strlen(stringData()), Type);
         case eBinary:
-            for (int i = 0;
-                 i < std::strlen(reinterpret_cast<const char *>(blbVal)); ++i)
-            {
-                hash ^= blbVal[i];
-            }
-            break;
+            return Hash::Bytes(blobData(), m_nBlobSize, Type);
         case eDateTime:
-            //hash ^= dateVal.HashCode();
+            nBits = static_cast<unsigned long long>(dateVal.UtcTime());
             break;
         default:
             break;
     }
-    return hash;
+    return Hash::Combine(static_cast<unsigned long long>(Type), nBits);
 }
 
 // ToString Implementation
@@ -673,7 +729,7 @@ std::string Any::ToString() const
     switch (Type)
     {
         case eString:
-            oss << strVal;
+            oss << stringData();
             break;
         case eI1:
             oss << cVal;
@@ -727,31 +783,137 @@ void Any::Clear()
     switch (Type)
     {
         case eString:
-            delete[] strVal;
-            break;
         case eBinary:
-            delete[] blbVal;
+            releaseData();
+            // A failed allocation in a following assignment must not free it again.
+            strVal = nullptr;
             break;
         default:
             break;
     }
     Type = eEmpty;
+    m_nBlobSize = 0;
+    m_bInline = false;
+    m_bShared = false;
 }
 
 void Any::Swap(Any &rhs)
 {
+    char temp[InlineCapacity];
+    std::memcpy(temp, inlVal, InlineCapacity);
+    std::memcpy(inlVal, rhs.inlVal, InlineCapacity);
+    std::memcpy(rhs.inlVal, temp, InlineCapacity);
     std::swap(Type, rhs.Type);
-    std::swap(cVal, rhs.cVal);
-    std::swap(strVal, rhs.strVal);
-    std::swap(blbVal, rhs.blbVal);
-    std::swap(objVal, rhs.objVal);
-    std::swap(dateVal, rhs.dateVal);
+    std::swap(m_nBlobSize, rhs.m_nBlobSize);
+    std::swap(m_bInline, rhs.m_bInline);
+    std::swap(m_bShared, rhs.m_bShared);
+}
+
+Any &Any::Share()
+{
+    if (m_bInline || m_bShared) { return *this; }
+    if (Type == eString && strVal)
+    {
+        char *p = allocShared(strVal, static_cast<int>(std::strlen(strVal)));
+        delete[] strVal;
+        strVal = p;
+        m_bShared = true;
+    }
+    else if (Type == eBinary && blbVal)
+    {
+        char *p = allocShared(blbVal, m_nBlobSize);
+        delete[] blbVal;
+        blbVal = reinterpret_cast<unsigned char *>(p);
+        m_bShared = true;
+    }
+    return *this;
 }
 
+bool Any::IsShared() const { return m_bShared; }
+
 const Any &Any::Empty()
 {
     static const Any emptyAny(eEmpty);
     return emptyAny;
 }
 
+void Any::assignString(const char *str, size_t nLen)
+{
+    m_bInline = nLen < static_cast<size_t>(InlineCapacity);
+    char *p = m_bInline ? inlVal : (strVal = new char[nLen + 1]);
+    std::memcpy(p, str, nLen);
+    p[nLen] = '\0';
+}
+
+void Any::assignBlob(const unsigned char *pData, int nLen)
+{
+    m_nBlobSize = nLen;
+    m_bInline = nLen <= InlineCapacity;
+    if (!m_bInline) blbVal = new unsigned char[nLen];
+    if (pData) std::memcpy(blobData(), pData, nLen);
+}
+
+char *Any::stringData() const
+{
+    return m_bInline ? const_cast<char *>(inlVal) : strVal;
+}
+
+unsigned char *Any::blobData() const
+{
+    return m_bInline ? reinterpret_cast<unsigned char *>(
+                               const_cast<char *>(inlVal))
+                     : blbVal;
+}
+
+void Any::releaseData()
+{
+    if (m_bInline) return;
+    if (m_bShared)
+    {
+        releaseShared(strVal);
+        m_bShared = false;
+        return;
+    }
+    if (Type == eString) delete[] strVal;
+    else
+        delete[] blbVal;
+}
+
+void Any::detachData()
+{
+    if (!m_bShared) return;
+    // a shared buffer never holds a value short enough to be inline; the copy
+    // is made before the reference is dropped so a failed allocation keeps it
+    char *pShared = strVal;
+    if (Type == eString)
+    {
+        size_t nLen = static_cast<size_t>(sharedHeader(pShared)->Size);
+        char *p = new char[nLen + 1];
+        std::memcpy(p, pShared, nLen + 1);
+        strVal = p;
+    }
+    else
+    {
+        unsigned char *p = new unsigned char[m_nBlobSize];
+        std::memcpy(p, pShared, m_nBlobSize);
+        blbVal = p;
+    }
+    m_bShared = false;
+    releaseShared(pShared);
+}
+
+void Any::moveFrom(Any &rhs) noexcept
+{
+    // inlVal spans the whole union, so this carries any value, inline or not
+    std::memcpy(inlVal, rhs.inlVal, InlineCapacity);
+    Type = rhs.Type;
+    m_nBlobSize = rhs.m_nBlobSize;
+    m_bInline = rhs.m_bInline;
+    m_bShared = rhs.m_bShared;
+    rhs.Type = eEmpty;
+    rhs.m_nBlobSize = 0;
+    rhs.m_bInline = false;
+    rhs.m_bShared = false;
+}
+
 }// namespace CPL
@@ -23,13 +23,15 @@
 #include "cpl_datetime.h"
 #include "cpl_stringhelp.h"
 #include <cpl_exports.h>
+#include <functional>
 
 namespace CPL {
 
 class RefObject;
 
 /// \brief Data type for the Any object.
-enum VarType
+/// \details Stored in a single byte so that Any can keep its flags next to it.
+enum VarType : signed char
 {
     /// \brief Unknown data type.
     eUnknownVarType = -2,
@@ -77,7 +79,26 @@ public:
     /// \brief Data type of the stored value.
     VarType Type;
 
+private:
+    // Declared next to Type so that they fill the padding before the union.
+
+    /// \brief Whether a string or blob is stored in inlVal.
+    bool m_bInline = false;
+    /// \brief Whether strVal or blbVal points into a shared buffer.
+    bool m_bShared = false;
+    /// \brief Size in bytes of the binary data.
+    int m_nBlobSize = 0;
+
+public:
+    /// \brief Number of bytes of a string or blob that are stored inside the object.
+    /// \details Strings shorter than this, counting the terminator, and blobs up to
+    /// this size are kept in inlVal, so creating, copying and moving them does not
+    /// allocate. The union is no larger than for DateTime alone.
+    static constexpr int InlineCapacity = static_cast<int>(sizeof(DateTime));
+
     /// \brief A union to store the value.
+    /// \details strVal and blbVal are only used for values too long for inlVal, use
+    /// AsString and ValuePtr to reach the data of any string or blob.
     union
     {
         char cVal;
@@ -95,6 +116,7 @@ public:
         char *strVal;
         unsigned char *blbVal;
         DateTime dateVal;
+        char inlVal[InlineCapacity];
     };
 
     /// \brief Destructor.
@@ -410,6 +432,9 @@ public:
     const void *ValuePtr() const;
 
     /// \brief Calculates and returns the hash code for the object.
+    /// \details Values that compare equal have equal hash codes. Numbers are mixed
+    /// with Hash::Combine and strings and binary data with Hash::Bytes, both keyed
+    /// by the type.
     /// \return The hash code.
     unsigned long long HashCode() const;
 
@@ -421,9 +446,60 @@ public:
     /// \param rhs The object to swap with.
     void Swap(Any &rhs);
 
+    /// \brief Moves a string or blob payload into a shared immutable buffer.
+    /// \details The buffer holds an atomic reference count and the payload size in
+    /// front of the data, and every copy of the object then refers to it, so copying
+    /// costs O(1) whatever the payload size. The payload must not be modified through
+    /// AsString; Set and AllocBlob give the object a private copy first. Values that
+    /// fit InlineCapacity and other types are left as they are, since copying them
+    /// is already cheap.
+    /// \return A reference to this object.
+    Any &Share();
+
+    /// \brief Checks whether the payload is a shared buffer, see Share.
+    /// \return True if copies of this object share its payload.
+    bool IsShared() const;
+
     /// \brief Returns an empty object.
     /// \return A reference to an empty object.
     static const Any &Empty();
+
+private:
+    /// \brief Stores a copy of a string, inline when it is short enough.
+    void assignString(const char *str, size_t nLen);
+
+    /// \brief Stores a copy of binary data, inline when it is short enough.
+    void assignBlob(const unsigned char *pData, int nLen);
+
+    /// \brief Returns the characters of the stored string.
+    char *stringData() const;
+
+    /// \brief Returns the bytes of the stored blob.
+    unsigned char *blobData() const;
+
+    /// \brief Frees the heap copy of a string or blob, or drops the reference to
+    /// a shared payload.
+    void releaseData();
+
+    /// \brief Replaces a shared payload by a private heap copy.
+    void detachData();
+
+    /// \brief Takes over the value of another object and leaves it empty.
+    void moveFrom(Any &rhs) noexcept;
 };
 
+static_assert(sizeof(void *) != 8 || sizeof(Any) <= 40,
+              "Any must stay within 40 bytes on 64-bit targets");
+
 }// namespace CPL
+
+namespace std {
+template<>
+struct hash<CPL::Any>
+{
+    size_t operator()(const CPL::Any &value) const
+    {
+        return static_cast<size_t>(value.HashCode());
+    }
+};
+}// namespace std
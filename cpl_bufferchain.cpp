@@ -0,0 +1,505 @@
+/**
+ * CPL - Common Portability Library
+ *
+ * Copyright (C) 2024 Merlot.Rain
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "cpl_bufferchain.h"
+#include <algorithm>
+#include <climits>
+#include <cstring>
+#include <new>
+#include <stdexcept>
+
+namespace CPL {
+
+/// Reference-counted storage shared by the segments of one or more chains.
+/// The data bytes follow the header in the same allocation.
+struct BufferChain::Block
+{
+    Atomic<int> RefCount;
+    unsigned int Capacity;
+
+    unsigned char *Data() { return reinterpret_cast<unsigned char *>(this + 1); }
+
+    static Block *Create(unsigned int nCapacity)
+    {
+        void *p = ::operator new(sizeof(Block) + nCapacity);
+        Block *block = new (p) Block;
+        block->RefCount = 1;
+        block->Capacity = nCapacity;
+        return block;
+    }
+
+    void AddRef() { RefCount.Increment(); }
+
+    void Release()
+    {
+        if (RefCount.Decrement() == 0)
+        {
+            this->~Block();
+            ::operator delete(this);
+        }
+    }
+
+    bool IsShared() const { return RefCount.Read() > 1; }
+};
+
+/// A view of [Offset, Offset + Length) inside a block.
+struct BufferChain::Segment
+{
+    Block *pBlock;
+    unsigned int Offset;
+    unsigned int Length;
+    Segment *pPrev;
+    Segment *pNext;
+
+    unsigned char *Data() const { return pBlock->Data() + Offset; }
+    unsigned int Headroom() const
+    {
+        return pBlock->IsShared() ? 0 : Offset;
+    }
+    unsigned int Tailroom() const
+    {
+        return pBlock->IsShared() ? 0 : pBlock->Capacity - Offset - Length;
+    }
+};
+
+BufferChain::BufferChain() {}
+
+BufferChain::BufferChain(unsigned int nCapacity, unsigned int nHeadroom)
+{
+    LinkBack(NewSegment(nCapacity + nHeadroom, nHeadroom));
+}
+
+BufferChain::BufferChain(BufferChain &&rhs) noexcept
+    : m_pHead(rhs.m_pHead), m_nLength(rhs.m_nLength),
+      m_nSegments(rhs.m_nSegments)
+{
+    rhs.m_pHead = nullptr;
+    rhs.m_nLength = 0;
+    rhs.m_nSegments = 0;
+}
+
+BufferChain &BufferChain::operator=(BufferChain &&rhs) noexcept
+{
+    if (this != &rhs)
+    {
+        Clear();
+        std::swap(m_pHead, rhs.m_pHead);
+        std::swap(m_nLength, rhs.m_nLength);
+        std::swap(m_nSegments, rhs.m_nSegments);
+    }
+    return *this;
+}
+
+BufferChain::~BufferChain() { Clear(); }
+
+unsigned long long BufferChain::Length() const { return m_nLength; }
+
+bool BufferChain::IsEmpty() const { return m_nLength == 0; }
+
+int BufferChain::SegmentCount() const { return m_nSegments; }
+
+bool BufferChain::IsChained() const
+{
+    if (m_nSegments < 2) return false;
+    int nNonEmpty = 0;
+    Segment *seg = m_pHead;
+    do {
+        if (seg->Length && ++nNonEmpty > 1) return true;
+        seg = seg->pNext;
+    } while (seg != m_pHead);
+    return false;
+}
+
+BufferChain::Segment *BufferChain::NewSegment(unsigned int nCapacity,
+                                              unsigned int nOffset)
+{
+    Segment *seg = new Segment;
+    seg->pBlock = Block::Create(nCapacity);
+    seg->Offset = nOffset;
+    seg->Length = 0;
+    seg->pPrev = seg->pNext = seg;
+    return seg;
+}
+
+void BufferChain::FreeSegment(Segment *seg)
+{
+    seg->pBlock->Release();
+    delete seg;
+}
+
+void BufferChain::LinkBack(Segment *seg)
+{
+    if (!m_pHead)
+    {
+        seg->pPrev = seg->pNext = seg;
+        m_pHead = seg;
+    }
+    else
+    {
+        Segment *tail = m_pHead->pPrev;
+        seg->pPrev = tail;
+        seg->pNext = m_pHead;
+        tail->pNext = seg;
+        m_pHead->pPrev = seg;
+    }
+    ++m_nSegments;
+    m_nLength += seg->Length;
+}
+
+void BufferChain::LinkFront(Segment *seg)
+{
+    LinkBack(seg);
+    m_pHead = seg;
+}
+
+void BufferChain::Unlink(Segment *seg)
+{
+    if (seg->pNext == seg) { m_pHead = nullptr; }
+    else
+    {
+        seg->pPrev->pNext = seg->pNext;
+        seg->pNext->pPrev = seg->pPrev;
+        if (m_pHead == seg) m_pHead = seg->pNext;
+    }
+    seg->pPrev = seg->pNext = seg;
+    --m_nSegments;
+    m_nLength -= seg->Length;
+}
+
+unsigned char *BufferChain::PrependSpace(unsigned int nLen)
+{
+    if (m_pHead && m_pHead->Headroom() >= nLen)
+    {
+        m_pHead->Offset -= nLen;
+        m_pHead->Length += nLen;
+        m_nLength += nLen;
+        return m_pHead->Data();
+    }
+
+    // Keep the data at the end of the new block so that later prepends
+    // find headroom again.
+    unsigned int nCapacity = std::max(nLen, DefaultHeadroomSize);
+    Segment *seg = NewSegment(nCapacity, nCapacity - nLen);
+    seg->Length = nLen;
+    LinkFront(seg);
+    return seg->Data();
+}
+
+void BufferChain::Prepend(const unsigned char *pData, unsigned int nLen)
+{
+    if (nLen == 0) return;
+    std::memcpy(PrependSpace(nLen), pData, nLen);
+}
+
+void BufferChain::Prepend(BufferChain &&chain)
+{
+    if (&chain == this || !chain.m_pHead) return;
+    chain.Append(std::move(*this));
+    *this = std::move(chain);
+}
+
+unsigned char *BufferChain::AppendSpace(unsigned int nLen)
+{
+    if (m_pHead && m_pHead->pPrev->Tailroom() >= nLen)
+    {
+        Segment *tail = m_pHead->pPrev;
+        unsigned char *p = tail->Data() + tail->Length;
+        tail->Length += nLen;
+        m_nLength += nLen;
+        return p;
+    }
+
+    Segment *seg = NewSegment(std::max(nLen, DefaultSegmentSize), 0);
+    seg->Length = nLen;
+    LinkBack(seg);
+    return seg->Data();
+}
+
+void BufferChain::Append(const unsigned char *pData, unsigned int nLen)
+{
+    if (nLen == 0) return;
+    // Fill the current tailroom first so that a large append does not
+    // leave a partially used segment behind.
+    if (m_pHead)
+    {
+        Segment *tail = m_pHead->pPrev;
+        unsigned int nRoom = std::min(tail->Tailroom(), nLen);
+        if (nRoom)
+        {
+            std::memcpy(tail->Data() + tail->Length, pData, nRoom);
+            tail->Length += nRoom;
+            m_nLength += nRoom;
+            pData += nRoom;
+            nLen -= nRoom;
+        }
+    }
+    if (nLen) std::memcpy(AppendSpace(nLen), pData, nLen);
+}
+
+void BufferChain::Append(const std::string &str)
+{
+    // segment capacities and lengths are 32-bit
+    const unsigned char *p = reinterpret_cast<const unsigned char *>(str.data());
+    size_t nLeft = str.size();
+    while (nLeft)
+    {
+        unsigned int nLen = static_cast<unsigned int>(
+                std::min<size_t>(nLeft, UINT_MAX));
+        Append(p, nLen);
+        p += nLen;
+        nLeft -= nLen;
+    }
+}
+
+void BufferChain::Append(BufferChain &&chain)
+{
+    if (&chain == this || !chain.m_pHead) return;
+    if (!m_pHead)
+    {
+        *this = std::move(chain);
+        return;
+    }
+
+    // Splice the two circular lists: tail -> other head ... other tail -> head
+    Segment *tail = m_pHead->pPrev;
+    Segment *otherHead = chain.m_pHead;
+    Segment *otherTail = otherHead->pPrev;
+    tail->pNext = otherHead;
+    otherHead->pPrev = tail;
+    otherTail->pNext = m_pHead;
+    m_pHead->pPrev = otherTail;
+
+    m_nLength += chain.m_nLength;
+    m_nSegments += chain.m_nSegments;
+    chain.m_pHead = nullptr;
+    chain.m_nLength = 0;
+    chain.m_nSegments = 0;
+}
+
+BufferChain BufferChain::Split(unsigned long long nLen)
+{
+    BufferChain result;
+    nLen = std::min(nLen, m_nLength);
+    while (nLen > 0)
+    {
+        Segment *seg = m_pHead;
+        if (seg->Length <= nLen)
+        {
+            nLen -= seg->Length;
+            Unlink(seg);
+            result.LinkBack(seg);
+            continue;
+        }
+
+        // The split point falls inside this segment: share its block.
+        unsigned int nPart = static_cast<unsigned int>(nLen);
+        Segment *front = new Segment;
+        front->pBlock = seg->pBlock;
+        front->pBlock->AddRef();
+        front->Offset = seg->Offset;
+        front->Length = nPart;
+        front->pPrev = front->pNext = front;
+        result.LinkBack(front);
+
+        seg->Offset += nPart;
+        seg->Length -= nPart;
+        m_nLength -= nPart;
+        nLen = 0;
+    }
+    return result;
+}
+
+void BufferChain::TrimStart(unsigned long long nLen)
+{
+    nLen = std::min(nLen, m_nLength);
+    while (nLen > 0)
+    {
+        Segment *seg = m_pHead;
+        if (seg->Length <= nLen)
+        {
+            nLen -= seg->Length;
+            Unlink(seg);
+            FreeSegment(seg);
+            continue;
+        }
+        seg->Offset += static_cast<unsigned int>(nLen);
+        seg->Length -= static_cast<unsigned int>(nLen);
+        m_nLength -= nLen;
+        nLen = 0;
+    }
+}
+
+void BufferChain::TrimEnd(unsigned long long nLen)
+{
+    nLen = std::min(nLen, m_nLength);
+    while (nLen > 0)
+    {
+        Segment *seg = m_pHead->pPrev;
+        if (seg->Length <= nLen)
+        {
+            nLen -= seg->Length;
+            Unlink(seg);
+            FreeSegment(seg);
+            continue;
+        }
+        seg->Length -= static_cast<unsigned int>(nLen);
+        m_nLength -= nLen;
+        nLen = 0;
+    }
+}
+
+BufferChain BufferChain::Clone() const
+{
+    BufferChain result;
+    if (!m_pHead) return result;
+    Segment *seg = m_pHead;
+    do {
+        Segment *copy = new Segment(*seg);
+        copy->pBlock->AddRef();
+        copy->pPrev = copy->pNext = copy;
+        result.LinkBack(copy);
+        seg = seg->pNext;
+    } while (seg != m_pHead);
+    return result;
+}
+
+const unsigned char *BufferChain::Coalesce()
+{
+    if (m_nLength == 0) return nullptr;
+    if (!IsChained())
+    {
+        // Drop empty segments so the data segment becomes the head.
+        while (m_pHead->Length == 0)
+        {
+            Segment *seg = m_pHead;
+            Unlink(seg);
+            FreeSegment(seg);
+        }
+        return m_pHead->Data();
+    }
+
+    unsigned int nHeadroom = m_pHead->Headroom();
+    // segment capacities and lengths are 32-bit
+    if (m_nLength + nHeadroom > UINT_MAX)
+        throw std::length_error("BufferChain: too large to coalesce");
+    Segment *merged = NewSegment(
+            static_cast<unsigned int>(m_nLength) + nHeadroom, nHeadroom);
+    CopyTo(merged->Data(), 0, m_nLength);
+    merged->Length = static_cast<unsigned int>(m_nLength);
+
+    Clear();
+    LinkBack(merged);
+    return merged->Data();
+}
+
+unsigned long long BufferChain::CopyTo(unsigned char *pOut,
+                                       unsigned long long nOffset,
+                                       unsigned long long nLen) const
+{
+    if (!m_pHead || nOffset >= m_nLength) return 0;
+    nLen = std::min(nLen, m_nLength - nOffset);
+
+    unsigned long long nCopied = 0;
+    Segment *seg = m_pHead;
+    do {
+        if (nOffset >= seg->Length) { nOffset -= seg->Length; }
+        else
+        {
+            unsigned long long n =
+                    std::min<unsigned long long>(seg->Length - nOffset,
+                                                 nLen - nCopied);
+            std::memcpy(pOut + nCopied, seg->Data() + nOffset, n);
+            nCopied += n;
+            nOffset = 0;
+        }
+        seg = seg->pNext;
+    } while (seg != m_pHead && nCopied < nLen);
+    return nCopied;
+}
+
+std::string BufferChain::ToString() const
+{
+    std::string str;
+    str.resize(m_nLength);
+    CopyTo(reinterpret_cast<unsigned char *>(&str[0]), 0, m_nLength);
+    return str;
+}
+
+int BufferChain::FillIoVec(IoVec *vec, int nMax) const
+{
+    if (!m_pHead) return 0;
+    int nCount = 0;
+    Segment *seg = m_pHead;
+    do {
+        if (seg->Length)
+        {
+            if (nCount == nMax) break;
+            vec[nCount].Data = seg->Data();
+            vec[nCount].Length = seg->Length;
+            ++nCount;
+        }
+        seg = seg->pNext;
+    } while (seg != m_pHead);
+    return nCount;
+}
+
+long long BufferChain::WriteTo(OutputStream *stream) const
+{
+    if (!stream || !m_pHead) return 0;
+
+    const int nBatch = 64;
+    IoVec vec[nBatch];
+    long long nTotal = 0;
+    Segment *seg = m_pHead;
+    do {
+        int nCount = 0;
+        long long nExpected = 0;
+        do {
+            if (seg->Length)
+            {
+                vec[nCount].Data = seg->Data();
+                vec[nCount].Length = seg->Length;
+                nExpected += seg->Length;
+                ++nCount;
+            }
+            seg = seg->pNext;
+        } while (seg != m_pHead && nCount < nBatch);
+
+        if (nCount == 0) break;
+        long long n = stream->RawWriteV(vec, nCount);
+        nTotal += n;
+        if (n < nExpected) break;
+    } while (seg != m_pHead);
+    return nTotal;
+}
+
+void BufferChain::Clear()
+{
+    while (m_pHead)
+    {
+        Segment *seg = m_pHead;
+        Unlink(seg);
+        FreeSegment(seg);
+    }
+    m_nLength = 0;
+    m_nSegments = 0;
+}
+
+}// namespace CPL
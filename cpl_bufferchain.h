@@ -0,0 +1,178 @@
+/**
+ * CPL - Common Portability Library
+ *
+ * Copyright (C) 2024 Merlot.Rain
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include "cpl_memorymanager.h"
+#include <cpl_exports.h>
+#include <string>
+
+namespace CPL {
+
+/// \brief A chain of buffer segments for scatter/gather message assembly
+/// \details Each segment references a region of a reference-counted storage block and keeps
+/// unused headroom before and tailroom after its data, so headers can be prepended and
+/// payload appended without moving bytes that are already in place. Splitting and
+/// cloning share storage blocks instead of copying them; the bytes are only gathered into
+/// one contiguous block when Coalesce is called.
+/// Headroom and tailroom are only reused while a storage block is not shared with another chain.
+class CPL_API BufferChain
+{
+    struct Block;
+    struct Segment;
+
+    Segment *m_pHead = nullptr;      ///< First segment of the circular segment list
+    unsigned long long m_nLength = 0;///< Total number of data bytes in the chain
+    int m_nSegments = 0;             ///< Number of segments in the chain
+
+public:
+    /// \brief Capacity of the segments created when appending runs out of tailroom
+    static constexpr unsigned int DefaultSegmentSize = 4096;
+
+    /// \brief Capacity of the segments created when prepending runs out of headroom
+    static constexpr unsigned int DefaultHeadroomSize = 256;
+
+    /// \brief Creates an empty chain without any segment
+    BufferChain();
+
+    /// \brief Creates a chain with one empty segment
+    /// \param nCapacity Tailroom of the segment, i.e. bytes that can be appended without allocating
+    /// \param nHeadroom Headroom of the segment, i.e. bytes that can be prepended without allocating
+    explicit BufferChain(unsigned int nCapacity, unsigned int nHeadroom = 0);
+
+    /// \brief Move constructor
+    BufferChain(BufferChain &&rhs) noexcept;
+
+    /// \brief Move assignment operator
+    BufferChain &operator=(BufferChain &&rhs) noexcept;
+
+    /// \brief Destructor, releases all segments
+    ~BufferChain();
+
+    CPL_DISABLE_COPY(BufferChain)
+
+    /// \brief Total number of data bytes in the chain
+    unsigned long long Length() const;
+
+    /// \brief Checks whether the chain holds no data
+    bool IsEmpty() const;
+
+    /// \brief Number of segments in the chain, including empty ones
+    int SegmentCount() const;
+
+    /// \brief Checks whether the data spans more than one segment
+    bool IsChained() const;
+
+    /// \brief Reserves bytes in front of the data
+    /// \details Uses the headroom of the first segment when possible, otherwise links a new segment.
+    /// The reserved bytes are uninitialized and must be filled by the caller.
+    /// \param nLen Number of bytes to reserve
+    /// \return Pointer to the reserved bytes
+    unsigned char *PrependSpace(unsigned int nLen);
+
+    /// \brief Copies data in front of the existing data
+    /// \param pData Pointer to the data
+    /// \param nLen Length of the data in bytes
+    void Prepend(const unsigned char *pData, unsigned int nLen);
+
+    /// \brief Moves all segments of another chain in front of this chain, in O(1)
+    /// \param chain The chain to take the segments from, left empty
+    void Prepend(BufferChain &&chain);
+
+    /// \brief Reserves bytes behind the data
+    /// \details Uses the tailroom of the last segment when possible, otherwise links a new segment.
+    /// The reserved bytes are uninitialized and must be filled by the caller.
+    /// \param nLen Number of bytes to reserve
+    /// \return Pointer to the reserved bytes
+    unsigned char *AppendSpace(unsigned int nLen);
+
+    /// \brief Copies data behind the existing data
+    /// \param pData Pointer to the data
+    /// \param nLen Length of the data in bytes
+    void Append(const unsigned char *pData, unsigned int nLen);
+
+    /// \brief Copies a string behind the existing data
+    /// \param str The string to append
+    void Append(const std::string &str);
+
+    /// \brief Moves all segments of another chain behind this chain, in O(1)
+    /// \param chain The chain to take the segments from, left empty
+    void Append(BufferChain &&chain);
+
+    /// \brief Removes the first bytes of the chain and returns them as a new chain
+    /// \details Whole segments are relinked; a segment crossing the split point is shared by
+    /// both chains, so no data is copied.
+    /// \param nLen Number of bytes to split off, clamped to Length()
+    /// \return The chain holding the first nLen bytes
+    BufferChain Split(unsigned long long nLen);
+
+    /// \brief Discards bytes from the front of the chain
+    /// \param nLen Number of bytes to discard, clamped to Length()
+    void TrimStart(unsigned long long nLen);
+
+    /// \brief Discards bytes from the end of the chain
+    /// \param nLen Number of bytes to discard, clamped to Length()
+    void TrimEnd(unsigned long long nLen);
+
+    /// \brief Creates a chain referencing the same data without copying it
+    /// \return The new chain
+    BufferChain Clone() const;
+
+    /// \brief Gathers the data into a single contiguous segment
+    /// \details Does nothing if the data already lives in one segment. Throws
+    /// std::length_error if the data and the head's headroom exceed UINT_MAX bytes,
+    /// the largest segment.
+    /// \return Pointer to the contiguous data, or nullptr if the chain is empty
+    const unsigned char *Coalesce();
+
+    /// \brief Copies a range of the data into a caller buffer
+    /// \param pOut The output buffer, at least nLen bytes
+    /// \param nOffset Offset of the first byte to copy
+    /// \param nLen Number of bytes to copy
+    /// \return The number of bytes copied
+    unsigned long long CopyTo(unsigned char *pOut, unsigned long long nOffset,
+                              unsigned long long nLen) const;
+
+    /// \brief Copies the data into a string
+    std::string ToString() const;
+
+    /// \brief Describes the non-empty segments as IoVec blocks
+    /// \param vec The output array
+    /// \param nMax Capacity of the output array
+    /// \return The number of blocks written
+    int FillIoVec(IoVec *vec, int nMax) const;
+
+    /// \brief Writes the data to an output stream with vectored writes
+    /// \param stream The output stream
+    /// \return The number of bytes written
+    long long WriteTo(OutputStream *stream) const;
+
+    /// \brief Releases all segments
+    void Clear();
+
+private:
+    Segment *NewSegment(unsigned int nCapacity, unsigned int nOffset);
+    void LinkFront(Segment *seg);
+    void LinkBack(Segment *seg);
+    void Unlink(Segment *seg);
+    static void FreeSegment(Segment *seg);
+};
+
+}// namespace CPL
@@ -0,0 +1,229 @@
+/**
+ * CPL - Common Portability Library
+ *
+ * Copyright (C) 2024 Merlot.Rain
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include "cpl_simd.h"
+#include <cstdint>
+#include <string_view>
+
+namespace CPL {
+
+/// \brief A set of byte values for scanning strings
+/// \details The set keeps a 256-bit membership table for scalar lookups and two
+/// nibble tables for vector lookups: for a byte with low nibble l and high nibble h,
+/// bit (h & 7) of the entry l in the table selected by (h & 8) tells whether the byte
+/// belongs to the set. With SSSE3, AVX2 or ARMv8 NEON a block of 16 or 32 bytes is
+/// then classified with two table shuffles, whatever the size of the set. The
+/// constructors are constexpr, so sets used by parsers can be built at compile time:
+/// \code
+/// static constexpr CharSet kDelimiters(",;\t\r\n");
+/// size_t nPos = kDelimiters.FindFirstOf(line);
+/// \endcode
+class CharSet
+{
+public:
+    /// \brief Constructs an empty set
+    constexpr CharSet() = default;
+
+    /// \brief Constructs a set of the bytes of a string
+    /// \param chars The members of the set
+    constexpr explicit CharSet(std::string_view chars)
+    {
+        for (char c: chars) Add(c);
+    }
+
+    /// \brief Constructs a set of the bytes of a null-terminated string
+    /// \param chars The members of the set
+    constexpr explicit CharSet(const char *chars)
+        : CharSet(chars ? std::string_view(chars) : std::string_view())
+    {
+    }
+
+    /// \brief Constructs the set of the bytes from first to last, both included
+    static constexpr CharSet Range(unsigned char first, unsigned char last)
+    {
+        CharSet set;
+        for (unsigned int c = first; c <= last; ++c)
+            set.Add(static_cast<char>(c));
+        return set;
+    }
+
+    /// \brief Adds a byte to the set
+    constexpr CharSet &Add(char c)
+    {
+        unsigned char b = static_cast<unsigned char>(c);
+        m_Bits[b >> 6] |= 1ULL << (b & 63);
+        m_Nibbles[(b >> 7) * 16 + (b & 15)] |=
+                static_cast<unsigned char>(1u << ((b >> 4) & 7));
+        return *this;
+    }
+
+    /// \brief Returns the union of two sets
+    constexpr CharSet operator|(const CharSet &other) const
+    {
+        CharSet set = *this;
+        for (int i = 0; i < 4; ++i) set.m_Bits[i] |= other.m_Bits[i];
+        for (int i = 0; i < 32; ++i) set.m_Nibbles[i] |= other.m_Nibbles[i];
+        return set;
+    }
+
+    /// \brief Returns the set of the bytes that are not in this set
+    constexpr CharSet operator~() const
+    {
+        CharSet set;
+        for (int i = 0; i < 4; ++i) set.m_Bits[i] = ~m_Bits[i];
+        for (int i = 0; i < 32; ++i)
+            set.m_Nibbles[i] = static_cast<unsigned char>(~m_Nibbles[i]);
+        return set;
+    }
+
+    /// \brief Checks whether a byte belongs to the set
+    constexpr bool Contains(char c) const
+    {
+        unsigned char b = static_cast<unsigned char>(c);
+        return (m_Bits[b >> 6] >> (b & 63)) & 1;
+    }
+
+    /// \brief Checks whether any byte of a string belongs to the set
+    bool ContainsAny(std::string_view str) const
+    {
+        return FindFirstOf(str) != std::string_view::npos;
+    }
+
+    /// \brief Finds the first byte that belongs to the set
+    /// \param str The string to scan
+    /// \param nPos The position to start at
+    /// \return The position of the byte, or npos if there is none
+    size_t FindFirstOf(std::string_view str, size_t nPos = 0) const
+    {
+        return find(str, nPos, false);
+    }
+
+    /// \brief Finds the first byte that does not belong to the set
+    /// \param str The string to scan
+    /// \param nPos The position to start at
+    /// \return The position of the byte, or npos if there is none
+    size_t FindFirstNotOf(std::string_view str, size_t nPos = 0) const
+    {
+        return find(str, nPos, true);
+    }
+
+private:
+    size_t find(std::string_view str, size_t nPos, bool bNegate) const
+    {
+        if (nPos >= str.size()) return std::string_view::npos;
+        const char *const pBegin = str.data();
+        const char *p = pBegin + nPos;
+        const char *const pEnd = pBegin + str.size();
+#if defined(CPL_SIMD_AVX2)
+        const __m256i lowTable32 = _mm256_broadcastsi128_si256(
+                _mm_loadu_si128(reinterpret_cast<const __m128i *>(m_Nibbles)));
+        const __m256i highTable32 = _mm256_broadcastsi128_si256(
+                _mm_loadu_si128(reinterpret_cast<const __m128i *>(m_Nibbles + 16)));
+        const __m256i bitTable32 = _mm256_setr_epi8(
+                1, 2, 4, 8, 16, 32, 64, -128, 1, 2, 4, 8, 16, 32, 64, -128, 1, 2,
+                4, 8, 16, 32, 64, -128, 1, 2, 4, 8, 16, 32, 64, -128);
+        const __m256i nibbleMask32 = _mm256_set1_epi8(0x0F);
+        const __m256i highBit32 = _mm256_set1_epi8(-128);
+        for (; pEnd - p >= 32; p += 32)
+        {
+            __m256i block =
+                    _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p));
+            // pshufb yields zero for indices with bit 7 set, which routes each
+            // byte to exactly one of the two tables
+            __m256i rows = _mm256_or_si256(
+                    _mm256_shuffle_epi8(lowTable32, block),
+                    _mm256_shuffle_epi8(highTable32,
+                                        _mm256_xor_si256(block, highBit32)));
+            __m256i bits = _mm256_shuffle_epi8(
+                    bitTable32, _mm256_and_si256(_mm256_srli_epi16(block, 4),
+                                               nibbleMask32));
+            __m256i miss = _mm256_cmpeq_epi8(_mm256_and_si256(rows, bits),
+                                             _mm256_setzero_si256());
+            unsigned int mask =
+                    static_cast<unsigned int>(_mm256_movemask_epi8(miss));
+            if (!bNegate) mask = ~mask;
+            if (mask) return static_cast<size_t>(p - pBegin) +
+                             Simd::CountTrailingZeros(mask);
+        }
+#endif
+#if defined(CPL_SIMD_SSSE3)
+        const __m128i lowTable =
+                _mm_loadu_si128(reinterpret_cast<const __m128i *>(m_Nibbles));
+        const __m128i highTable =
+                _mm_loadu_si128(reinterpret_cast<const __m128i *>(m_Nibbles + 16));
+        const __m128i bitTable = _mm_setr_epi8(1, 2, 4, 8, 16, 32, 64, -128, 1,
+                                               2, 4, 8, 16, 32, 64, -128);
+        const __m128i nibbleMask = _mm_set1_epi8(0x0F);
+        const __m128i highBit = _mm_set1_epi8(-128);
+        for (; pEnd - p >= 16; p += 16)
+        {
+            __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+            __m128i rows = _mm_or_si128(
+                    _mm_shuffle_epi8(lowTable, block),
+                    _mm_shuffle_epi8(highTable, _mm_xor_si128(block, highBit)));
+            __m128i bits = _mm_shuffle_epi8(
+                    bitTable, _mm_and_si128(_mm_srli_epi16(block, 4), nibbleMask));
+            __m128i miss = _mm_cmpeq_epi8(_mm_and_si128(rows, bits),
+                                          _mm_setzero_si128());
+            unsigned int mask = static_cast<unsigned int>(_mm_movemask_epi8(miss));
+            if (!bNegate) mask = ~mask & 0xFFFF;
+            if (mask) return static_cast<size_t>(p - pBegin) +
+                             Simd::CountTrailingZeros(mask);
+        }
+#elif defined(CPL_SIMD_NEON) && defined(__aarch64__)
+        const uint8x16_t lowTable = vld1q_u8(m_Nibbles);
+        const uint8x16_t highTable = vld1q_u8(m_Nibbles + 16);
+        const uint8x16_t bitTable = {1, 2, 4, 8, 16, 32, 64, 128,
+                                     1, 2, 4, 8, 16, 32, 64, 128};
+        // tbl yields zero for any index above 15, so the low nibble and the
+        // routing bit are all that may be kept
+        const uint8x16_t indexMask = vdupq_n_u8(0x8F);
+        const uint8x16_t highBit = vdupq_n_u8(0x80);
+        for (; pEnd - p >= 16; p += 16)
+        {
+            uint8x16_t block = vld1q_u8(reinterpret_cast<const unsigned char *>(p));
+            uint8x16_t rows = vorrq_u8(
+                    vqtbl1q_u8(lowTable, vandq_u8(block, indexMask)),
+                    vqtbl1q_u8(highTable,
+                               vandq_u8(veorq_u8(block, highBit), indexMask)));
+            uint8x16_t bits = vqtbl1q_u8(bitTable, vshrq_n_u8(block, 4));
+            uint8x16_t hit = vtstq_u8(rows, bits);
+            if (bNegate) hit = vmvnq_u8(hit);
+            unsigned long long mask = vget_lane_u64(
+                    vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(hit), 4)),
+                    0);
+            if (mask) return static_cast<size_t>(p - pBegin) +
+                             (Simd::CountTrailingZeros64(mask) >> 2);
+        }
+#endif
+        for (; p < pEnd; ++p)
+        {
+            if (Contains(*p) != bNegate) return static_cast<size_t>(p - pBegin);
+        }
+        return std::string_view::npos;
+    }
+
+    unsigned long long m_Bits[4] = {};
+    unsigned char m_Nibbles[32] = {};
+};
+
+}// namespace CPL
@@ -0,0 +1,795 @@
+/**
+ * CPL - Common Portability Library
+ *
+ * Copyright (C) 2024 Merlot.Rain
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "cpl_codec.h"
+#include "cpl_simd.h"
+#include <algorithm>
+#include <cstring>
+
+namespace CPL {
+
+static const char s_HexLower[] = "0123456789abcdef";
+static const char s_HexUpper[] = "0123456789ABCDEF";
+static const char s_Base64Standard[] =
+        "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+static const char s_Base64UrlSafe[] =
+        "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_";
+
+/// Reverse lookup of an alphabet, 0xFF for characters outside it.
+struct DecodeTable
+{
+    unsigned char Values[256];
+
+    explicit DecodeTable(const char *alphabet)
+    {
+        std::memset(Values, 0xFF, sizeof(Values));
+        for (int i = 0; alphabet[i]; ++i)
+            Values[static_cast<unsigned char>(alphabet[i])] =
+                    static_cast<unsigned char>(i);
+    }
+};
+
+static const DecodeTable &hexTable()
+{
+    static const DecodeTable table = [] {
+        DecodeTable t(s_HexLower);
+        for (int i = 10; i < 16; ++i)
+            t.Values[static_cast<unsigned char>(s_HexUpper[i])] =
+                    static_cast<unsigned char>(i);
+        return t;
+    }();
+    return table;
+}
+
+static const DecodeTable &base64Table(Base64Alphabet alphabet)
+{
+    static const DecodeTable standard(s_Base64Standard);
+    static const DecodeTable urlSafe(s_Base64UrlSafe);
+    return alphabet == Base64Alphabet::eUrlSafe ? urlSafe : standard;
+}
+
+static const char *base64Chars(Base64Alphabet alphabet)
+{
+    return alphabet == Base64Alphabet::eUrlSafe ? s_Base64UrlSafe
+                                                : s_Base64Standard;
+}
+
+/* ------------------------------ vector kernels ----------------------------- */
+// Each kernel handles a prefix of the input in whole blocks and returns its length;
+// the scalar code finishes the rest and reports errors.
+
+#if defined(CPL_SIMD_SSSE3)
+
+static size_t hexEncodeSimd(const unsigned char *src, size_t nLen, char *dst,
+                            const char *digits)
+{
+    size_t i = 0;
+    const __m128i lut = _mm_loadu_si128(reinterpret_cast<const __m128i *>(digits));
+    const __m128i mask = _mm_set1_epi8(0x0F);
+#if defined(CPL_SIMD_AVX2)
+    const __m256i lut32 = _mm256_broadcastsi128_si256(lut);
+    const __m256i mask32 = _mm256_set1_epi8(0x0F);
+    for (; nLen - i >= 32; i += 32)
+    {
+        __m256i in = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + i));
+        __m256i hi = _mm256_shuffle_epi8(
+                lut32, _mm256_and_si256(_mm256_srli_epi16(in, 4), mask32));
+        __m256i lo = _mm256_shuffle_epi8(lut32, _mm256_and_si256(in, mask32));
+        // Unpacking interleaves within each 128-bit lane; regroup the lanes.
+        __m256i a = _mm256_unpacklo_epi8(hi, lo);
+        __m256i b = _mm256_unpackhi_epi8(hi, lo);
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + 2 * i),
+                            _mm256_permute2x128_si256(a, b, 0x20));
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + 2 * i + 32),
+                            _mm256_permute2x128_si256(a, b, 0x31));
+    }
+#endif
+    for (; nLen - i >= 16; i += 16)
+    {
+        __m128i in = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i));
+        __m128i hi = _mm_shuffle_epi8(
+                lut, _mm_and_si128(_mm_srli_epi16(in, 4), mask));
+        __m128i lo = _mm_shuffle_epi8(lut, _mm_and_si128(in, mask));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + 2 * i),
+                         _mm_unpacklo_epi8(hi, lo));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + 2 * i + 16),
+                         _mm_unpackhi_epi8(hi, lo));
+    }
+    return i;
+}
+
+/// Maps hex digits to their values and clears the bytes of valid that are not digits.
+static inline __m128i hexValues(__m128i c, __m128i &valid)
+{
+    const __m128i d = _mm_sub_epi8(c, _mm_set1_epi8('0'));
+    const __m128i a = _mm_sub_epi8(_mm_or_si128(c, _mm_set1_epi8(0x20)),
+                                   _mm_set1_epi8('a'));
+    const __m128i isDigit = _mm_cmpeq_epi8(_mm_min_epu8(d, _mm_set1_epi8(9)), d);
+    const __m128i isAlpha = _mm_cmpeq_epi8(_mm_min_epu8(a, _mm_set1_epi8(5)), a);
+    valid = _mm_and_si128(valid, _mm_or_si128(isDigit, isAlpha));
+    return _mm_or_si128(
+            _mm_and_si128(isDigit, d),
+            _mm_and_si128(isAlpha, _mm_add_epi8(a, _mm_set1_epi8(10))));
+}
+
+#if defined(CPL_SIMD_AVX2)
+static inline __m256i hexValues(__m256i c, __m256i &valid)
+{
+    const __m256i d = _mm256_sub_epi8(c, _mm256_set1_epi8('0'));
+    const __m256i a = _mm256_sub_epi8(_mm256_or_si256(c, _mm256_set1_epi8(0x20)),
+                                      _mm256_set1_epi8('a'));
+    const __m256i isDigit =
+            _mm256_cmpeq_epi8(_mm256_min_epu8(d, _mm256_set1_epi8(9)), d);
+    const __m256i isAlpha =
+            _mm256_cmpeq_epi8(_mm256_min_epu8(a, _mm256_set1_epi8(5)), a);
+    valid = _mm256_and_si256(valid, _mm256_or_si256(isDigit, isAlpha));
+    return _mm256_or_si256(
+            _mm256_and_si256(isDigit, d),
+            _mm256_and_si256(isAlpha, _mm256_add_epi8(a, _mm256_set1_epi8(10))));
+}
+#endif
+
+static size_t hexDecodeSimd(const char *src, size_t nLen, unsigned char *dst)
+{
+    size_t i = 0;
+#if defined(CPL_SIMD_AVX2)
+    // Each 16-bit lane holds a digit pair; multiply-add forms high * 16 + low.
+    const __m256i weights32 = _mm256_set1_epi16(0x0110);
+    for (; nLen - i >= 64; i += 64)
+    {
+        __m256i valid = _mm256_set1_epi8(-1);
+        __m256i v0 = hexValues(
+                _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + i)),
+                valid);
+        __m256i v1 = hexValues(_mm256_loadu_si256(
+                                       reinterpret_cast<const __m256i *>(src + i + 32)),
+                               valid);
+        if (_mm256_movemask_epi8(valid) != -1) return i;
+        __m256i packed = _mm256_packus_epi16(_mm256_maddubs_epi16(v0, weights32),
+                                             _mm256_maddubs_epi16(v1, weights32));
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + i / 2),
+                            _mm256_permute4x64_epi64(packed, 0xD8));
+    }
+#endif
+    const __m128i weights = _mm_set1_epi16(0x0110);
+    for (; nLen - i >= 32; i += 32)
+    {
+        __m128i valid = _mm_set1_epi8(-1);
+        __m128i v0 = hexValues(
+                _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i)), valid);
+        __m128i v1 = hexValues(
+                _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i + 16)),
+                valid);
+        if (_mm_movemask_epi8(valid) != 0xFFFF) break;
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i / 2),
+                         _mm_packus_epi16(_mm_maddubs_epi16(v0, weights),
+                                          _mm_maddubs_epi16(v1, weights)));
+    }
+    return i;
+}
+
+static size_t base64EncodeSimd(const unsigned char *src, size_t nLen,
+                               char *dst, Base64Alphabet alphabet)
+{
+    // Offsets added to each 6-bit index, selected by its range.
+    const bool bUrl = alphabet == Base64Alphabet::eUrlSafe;
+    const __m128i offsets = _mm_setr_epi8(
+            'a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+            '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+            static_cast<char>((bUrl ? '-' : '+') - 62),
+            static_cast<char>((bUrl ? '_' : '/') - 63), 'A', 0, 0);
+    size_t i = 0;
+    size_t o = 0;
+    // A 16-byte load supplies 12 input bytes.
+    for (; nLen - i >= 16; i += 12, o += 16)
+    {
+        __m128i in = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i));
+        in = _mm_shuffle_epi8(in, _mm_set_epi8(10, 11, 9, 10, 7, 8, 6, 7, 4, 5,
+                                               3, 4, 1, 2, 0, 1));
+        __m128i t0 = _mm_mulhi_epu16(_mm_and_si128(in, _mm_set1_epi32(0x0FC0FC00)),
+                                     _mm_set1_epi32(0x04000040));
+        __m128i t1 = _mm_mullo_epi16(_mm_and_si128(in, _mm_set1_epi32(0x003F03F0)),
+                                     _mm_set1_epi32(0x01000010));
+        __m128i indices = _mm_or_si128(t0, t1);
+
+        __m128i range = _mm_subs_epu8(indices, _mm_set1_epi8(51));
+        __m128i isUpper = _mm_cmpgt_epi8(_mm_set1_epi8(26), indices);
+        range = _mm_or_si128(range, _mm_and_si128(isUpper, _mm_set1_epi8(13)));
+        __m128i chars =
+                _mm_add_epi8(_mm_shuffle_epi8(offsets, range), indices);
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + o), chars);
+    }
+    return i;
+}
+
+static size_t base64DecodeSimd(const char *src, size_t nLen,
+                               unsigned char *dst, Base64Alphabet alphabet)
+{
+    // Nibble tables classify the characters of the standard alphabet: a
+    // character is valid when its two entries share no bit.
+    const __m128i lutLo = _mm_setr_epi8(0x15, 0x11, 0x11, 0x11, 0x11, 0x11,
+                                        0x11, 0x11, 0x11, 0x11, 0x13, 0x1A,
+                                        0x1B, 0x1B, 0x1B, 0x1A);
+    const __m128i lutHi = _mm_setr_epi8(0x10, 0x10, 0x01, 0x02, 0x04, 0x08,
+                                        0x04, 0x08, 0x10, 0x10, 0x10, 0x10,
+                                        0x10, 0x10, 0x10, 0x10);
+    const __m128i lutRoll = _mm_setr_epi8(0, 16, 19, 4, -65, -65, -71, -71, 0,
+                                          0, 0, 0, 0, 0, 0, 0);
+    const __m128i mask2F = _mm_set1_epi8(0x2F);
+    const bool bUrl = alphabet == Base64Alphabet::eUrlSafe;
+
+    size_t i = 0;
+    size_t o = 0;
+    // 16 characters give 12 bytes but the store writes 16, so keep 8 characters
+    // in reserve to guarantee room in dst.
+    for (; nLen - i >= 24; i += 16, o += 12)
+    {
+        __m128i in = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i));
+        __m128i bad = _mm_setzero_si128();
+        if (bUrl)
+        {
+            // Map '-' and '_' to '+' and '/', and reject the latter two.
+            __m128i plus = _mm_set1_epi8('+');
+            __m128i slash = _mm_set1_epi8('/');
+            bad = _mm_or_si128(_mm_cmpeq_epi8(in, plus),
+                               _mm_cmpeq_epi8(in, slash));
+            __m128i dash = _mm_cmpeq_epi8(in, _mm_set1_epi8('-'));
+            __m128i under = _mm_cmpeq_epi8(in, _mm_set1_epi8('_'));
+            in = _mm_or_si128(_mm_andnot_si128(_mm_or_si128(dash, under), in),
+                              _mm_or_si128(_mm_and_si128(dash, plus),
+                                           _mm_and_si128(under, slash)));
+        }
+        __m128i hiNibbles = _mm_and_si128(_mm_srli_epi32(in, 4), mask2F);
+        __m128i loNibbles = _mm_and_si128(in, mask2F);
+        __m128i hi = _mm_shuffle_epi8(lutHi, hiNibbles);
+        __m128i lo = _mm_shuffle_epi8(lutLo, loNibbles);
+        bad = _mm_or_si128(bad, _mm_cmpgt_epi8(_mm_and_si128(lo, hi),
+                                               _mm_setzero_si128()));
+        if (_mm_movemask_epi8(bad)) break;
+
+        __m128i roll = _mm_shuffle_epi8(
+                lutRoll, _mm_add_epi8(_mm_cmpeq_epi8(in, mask2F), hiNibbles));
+        __m128i values = _mm_add_epi8(in, roll);
+
+        // Merge four 6-bit values into three bytes per 32-bit lane.
+        __m128i merged = _mm_madd_epi16(
+                _mm_maddubs_epi16(values, _mm_set1_epi32(0x01400140)),
+                _mm_set1_epi32(0x00011000));
+        merged = _mm_shuffle_epi8(merged, _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10,
+                                                        9, 8, 14, 13, 12, -1,
+                                                        -1, -1, -1));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + o), merged);
+    }
+    return i;
+}
+
+#elif defined(CPL_SIMD_NEON) && defined(__aarch64__)
+
+static size_t hexEncodeSimd(const unsigned char *src, size_t nLen, char *dst,
+                            const char *digits)
+{
+    const uint8x16_t lut = vld1q_u8(reinterpret_cast<const uint8_t *>(digits));
+    const uint8x16_t mask = vdupq_n_u8(0x0F);
+    size_t i = 0;
+    for (; nLen - i >= 16; i += 16)
+    {
+        uint8x16_t in = vld1q_u8(src + i);
+        uint8x16x2_t out;
+        out.val[0] = vqtbl1q_u8(lut, vshrq_n_u8(in, 4));
+        out.val[1] = vqtbl1q_u8(lut, vandq_u8(in, mask));
+        vst2q_u8(reinterpret_cast<uint8_t *>(dst + 2 * i), out);
+    }
+    return i;
+}
+
+static inline uint8x16_t hexValues(uint8x16_t c, uint8x16_t &valid)
+{
+    uint8x16_t d = vsubq_u8(c, vdupq_n_u8('0'));
+    uint8x16_t a = vsubq_u8(vorrq_u8(c, vdupq_n_u8(0x20)), vdupq_n_u8('a'));
+    uint8x16_t isDigit = vcltq_u8(d, vdupq_n_u8(10));
+    uint8x16_t isAlpha = vcltq_u8(a, vdupq_n_u8(6));
+    valid = vandq_u8(valid, vorrq_u8(isDigit, isAlpha));
+    return vbslq_u8(isDigit, d, vaddq_u8(a, vdupq_n_u8(10)));
+}
+
+static size_t hexDecodeSimd(const char *src, size_t nLen, unsigned char *dst)
+{
+    size_t i = 0;
+    for (; nLen - i >= 32; i += 32)
+    {
+        uint8x16x2_t in = vld2q_u8(reinterpret_cast<const uint8_t *>(src + i));
+        uint8x16_t valid = vdupq_n_u8(0xFF);
+        uint8x16_t hi = hexValues(in.val[0], valid);
+        uint8x16_t lo = hexValues(in.val[1], valid);
+        if (vminvq_u8(valid) != 0xFF) break;
+        vst1q_u8(dst + i / 2, vorrq_u8(vshlq_n_u8(hi, 4), lo));
+    }
+    return i;
+}
+
+static size_t base64EncodeSimd(const unsigned char *src, size_t nLen,
+                               char *dst, Base64Alphabet alphabet)
+{
+    const uint8_t *chars = reinterpret_cast<const uint8_t *>(base64Chars(alphabet));
+    uint8x16x4_t table;
+    for (int k = 0; k < 4; ++k) table.val[k] = vld1q_u8(chars + 16 * k);
+    const uint8x16_t mask = vdupq_n_u8(0x3F);
+    size_t i = 0;
+    size_t o = 0;
+    for (; nLen - i >= 48; i += 48, o += 64)
+    {
+        uint8x16x3_t in = vld3q_u8(src + i);
+        uint8x16x4_t out;
+        out.val[0] = vshrq_n_u8(in.val[0], 2);
+        out.val[1] = vandq_u8(
+                vorrq_u8(vshrq_n_u8(in.val[1], 4), vshlq_n_u8(in.val[0], 4)),
+                mask);
+        out.val[2] = vandq_u8(
+                vorrq_u8(vshrq_n_u8(in.val[2], 6), vshlq_n_u8(in.val[1], 2)),
+                mask);
+        out.val[3] = vandq_u8(in.val[2], mask);
+        for (int k = 0; k < 4; ++k) out.val[k] = vqtbl4q_u8(table, out.val[k]);
+        vst4q_u8(reinterpret_cast<uint8_t *>(dst + o), out);
+    }
+    return i;
+}
+
+static size_t base64DecodeSimd(const char *src, size_t nLen,
+                               unsigned char *dst, Base64Alphabet alphabet)
+{
+    const unsigned char *values = base64Table(alphabet).Values;
+    uint8x16x4_t tableLo, tableHi;
+    for (int k = 0; k < 4; ++k)
+    {
+        tableLo.val[k] = vld1q_u8(values + 16 * k);
+        tableHi.val[k] = vld1q_u8(values + 64 + 16 * k);
+    }
+    size_t i = 0;
+    size_t o = 0;
+    for (; nLen - i >= 64; i += 64, o += 48)
+    {
+        uint8x16x4_t in = vld4q_u8(reinterpret_cast<const uint8_t *>(src + i));
+        uint8x16_t v[4];
+        uint8x16_t bad = vdupq_n_u8(0);
+        for (int k = 0; k < 4; ++k)
+        {
+            // Characters from 128 up fall outside both tables and keep bit 7 set.
+            v[k] = vqtbx4q_u8(vqtbl4q_u8(tableLo, in.val[k]), tableHi,
+                              vsubq_u8(in.val[k], vdupq_n_u8(64)));
+            bad = vorrq_u8(bad, vorrq_u8(v[k], in.val[k]));
+        }
+        if (vmaxvq_u8(bad) & 0x80) break;
+        uint8x16x3_t out;
+        out.val[0] = vorrq_u8(vshlq_n_u8(v[0], 2), vshrq_n_u8(v[1], 4));
+        out.val[1] = vorrq_u8(vshlq_n_u8(v[1], 4), vshrq_n_u8(v[2], 2));
+        out.val[2] = vorrq_u8(vshlq_n_u8(v[2], 6), v[3]);
+        vst3q_u8(dst + o, out);
+    }
+    return i;
+}
+
+#else
+
+static size_t hexEncodeSimd(const unsigned char *, size_t, char *, const char *)
+{
+    return 0;
+}
+
+static size_t hexDecodeSimd(const char *, size_t, unsigned char *) { return 0; }
+
+static size_t base64EncodeSimd(const unsigned char *, size_t, char *,
+                               Base64Alphabet)
+{
+    return 0;
+}
+
+static size_t base64DecodeSimd(const char *, size_t, unsigned char *,
+                               Base64Alphabet)
+{
+    return 0;
+}
+
+#endif
+
+/* ----------------------------------- Hex ---------------------------------- */
+
+size_t Hex::Encode(const unsigned char *src, size_t nLen, char *dst,
+                   bool bUpperCase)
+{
+    const char *digits = bUpperCase ? s_HexUpper : s_HexLower;
+    size_t i = hexEncodeSimd(src, nLen, dst, digits);
+    for (; i < nLen; ++i)
+    {
+        dst[2 * i] = digits[src[i] >> 4];
+        dst[2 * i + 1] = digits[src[i] & 0x0F];
+    }
+    return nLen * 2;
+}
+
+std::string Hex::Encode(const unsigned char *src, size_t nLen, bool bUpperCase)
+{
+    std::string str(EncodedLength(nLen), '\0');
+    Encode(src, nLen, &str[0], bUpperCase);
+    return str;
+}
+
+bool Hex::Decode(const char *src, size_t nLen, unsigned char *dst)
+{
+    if (nLen % 2) return false;
+    const unsigned char *values = hexTable().Values;
+    for (size_t i = hexDecodeSimd(src, nLen, dst); i < nLen; i += 2)
+    {
+        unsigned char hi = values[static_cast<unsigned char>(src[i])];
+        unsigned char lo = values[static_cast<unsigned char>(src[i + 1])];
+        if ((hi | lo) & 0xF0) return false;
+        dst[i / 2] = static_cast<unsigned char>((hi << 4) | lo);
+    }
+    return true;
+}
+
+bool Hex::Decode(std::string_view str, ByteBuffer *pOut)
+{
+    if (!pOut || str.size() % 2) return false;
+    unsigned char *dst =
+            pOut->Allocate(static_cast<unsigned int>(DecodedLength(str.size())));
+    return Decode(str.data(), str.size(), dst);
+}
+
+/* --------------------------------- Base64 --------------------------------- */
+
+size_t Base64::EncodedLength(size_t nLen, bool bPadding)
+{
+    if (bPadding) return (nLen + 2) / 3 * 4;
+    return nLen / 3 * 4 + (nLen % 3 ? nLen % 3 + 1 : 0);
+}
+
+size_t Base64::Encode(const unsigned char *src, size_t nLen, char *dst,
+                      Base64Alphabet alphabet, bool bPadding)
+{
+    const char *chars = base64Chars(alphabet);
+    size_t i = base64EncodeSimd(src, nLen, dst, alphabet);
+    size_t o = i / 3 * 4;
+    for (; nLen - i >= 3; i += 3, o += 4)
+    {
+        unsigned int v = (src[i] << 16) | (src[i + 1] << 8) | src[i + 2];
+        dst[o] = chars[v >> 18];
+        dst[o + 1] = chars[(v >> 12) & 0x3F];
+        dst[o + 2] = chars[(v >> 6) & 0x3F];
+        dst[o + 3] = chars[v & 0x3F];
+    }
+    if (i < nLen)
+    {
+        unsigned int v = src[i] << 16;
+        if (nLen - i == 2) v |= src[i + 1] << 8;
+        dst[o++] = chars[v >> 18];
+        dst[o++] = chars[(v >> 12) & 0x3F];
+        if (nLen - i == 2) dst[o++] = chars[(v >> 6) & 0x3F];
+        else if (bPadding)
+            dst[o++] = '=';
+        if (bPadding) dst[o++] = '=';
+    }
+    return o;
+}
+
+std::string Base64::Encode(const unsigned char *src, size_t nLen,
+                           Base64Alphabet alphabet, bool bPadding)
+{
+    std::string str(EncodedLength(nLen, bPadding), '\0');
+    Encode(src, nLen, &str[0], alphabet, bPadding);
+    return str;
+}
+
+/// Returns the length of the text without padding, or npos if the padding is
+/// misplaced or the remaining length cannot be decoded.
+static size_t unpaddedLength(const char *src, size_t nLen)
+{
+    size_t n = nLen;
+    if (n % 4 == 0)
+    {
+        if (n && src[n - 1] == '=') --n;
+        if (n && src[n - 1] == '=') --n;
+    }
+    return n % 4 == 1 ? std::string_view::npos : n;
+}
+
+size_t Base64::DecodedLength(const char *src, size_t nLen)
+{
+    size_t n = unpaddedLength(src, nLen);
+    if (n == std::string_view::npos) return n;
+    return n / 4 * 3 + (n % 4 ? n % 4 - 1 : 0);
+}
+
+bool Base64::Decode(const char *src, size_t nLen, unsigned char *dst,
+                    Base64Alphabet alphabet)
+{
+    size_t n = unpaddedLength(src, nLen);
+    if (n == std::string_view::npos) return false;
+    const unsigned char *values = base64Table(alphabet).Values;
+
+    size_t nWhole = n / 4 * 4;
+    size_t i = base64DecodeSimd(src, nWhole, dst, alphabet);
+    size_t o = i / 4 * 3;
+    for (; i < nWhole; i += 4, o += 3)
+    {
+        unsigned int a = values[static_cast<unsigned char>(src[i])];
+        unsigned int b = values[static_cast<unsigned char>(src[i + 1])];
+        unsigned int c = values[static_cast<unsigned char>(src[i + 2])];
+        unsigned int d = values[static_cast<unsigned char>(src[i + 3])];
+        if ((a | b | c | d) & 0x80) return false;
+        unsigned int v = (a << 18) | (b << 12) | (c << 6) | d;
+        dst[o] = static_cast<unsigned char>(v >> 16);
+        dst[o + 1] = static_cast<unsigned char>(v >> 8);
+        dst[o + 2] = static_cast<unsigned char>(v);
+    }
+    if (i < n)
+    {
+        unsigned int a = values[static_cast<unsigned char>(src[i])];
+        unsigned int b = values[static_cast<unsigned char>(src[i + 1])];
+        unsigned int c = n - i == 3 ? values[static_cast<unsigned char>(src[i + 2])]
+                                    : 0;
+        if ((a | b | c) & 0x80) return false;
+        unsigned int v = (a << 18) | (b << 12) | (c << 6);
+        dst[o] = static_cast<unsigned char>(v >> 16);
+        if (n - i == 3) dst[o + 1] = static_cast<unsigned char>(v >> 8);
+    }
+    return true;
+}
+
+bool Base64::Decode(std::string_view str, ByteBuffer *pOut,
+                    Base64Alphabet alphabet)
+{
+    if (!pOut) return false;
+    size_t nOut = DecodedLength(str.data(), str.size());
+    if (nOut == std::string_view::npos) return false;
+    unsigned char *dst = pOut->Allocate(static_cast<unsigned int>(nOut));
+    return Decode(str.data(), str.size(), dst, alphabet);
+}
+
+bool Base64::IsValid(std::string_view str, Base64Alphabet alphabet)
+{
+    size_t n = unpaddedLength(str.data(), str.size());
+    if (n == std::string_view::npos) return false;
+    const unsigned char *values = base64Table(alphabet).Values;
+    return std::all_of(str.begin(), str.begin() + n, [values](char c) {
+        return values[static_cast<unsigned char>(c)] != 0xFF;
+    });
+}
+
+/* ------------------------------ codec streams ----------------------------- */
+
+static Base64Alphabet codecAlphabet(TextCodec codec)
+{
+    return codec == TextCodec::eBase64Url ? Base64Alphabet::eUrlSafe
+                                          : Base64Alphabet::eStandard;
+}
+
+/// Bytes encoded per write to the wrapped stream, a multiple of three.
+static constexpr size_t CodecBlockBytes = 3072;
+
+EncodingOutputStream::EncodingOutputStream(OutputStream *inner, TextCodec codec)
+    : m_Inner(inner), m_Codec(codec)
+{
+}
+
+EncodingOutputStream::~EncodingOutputStream() { Finish(); }
+
+OutputStream *EncodingOutputStream::Inner() const { return m_Inner.p; }
+
+bool EncodingOutputStream::WriteEncoded(const unsigned char *buff, size_t nLen)
+{
+    if (m_Text.empty()) m_Text.resize(CodecBlockBytes * 2);
+    while (nLen)
+    {
+        size_t nBlock = std::min(nLen, CodecBlockBytes);
+        size_t nText = m_Codec == TextCodec::eHex
+                               ? Hex::Encode(buff, nBlock, m_Text.data())
+                               : Base64::Encode(buff, nBlock, m_Text.data(),
+                                                codecAlphabet(m_Codec));
+        const unsigned char *text =
+                reinterpret_cast<const unsigned char *>(m_Text.data());
+        if (m_Inner->RawWrite(text, static_cast<int>(nText)) !=
+            static_cast<int>(nText))
+            return false;
+        buff += nBlock;
+        nLen -= nBlock;
+    }
+    return true;
+}
+
+int EncodingOutputStream::RawWrite(const unsigned char *buff, int nLen)
+{
+    if (m_bFinished || !buff || nLen <= 0) return 0;
+    const unsigned char *p = buff;
+    size_t n = static_cast<size_t>(nLen);
+    size_t nRest = 0;
+    if (m_Codec != TextCodec::eHex)
+    {
+        if (m_nPending)
+        {
+            // complete the pending group in a copy, so a failed write leaves
+            // the stream as it was
+            unsigned char group[3];
+            std::memcpy(group, m_Pending, m_nPending);
+            int nGroup = m_nPending;
+            while (n && nGroup < 3)
+            {
+                group[nGroup++] = *p++;
+                --n;
+            }
+            if (nGroup < 3)
+            {
+                std::memcpy(m_Pending, group, nGroup);
+                m_nPending = nGroup;
+                m_nOffset += nLen;
+                return nLen;
+            }
+            if (!WriteEncoded(group, 3)) return 0;
+            m_nPending = 0;
+            m_nOffset += p - buff;
+        }
+        nRest = n % 3;
+        n -= nRest;
+    }
+    if (!WriteEncoded(p, n)) return static_cast<int>(p - buff);
+    // keep the incomplete tail group only once everything before it is written
+    std::memcpy(m_Pending, p + n, nRest);
+    m_nPending = static_cast<int>(nRest);
+    m_nOffset += nLen - (p - buff);
+    return nLen;
+}
+
+bool EncodingOutputStream::Finish()
+{
+    if (m_bFinished) return true;
+    m_bFinished = true;
+    if (!m_nPending) return true;
+    char text[4];
+    size_t nText = Base64::Encode(m_Pending, m_nPending, text,
+                                  codecAlphabet(m_Codec));
+    m_nPending = 0;
+    return m_Inner->RawWrite(reinterpret_cast<const unsigned char *>(text),
+                             static_cast<int>(nText)) ==
+           static_cast<int>(nText);
+}
+
+unsigned long long EncodingOutputStream::Offset() const { return m_nOffset; }
+
+bool EncodingOutputStream::Flush() { return m_Inner->Flush(); }
+
+bool EncodingOutputStream::Close()
+{
+    bool bOk = Finish();
+    return m_Inner->Close() && bOk;
+}
+
+DecodingInputStream::DecodingInputStream(InputStream *inner, TextCodec codec)
+    : m_Inner(inner), m_Codec(codec)
+{
+}
+
+InputStream *DecodingInputStream::Inner() const { return m_Inner.p; }
+
+bool DecodingInputStream::HasError() const { return m_bError; }
+
+bool DecodingInputStream::Refill()
+{
+    m_Bytes.clear();
+    m_nBytePos = 0;
+    const size_t nGroup = m_Codec == TextCodec::eHex ? 2 : 4;
+    while (m_Bytes.empty() && !m_bError)
+    {
+        if (!m_bInnerEof)
+        {
+            char chunk[4096];
+            int n = m_Inner->RawRead(reinterpret_cast<unsigned char *>(chunk),
+                                     sizeof(chunk));
+            if (n <= 0) m_bInnerEof = true;
+            for (int i = 0; i < n; ++i)
+            {
+                char c = chunk[i];
+                if (c != '\r' && c != '\n' && c != ' ' && c != '\t')
+                    m_Text.push_back(c);
+            }
+        }
+
+        // Decode whole groups only, so that a group split across reads is
+        // completed by the next one; at the end the rest must be a valid tail.
+        size_t nUsable = m_bInnerEof ? m_Text.size()
+                                     : m_Text.size() / nGroup * nGroup;
+        if (nUsable)
+        {
+            bool bOk;
+            if (m_Codec == TextCodec::eHex)
+            {
+                m_Bytes.resize(Hex::DecodedLength(nUsable));
+                bOk = Hex::Decode(m_Text.data(), nUsable, m_Bytes.data());
+            }
+            else
+            {
+                size_t nOut = Base64::DecodedLength(m_Text.data(), nUsable);
+                bOk = nOut != std::string_view::npos;
+                if (bOk)
+                {
+                    m_Bytes.resize(nOut);
+                    bOk = Base64::Decode(m_Text.data(), nUsable, m_Bytes.data(),
+                                         codecAlphabet(m_Codec));
+                }
+            }
+            if (!bOk)
+            {
+                m_Bytes.clear();
+                m_bError = true;
+                break;
+            }
+            m_Text.erase(m_Text.begin(), m_Text.begin() + nUsable);
+        }
+        if (m_bInnerEof) break;
+    }
+    return !m_Bytes.empty();
+}
+
+int DecodingInputStream::RawRead(unsigned char *buff, int nLen)
+{
+    if (!buff || nLen <= 0) return 0;
+    int nTotal = 0;
+    while (nTotal < nLen)
+    {
+        if (m_nBytePos == m_Bytes.size() && !Refill()) break;
+        size_t n = std::min(m_Bytes.size() - m_nBytePos,
+                            static_cast<size_t>(nLen - nTotal));
+        std::memcpy(buff + nTotal, m_Bytes.data() + m_nBytePos, n);
+        m_nBytePos += n;
+        nTotal += static_cast<int>(n);
+    }
+    m_nOffset += nTotal;
+    return nTotal;
+}
+
+int DecodingInputStream::RawRead(unsigned char *buff, int nLen,
+                                 const unsigned char **pointer)
+{
+    if (pointer) *pointer = nullptr;
+    return RawRead(buff, nLen);
+}
+
+int DecodingInputStream::Skip(int nLen)
+{
+    unsigned char scratch[512];
+    int nSkipped = 0;
+    while (nSkipped < nLen)
+    {
+        int n = RawRead(scratch, std::min(nLen - nSkipped,
+                                          static_cast<int>(sizeof(scratch))));
+        if (n <= 0) break;
+        nSkipped += n;
+    }
+    return nSkipped;
+}
+
+unsigned long long DecodingInputStream::Offset() const { return m_nOffset; }
+
+bool DecodingInputStream::Eof() const
+{
+    if (m_nBytePos != m_Bytes.size()) return false;
+    if (m_bError) return true;
+    return m_Text.empty() && (m_bInnerEof || m_Inner->Eof());
+}
+
+}// namespace CPL
@@ -0,0 +1,211 @@
+/**
+ * CPL - Common Portability Library
+ *
+ * Copyright (C) 2024 Merlot.Rain
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include "cpl_memorymanager.h"
+#include <cpl_exports.h>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace CPL {
+
+/// \brief Hexadecimal encoding of binary data
+/// \details Encoding and decoding run 16 or 32 bytes per step with SSSE3, AVX2 or
+/// NEON when enabled at compile time, with a scalar fallback for the remainder.
+class CPL_API Hex
+{
+public:
+    /// \brief Returns the number of characters produced for nLen bytes
+    static size_t EncodedLength(size_t nLen) { return nLen * 2; }
+
+    /// \brief Encodes bytes into a caller buffer
+    /// \param src The bytes to encode
+    /// \param nLen The number of bytes
+    /// \param dst Receives EncodedLength(nLen) characters, not null-terminated
+    /// \param bUpperCase Whether to use the digits A-F instead of a-f
+    /// \return The number of characters written
+    static size_t Encode(const unsigned char *src, size_t nLen, char *dst,
+                         bool bUpperCase = false);
+
+    /// \brief Encodes bytes into a string
+    static std::string Encode(const unsigned char *src, size_t nLen,
+                              bool bUpperCase = false);
+
+    /// \brief Returns the number of bytes decoded from nLen characters
+    static size_t DecodedLength(size_t nLen) { return nLen / 2; }
+
+    /// \brief Decodes hexadecimal text into a caller buffer
+    /// \details Both letter cases are accepted.
+    /// \param src The text to decode
+    /// \param nLen The number of characters, which must be even
+    /// \param dst Receives DecodedLength(nLen) bytes
+    /// \return False if the length is odd or a character is not a hex digit
+    static bool Decode(const char *src, size_t nLen, unsigned char *dst);
+
+    /// \brief Decodes hexadecimal text into a buffer, replacing its content
+    static bool Decode(std::string_view str, ByteBuffer *pOut);
+};
+
+/// \brief Alphabet of a Base64 encoding
+enum class Base64Alphabet : int
+{
+    eStandard,///< RFC 4648 section 4, using '+' and '/'
+    eUrlSafe, ///< RFC 4648 section 5, using '-' and '_'
+};
+
+/// \brief Base64 encoding of binary data
+/// \details The 12-to-16 byte reshuffles run with SSSE3 (also on AVX2 builds) or NEON
+/// when enabled at compile time, with a scalar fallback for the remainder.
+class CPL_API Base64
+{
+public:
+    /// \brief Returns the number of characters produced for nLen bytes
+    /// \param nLen The number of bytes
+    /// \param bPadding Whether the output is padded with '=' to a multiple of four
+    static size_t EncodedLength(size_t nLen, bool bPadding = true);
+
+    /// \brief Encodes bytes into a caller buffer
+    /// \param src The bytes to encode
+    /// \param nLen The number of bytes
+    /// \param dst Receives EncodedLength(nLen, bPadding) characters, not null-terminated
+    /// \param alphabet The alphabet to use
+    /// \param bPadding Whether to pad the output with '='
+    /// \return The number of characters written
+    static size_t Encode(const unsigned char *src, size_t nLen, char *dst,
+                         Base64Alphabet alphabet = Base64Alphabet::eStandard,
+                         bool bPadding = true);
+
+    /// \brief Encodes bytes into a string
+    static std::string
+    Encode(const unsigned char *src, size_t nLen,
+           Base64Alphabet alphabet = Base64Alphabet::eStandard,
+           bool bPadding = true);
+
+    /// \brief Returns the exact number of bytes decoded from a text
+    /// \details Padding is optional, but if present the length must be a multiple of four.
+    /// \return The decoded length, or std::string_view::npos if the length is invalid
+    static size_t DecodedLength(const char *src, size_t nLen);
+
+    /// \brief Decodes Base64 text into a caller buffer
+    /// \param src The text to decode, with or without padding
+    /// \param nLen The number of characters
+    /// \param dst Receives DecodedLength(src, nLen) bytes
+    /// \param alphabet The alphabet of the text
+    /// \return False if the length is invalid or a character is outside the alphabet
+    static bool Decode(const char *src, size_t nLen, unsigned char *dst,
+                       Base64Alphabet alphabet = Base64Alphabet::eStandard);
+
+    /// \brief Decodes Base64 text into a buffer, replacing its content
+    static bool Decode(std::string_view str, ByteBuffer *pOut,
+                       Base64Alphabet alphabet = Base64Alphabet::eStandard);
+
+    /// \brief Checks whether a text is valid Base64 in the given alphabet
+    static bool IsValid(std::string_view str,
+                        Base64Alphabet alphabet = Base64Alphabet::eStandard);
+};
+
+/// \brief Text encodings supported by the codec streams
+enum class TextCodec : int
+{
+    eHex,      ///< Lower-case hexadecimal
+    eBase64,   ///< Padded standard Base64
+    eBase64Url,///< Padded URL-safe Base64
+};
+
+/// \brief Output stream that encodes the bytes written to it as text
+/// \details Bytes are encoded in blocks and the text is written to the wrapped stream.
+/// An incomplete Base64 group is held back until more bytes arrive; Close, or the
+/// destructor, writes it with padding. Offset counts the bytes written, not the text.
+class CPL_API EncodingOutputStream : public OutputStream
+{
+    OutputStreamPtr m_Inner;         ///< Receives the text
+    TextCodec m_Codec;               ///< The encoding
+    unsigned char m_Pending[3];      ///< Bytes of an incomplete group
+    int m_nPending = 0;              ///< Number of bytes in m_Pending
+    unsigned long long m_nOffset = 0;///< Bytes written
+    bool m_bFinished = false;        ///< Whether the tail has been written
+    std::vector<char> m_Text;        ///< Scratch buffer for encoded text
+
+public:
+    /// \brief Wraps an output stream
+    /// \param inner The stream receiving the text, a reference to it is held
+    /// \param codec The encoding
+    EncodingOutputStream(OutputStream *inner, TextCodec codec);
+    virtual ~EncodingOutputStream();
+
+    /// \brief Returns the wrapped stream
+    OutputStream *Inner() const;
+
+    /// \brief Writes the incomplete group, after which no more bytes are accepted
+    /// \return False if the wrapped stream failed
+    bool Finish();
+
+    virtual int RawWrite(const unsigned char *buff, int nLen);
+    virtual unsigned long long Offset() const;
+    virtual bool Flush();
+    virtual bool Close();
+
+private:
+    bool WriteEncoded(const unsigned char *buff, size_t nLen);
+};
+CPL_SMARTER_PTR(EncodingOutputStream)
+
+/// \brief Input stream that decodes the text read from another stream
+/// \details Line breaks and other whitespace in the text are skipped, so wrapped
+/// Base64 such as PEM or MIME bodies can be read directly. Reading stops at the first
+/// malformed group; HasError then returns true.
+class CPL_API DecodingInputStream : public InputStream
+{
+    InputStreamPtr m_Inner;             ///< Supplies the text
+    TextCodec m_Codec;                  ///< The encoding
+    std::vector<char> m_Text;           ///< Text not yet decoded
+    std::vector<unsigned char> m_Bytes; ///< Decoded bytes not yet read
+    size_t m_nBytePos = 0;              ///< Read position in m_Bytes
+    unsigned long long m_nOffset = 0;   ///< Bytes read
+    bool m_bInnerEof = false;           ///< Whether the text is exhausted
+    bool m_bError = false;              ///< Whether malformed text was found
+
+public:
+    /// \brief Wraps an input stream
+    /// \param inner The stream supplying the text, a reference to it is held
+    /// \param codec The encoding
+    DecodingInputStream(InputStream *inner, TextCodec codec);
+
+    /// \brief Returns the wrapped stream
+    InputStream *Inner() const;
+
+    /// \brief Checks whether malformed text was found
+    bool HasError() const;
+
+    virtual int Skip(int nLen);
+    virtual int RawRead(unsigned char *buff, int nLen);
+    virtual int RawRead(unsigned char *buff, int nLen,
+                        const unsigned char **pointer);
+    virtual unsigned long long Offset() const;
+    virtual bool Eof() const;
+
+private:
+    bool Refill();
+};
+CPL_SMARTER_PTR(DecodingInputStream)
+
+}// namespace CPL
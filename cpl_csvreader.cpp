@@ -0,0 +1,212 @@
+/**
+ * CPL - Common Portability Library
+ *
+ * Copyright (C) 2024 Merlot.Rain
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "cpl_csvreader.h"
+#include "cpl_simd.h"
+#include <algorithm>
+#include <cstring>
+
+namespace CPL {
+
+static constexpr size_t s_nCsvBlock = 64;
+static constexpr size_t s_nCsvBufferSize = 65536;
+
+/// Sets every bit from a quote up to, not including, the next one: prefix XOR of the mask
+static unsigned long long quotedMask(unsigned long long nQuotes)
+{
+    nQuotes ^= nQuotes << 1;
+    nQuotes ^= nQuotes << 2;
+    nQuotes ^= nQuotes << 4;
+    nQuotes ^= nQuotes << 8;
+    nQuotes ^= nQuotes << 16;
+    nQuotes ^= nQuotes << 32;
+    return nQuotes;
+}
+
+CsvReader::CsvReader(std::string_view data, char delimiter, char quote)
+    : m_pData(data.data()), m_nLen(data.size()), m_bEof(true),
+      m_cDelimiter(delimiter), m_cQuote(quote)
+{
+}
+
+CsvReader::CsvReader(InputStream *stream, char delimiter, char quote)
+    : m_Stream(stream), m_Buffer(s_nCsvBufferSize), m_pData(m_Buffer.data()),
+      m_nLen(0), m_bEof(false), m_cDelimiter(delimiter), m_cQuote(quote)
+{
+}
+
+size_t CsvReader::RecordCount() const { return m_nRecords; }
+
+bool CsvReader::HasError() const { return m_bError; }
+
+bool CsvReader::Refill()
+{
+    // keep the current record, whose field ends move along with it
+    if (m_nPos)
+    {
+        std::memmove(m_Buffer.data(), m_Buffer.data() + m_nPos, m_nLen - m_nPos);
+        for (size_t &nEnd: m_Ends) nEnd -= m_nPos;
+        m_nLen -= m_nPos;
+        m_nNext -= m_nPos;
+        m_nPos = 0;
+    }
+    if (m_nLen == m_Buffer.size()) m_Buffer.resize(m_Buffer.size() * 2);
+    m_pData = m_Buffer.data();
+
+    int n = m_Stream->RawRead(reinterpret_cast<unsigned char *>(m_Buffer.data() + m_nLen),
+                              static_cast<int>(std::min<size_t>(
+                                      m_Buffer.size() - m_nLen, 0x40000000)));
+    if (n <= 0)
+    {
+        m_bEof = true;
+        return false;
+    }
+    m_nLen += n;
+    return true;
+}
+
+bool CsvReader::ScanBlock()
+{
+    while (!m_bEof && m_nNext + s_nCsvBlock > m_nLen) Refill();
+    if (m_nNext >= m_nLen) return false;
+
+    const char *p = m_pData + m_nNext;
+    size_t nAvail = m_nLen - m_nNext;
+    char tail[s_nCsvBlock];
+    if (nAvail < s_nCsvBlock)
+    {
+        std::memcpy(tail, p, nAvail);
+        std::memset(tail + nAvail, 0, s_nCsvBlock - nAvail);
+        p = tail;
+    }
+
+    unsigned long long nQuoted = quotedMask(Simd::MatchMask64(p, m_cQuote));
+    if (m_bInQuote) nQuoted = ~nQuoted;
+    m_bInQuote = nQuoted >> 63;
+    unsigned long long nValid =
+            nAvail < s_nCsvBlock ? (1ULL << nAvail) - 1 : ~0ULL;
+    m_Lines = Simd::MatchMask64(p, '\n') & ~nQuoted & nValid;
+    m_Structural = (Simd::MatchMask64(p, m_cDelimiter) | m_Lines) & ~nQuoted & nValid;
+    m_nBlock = m_nNext;
+    m_nNext += s_nCsvBlock;
+    return true;
+}
+
+std::string_view CsvReader::Field(size_t nBegin, size_t nEnd, bool bLast)
+{
+    std::string_view raw(m_pData + nBegin, nEnd - nBegin);
+    if (bLast && !raw.empty() && raw.back() == '\r') raw.remove_suffix(1);
+    if (raw.empty() || raw.front() != m_cQuote) return raw;
+
+    raw.remove_prefix(1);
+    if (!raw.empty() && raw.back() == m_cQuote) raw.remove_suffix(1);
+    if (raw.find(m_cQuote) == std::string_view::npos) return raw;
+
+    // the storage was reserved for the whole record, so earlier views stay valid
+    size_t nStart = m_Unescaped.size();
+    for (size_t i = 0; i < raw.size(); ++i)
+    {
+        m_Unescaped.push_back(raw[i]);
+        if (raw[i] == m_cQuote && i + 1 < raw.size() && raw[i + 1] == m_cQuote) ++i;
+    }
+    return std::string_view(m_Unescaped.data() + nStart, m_Unescaped.size() - nStart);
+}
+
+bool CsvReader::Next(std::vector<std::string_view> &fields)
+{
+    fields.clear();
+    m_Ends.clear();
+    bool bLineEnd = false;
+    while (!bLineEnd)
+    {
+        while (!m_Structural)
+        {
+            if (!ScanBlock())
+            {
+                // the input ends the last record, unless it ended with a line feed
+                if (m_nPos >= m_nLen && m_Ends.empty()) return false;
+                if (m_bInQuote) m_bError = true;
+                m_Ends.push_back(m_nLen);
+                bLineEnd = true;
+                break;
+            }
+        }
+        if (bLineEnd) break;
+
+        int nBit = Simd::CountTrailingZeros64(m_Structural);
+        m_Structural &= m_Structural - 1;
+        m_Ends.push_back(m_nBlock + nBit);
+        bLineEnd = (m_Lines >> nBit) & 1;
+    }
+
+    m_Unescaped.clear();
+    m_Unescaped.reserve(m_Ends.back() - m_nPos);
+    size_t nBegin = m_nPos;
+    for (size_t i = 0; i < m_Ends.size(); ++i)
+    {
+        fields.push_back(Field(nBegin, m_Ends[i], i + 1 == m_Ends.size()));
+        nBegin = m_Ends[i] + 1;
+    }
+    m_nPos = std::min(nBegin, m_nLen);
+    ++m_nRecords;
+    return true;
+}
+
+std::vector<std::string_view> CsvReader::SplitChunks(std::string_view data,
+                                                     size_t nChunks, char quote)
+{
+    std::vector<std::string_view> chunks;
+    if (nChunks < 1) nChunks = 1;
+    const size_t nTarget = data.size() / nChunks;
+    size_t nStart = 0;
+    size_t nScanned = 0;// quotes before nScanned have been counted
+    bool bInQuote = false;
+    while (chunks.size() + 1 < nChunks && nTarget)
+    {
+        size_t nWant = std::max(nStart + nTarget, nScanned);
+        if (nWant >= data.size()) break;
+
+        // quote parity up to the wanted boundary, 64 bytes at a time
+        for (; nScanned + s_nCsvBlock <= nWant; nScanned += s_nCsvBlock)
+            bInQuote ^= Simd::PopCount64(
+                                Simd::MatchMask64(data.data() + nScanned, quote)) &
+                        1;
+        for (; nScanned < nWant; ++nScanned)
+            if (data[nScanned] == quote) bInQuote = !bInQuote;
+
+        // then the first line feed outside quotes
+        for (; nScanned < data.size(); ++nScanned)
+        {
+            char c = data[nScanned];
+            if (c == quote) bInQuote = !bInQuote;
+            else if (c == '\n' && !bInQuote)
+                break;
+        }
+        if (nScanned >= data.size()) break;
+        ++nScanned;
+        chunks.push_back(data.substr(nStart, nScanned - nStart));
+        nStart = nScanned;
+    }
+    if (nStart < data.size() || chunks.empty())
+        chunks.push_back(data.substr(nStart));
+    return chunks;
+}
+
+}// namespace CPL
@@ -0,0 +1,109 @@
+/**
+ * CPL - Common Portability Library
+ *
+ * Copyright (C) 2024 Merlot.Rain
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include "cpl_memorymanager.h"
+#include <cpl_exports.h>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace CPL {
+
+/// \brief Reads delimited records, such as CSV, returning fields as views
+/// \details Input is classified 64 bytes at a time: bitmasks of quotes, delimiters and
+/// line feeds are built with SIMD compares, and a prefix XOR of the quote mask tells
+/// which delimiters and line feeds are inside quoted fields. Quoted fields follow RFC
+/// 4180: they may contain delimiters and line breaks, and a doubled quote stands for
+/// one. Fields are views into the input; only quoted fields containing doubled quotes
+/// are unescaped, into storage owned by the reader. A carriage return before a line
+/// feed is dropped.
+class CPL_API CsvReader
+{
+public:
+    /// \brief Reads records from memory, such as a mapped file
+    /// \details Fields stay valid as long as the data, except unescaped ones, which
+    /// stay valid until the next call to Next.
+    /// \param data The delimited text, which must outlive the reader
+    /// \param delimiter The field delimiter
+    /// \param quote The quote character
+    explicit CsvReader(std::string_view data, char delimiter = ',',
+                       char quote = '"');
+
+    /// \brief Reads records from a stream in blocks
+    /// \details Memory use is bounded by the longest record. Fields stay valid until
+    /// the next call to Next.
+    /// \param stream The stream supplying the text, a reference to it is held
+    /// \param delimiter The field delimiter
+    /// \param quote The quote character
+    explicit CsvReader(InputStream *stream, char delimiter = ',',
+                       char quote = '"');
+
+    CPL_DISABLE_COPY(CsvReader)
+
+    /// \brief Reads the next record
+    /// \param fields Receives the fields of the record
+    /// \return False when the input is exhausted
+    bool Next(std::vector<std::string_view> &fields);
+
+    /// \brief Number of records read so far
+    size_t RecordCount() const;
+
+    /// \brief Whether the input ended inside a quoted field
+    bool HasError() const;
+
+    /// \brief Splits delimited text into chunks of whole records for parallel parsing
+    /// \details Each chunk but the last ends with a line feed outside quotes, so a
+    /// CsvReader can parse each of them independently. Finding the boundaries needs
+    /// the quote parity up to them, which is tracked with a vectorized count.
+    /// \param data The delimited text
+    /// \param nChunks The number of chunks wanted; fewer are returned for short input
+    /// \param quote The quote character
+    /// \return Views into data, in order and covering all of it
+    static std::vector<std::string_view> SplitChunks(std::string_view data,
+                                                     size_t nChunks,
+                                                     char quote = '"');
+
+private:
+    bool ScanBlock();
+    bool Refill();
+    std::string_view Field(size_t nBegin, size_t nEnd, bool bLast);
+
+    InputStreamPtr m_Stream;            ///< Source of the text, null when reading memory
+    std::vector<char> m_Buffer;         ///< Text read from the stream
+    const char *m_pData;                ///< The text being parsed
+    size_t m_nLen;                      ///< Length of the text
+    size_t m_nPos = 0;                  ///< Start of the next record
+    size_t m_nBlock = 0;                ///< Start of the block described by the masks
+    size_t m_nNext = 0;                 ///< Start of the next block to classify
+    unsigned long long m_Structural = 0;///< Delimiters and line feeds outside quotes not yet consumed
+    unsigned long long m_Lines = 0;     ///< Line feeds outside quotes in the block
+    bool m_bInQuote = false;            ///< Whether the next block starts inside quotes
+    bool m_bEof;                        ///< Whether all of the text is available
+    bool m_bError = false;              ///< Whether the text ended inside quotes
+    char m_cDelimiter;                  ///< The field delimiter
+    char m_cQuote;                      ///< The quote character
+    size_t m_nRecords = 0;              ///< Records read
+    std::vector<size_t> m_Ends;         ///< Ends of the fields of the current record
+    std::string m_Unescaped;            ///< Storage for unescaped fields
+};
+
+}// namespace CPL
@@ -20,6 +20,7 @@
 
 #pragma once
 
+#include <initializer_list>
 #include <type_traits>
 
 namespace CPL {
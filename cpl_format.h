@@ -0,0 +1,235 @@
+/**
+ * CPL - Common Portability Library
+ *
+ * Copyright (C) 2024 Merlot.Rain
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include "cpl_any.h"
+#include "cpl_datetime.h"
+#include "cpl_image.h"
+#include "cpl_mathhelp.h"
+#include "cpl_memorymanager.h"
+#include <fmt/format.h>
+#include <iterator>
+#include <string>
+#include <string_view>
+#include <utility>
+
+namespace CPL {
+
+/// \brief Formats arguments into a new string
+/// \details The format string is checked against the argument types at compile
+/// time, see https://fmt.dev/latest/syntax.html for the syntax.
+/// \param format The format string
+/// \param args The arguments
+/// \return The formatted string
+template<typename... Args>
+std::string Format(fmt::format_string<Args...> format, Args &&...args)
+{
+    return fmt::vformat(format, fmt::make_format_args(args...));
+}
+
+/// \brief Appends formatted text to a fmt memory buffer
+/// \details Output that fits the inline storage of the buffer allocates nothing, so a
+/// buffer reused across calls formats without allocating.
+template<typename... Args>
+void FormatTo(fmt::memory_buffer &buffer, fmt::format_string<Args...> format,
+              Args &&...args)
+{
+    fmt::vformat_to(std::back_inserter(buffer), format,
+                    fmt::make_format_args(args...));
+}
+
+/// \brief Appends formatted text to a string
+template<typename... Args>
+void FormatTo(std::string &str, fmt::format_string<Args...> format,
+              Args &&...args)
+{
+    fmt::vformat_to(std::back_inserter(str), format,
+                    fmt::make_format_args(args...));
+}
+
+/// \brief Appends formatted text to a byte buffer
+/// \return The number of bytes appended
+template<typename... Args>
+size_t FormatTo(ByteBuffer &buffer, fmt::format_string<Args...> format,
+                Args &&...args)
+{
+    fmt::memory_buffer text;
+    fmt::vformat_to(std::back_inserter(text), format,
+                    fmt::make_format_args(args...));
+    buffer.Append(reinterpret_cast<const unsigned char *>(text.data()),
+                  static_cast<int>(text.size()));
+    return text.size();
+}
+
+/// \brief Writes formatted text to an output stream
+/// \return The number of bytes written
+template<typename... Args>
+int FormatTo(OutputStream *stream, fmt::format_string<Args...> format,
+             Args &&...args)
+{
+    fmt::memory_buffer text;
+    fmt::vformat_to(std::back_inserter(text), format,
+                    fmt::make_format_args(args...));
+    return stream->RawWrite(reinterpret_cast<const unsigned char *>(text.data()),
+                            static_cast<int>(text.size()));
+}
+
+/// \brief Writes formatted text into a caller buffer, truncating it if needed
+/// \details Like snprintf, no terminator is written by this function.
+/// \return The length of the complete output, which exceeds nSize if it was truncated
+template<typename... Args>
+size_t FormatTo(char *buf, size_t nSize, fmt::format_string<Args...> format,
+                Args &&...args)
+{
+    return fmt::vformat_to_n(buf, nSize, format, fmt::make_format_args(args...))
+            .size;
+}
+
+}// namespace CPL
+
+/// \brief Formats a DateTime in ISO 8601 form, 2024-01-31T08:30:00 with a fraction
+/// of six digits when it has sub-second precision. Width and alignment apply.
+template<>
+struct fmt::formatter<CPL::DateTime> : fmt::formatter<std::string_view>
+{
+    template<typename FormatContext>
+    auto format(const CPL::DateTime &dt, FormatContext &ctx) const
+            -> decltype(ctx.out())
+    {
+        char text[40];
+        char *p = fmt::format_to(text, "{:04d}-{:02d}-{:02d}T{:02d}:{:02d}:{:02d}",
+                                 dt.Year(), dt.Month(), dt.Day(), dt.Hour(),
+                                 dt.Minute(), dt.Second());
+        int nFraction = dt.Millisecond() * 1000 + dt.Microsecond();
+        if (nFraction) p = fmt::format_to(p, ".{:06d}", nFraction);
+        return fmt::formatter<std::string_view>::format(
+                std::string_view(text, p - text), ctx);
+    }
+};
+
+/// \brief Formats a TimeSpan as [-][d.]hh:mm:ss[.ffffff]. Width and alignment apply.
+template<>
+struct fmt::formatter<CPL::TimeSpan> : fmt::formatter<std::string_view>
+{
+    template<typename FormatContext>
+    auto format(const CPL::TimeSpan &span, FormatContext &ctx) const
+            -> decltype(ctx.out())
+    {
+        long long nTotal = span.TotalMicroseconds();
+        unsigned long long t = nTotal < 0 ? 0ULL - static_cast<unsigned long long>(nTotal)
+                                          : static_cast<unsigned long long>(nTotal);
+        unsigned long long nMicros = t % 1000000;
+        t /= 1000000;
+        char text[48];
+        char *p = text;
+        if (nTotal < 0) *p++ = '-';
+        if (t >= 86400) p = fmt::format_to(p, "{}.", t / 86400);
+        p = fmt::format_to(p, "{:02d}:{:02d}:{:02d}", t / 3600 % 24, t / 60 % 60,
+                           t % 60);
+        if (nMicros) p = fmt::format_to(p, ".{:06d}", nMicros);
+        return fmt::formatter<std::string_view>::format(
+                std::string_view(text, p - text), ctx);
+    }
+};
+
+/// \brief Formats a Guid; the presentation is one of the Guid::Format letters D
+/// (default), N, B, P or X, as in "{:N}".
+template<>
+struct fmt::formatter<CPL::Guid>
+{
+    CPL::Guid::Format m_Format = CPL::Guid::Format::eHyphens32;
+
+    constexpr auto parse(fmt::format_parse_context &ctx) -> decltype(ctx.begin())
+    {
+        auto it = ctx.begin();
+        if (it != ctx.end() && *it != '}')
+        {
+            switch (*it)
+            {
+                case 'D':
+                case 'N':
+                case 'B':
+                case 'P':
+                case 'X':
+                    m_Format = static_cast<CPL::Guid::Format>(*it++);
+                    break;
+                default:
+                    throw fmt::format_error("invalid Guid format");
+            }
+        }
+        if (it != ctx.end() && *it != '}')
+            throw fmt::format_error("invalid Guid format");
+        return it;
+    }
+
+    template<typename FormatContext>
+    auto format(const CPL::Guid &guid, FormatContext &ctx) const
+            -> decltype(ctx.out())
+    {
+        const auto &d = guid.Data128;
+        switch (m_Format)
+        {
+            case CPL::Guid::Format::eHyphens32:
+                return fmt::format_to(
+                        ctx.out(),
+                        "{:08x}-{:04x}-{:04x}-{:02x}{:02x}-{:02x}{:02x}{:02x}{:02x}"
+                        "{:02x}{:02x}",
+                        d.Data1, d.Data2, d.Data3, d.Data4[0], d.Data4[1],
+                        d.Data4[2], d.Data4[3], d.Data4[4], d.Data4[5],
+                        d.Data4[6], d.Data4[7]);
+            default:
+                {
+                    std::string str = guid.ToString(m_Format);
+                    return std::copy(str.begin(), str.end(), ctx.out());
+                }
+        }
+    }
+};
+
+/// \brief Formats a Color as #RRGGBB, or #RRGGBBAA when it is not opaque. Width and
+/// alignment apply.
+template<>
+struct fmt::formatter<CPL::Color> : fmt::formatter<std::string_view>
+{
+    template<typename FormatContext>
+    auto format(const CPL::Color &color, FormatContext &ctx) const
+            -> decltype(ctx.out())
+    {
+        char text[10];
+        char *p = fmt::format_to(text, "#{:02X}{:02X}{:02X}", color.R, color.G,
+                                 color.B);
+        if (color.A != 255) p = fmt::format_to(p, "{:02X}", color.A);
+        return fmt::formatter<std::string_view>::format(
+                std::string_view(text, p - text), ctx);
+    }
+};
+
+/// \brief Formats an Any through Any::ToString. Width and alignment apply.
+template<>
+struct fmt::formatter<CPL::Any> : fmt::formatter<std::string_view>
+{
+    template<typename FormatContext>
+    auto format(const CPL::Any &value, FormatContext &ctx) const
+            -> decltype(ctx.out())
+    {
+        return fmt::formatter<std::string_view>::format(value.ToString(), ctx);
+    }
+};
@@ -0,0 +1,131 @@
+/**
+ * CPL - Common Portability Library
+ *
+ * Copyright (C) 2024 Merlot.Rain
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "cpl_hash.h"
+#include <chrono>
+#include <cstring>
+#include <random>
+
+namespace CPL {
+
+namespace {
+
+/// Odd constants with 32 set bits, from wyhash
+constexpr unsigned long long kSecret[4] = {
+        0x2D358DCCAA6C78A5ULL, 0x8BB84B93962EACC9ULL, 0x4B33A62ED433D4A3ULL,
+        0x4D5A2DA51DE1AA47ULL};
+
+inline unsigned long long read64(const unsigned char *p)
+{
+    unsigned long long v;
+    std::memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+inline unsigned long long read32(const unsigned char *p)
+{
+    unsigned int v;
+    std::memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+/// 1 to 3 bytes, reading the first, middle and last byte
+inline unsigned long long read3(const unsigned char *p, size_t nLen)
+{
+    return (static_cast<unsigned long long>(p[0]) << 16) |
+           (static_cast<unsigned long long>(p[nLen >> 1]) << 8) | p[nLen - 1];
+}
+
+}// namespace
+
+unsigned long long Hash::Bytes(const void *pData, size_t nLen,
+                               unsigned long long nSeed)
+{
+    const unsigned char *p = static_cast<const unsigned char *>(pData);
+    nSeed ^= MulFold(nSeed ^ kSecret[0], kSecret[1]);
+    unsigned long long a, b;
+    if (nLen <= 16)
+    {
+        // two overlapping reads cover every length without a loop
+        if (nLen >= 4)
+        {
+            size_t nShift = (nLen >> 3) << 2;
+            a = (read32(p) << 32) | read32(p + nShift);
+            b = (read32(p + nLen - 4) << 32) | read32(p + nLen - 4 - nShift);
+        }
+        else if (nLen > 0)
+        {
+            a = read3(p, nLen);
+            b = 0;
+        }
+        else
+            a = b = 0;
+    }
+    else
+    {
+        size_t i = nLen;
+        if (i > 48)
+        {
+            // three independent lanes keep the multipliers busy
+            unsigned long long nSeed1 = nSeed, nSeed2 = nSeed;
+            do {
+                nSeed = MulFold(read64(p) ^ kSecret[1], read64(p + 8) ^ nSeed);
+                nSeed1 = MulFold(read64(p + 16) ^ kSecret[2],
+                                 read64(p + 24) ^ nSeed1);
+                nSeed2 = MulFold(read64(p + 32) ^ kSecret[3],
+                                 read64(p + 40) ^ nSeed2);
+                p += 48;
+                i -= 48;
+            } while (i > 48);
+            nSeed ^= nSeed1 ^ nSeed2;
+        }
+        while (i > 16)
+        {
+            nSeed = MulFold(read64(p) ^ kSecret[1], read64(p + 8) ^ nSeed);
+            p += 16;
+            i -= 16;
+        }
+        // the last 16 bytes, overlapping what was already consumed
+        a = read64(p + i - 16);
+        b = read64(p + i - 8);
+    }
+    MulWide(a ^ kSecret[1], b ^ nSeed, a, b);
+    return MulFold(a ^ kSecret[0] ^ nLen, b ^ kSecret[1]);
+}
+
+unsigned long long Hash::ProcessSeed()
+{
+    static const unsigned long long nSeed = [] {
+        std::random_device device;
+        unsigned long long nValue =
+                (static_cast<unsigned long long>(device()) << 32) ^ device();
+        // random_device may be deterministic on some platforms, so stir in
+        // the clock and the address space layout as well
+        nValue ^= static_cast<unsigned long long>(
+                std::chrono::high_resolution_clock::now()
+                        .time_since_epoch()
+                        .count());
+        nValue ^= reinterpret_cast<unsigned long long>(&nValue);
+        return Mix(nValue);
+    }();
+    return nSeed;
+}
+
+}// namespace CPL
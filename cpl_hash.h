@@ -0,0 +1,158 @@
+/**
+ * CPL - Common Portability Library
+ *
+ * Copyright (C) 2024 Merlot.Rain
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include <cpl_exports.h>
+#include <cstddef>
+#include <string_view>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace CPL {
+
+/// \brief Fast 64-bit hash functions for hash tables and fingerprints
+/// \details Byte strings are hashed with a wyhash-style function: 16 or 48 bytes per
+/// step are folded through 64x64->128-bit multiplications, which passes SMHasher and
+/// runs at several GB/s, while short keys take a single multiplication. Hash values
+/// are stable for a given seed across runs and little-endian platforms, so they may
+/// be stored; they are not cryptographic. Tables exposed to untrusted keys should use
+/// Randomized, whose seed is drawn once per process so that colliding keys cannot be
+/// precomputed.
+class CPL_API Hash
+{
+public:
+    /// \brief Hashes a block of bytes
+    /// \param pData The bytes, may be null when nLen is 0
+    /// \param nLen The number of bytes
+    /// \param nSeed The seed, different seeds give independent hash functions
+    /// \return The hash value
+    static unsigned long long Bytes(const void *pData, size_t nLen,
+                                    unsigned long long nSeed = 0);
+
+    /// \brief Hashes a string
+    /// \param str The string
+    /// \param nSeed The seed
+    /// \return The hash value
+    static unsigned long long String(std::string_view str,
+                                     unsigned long long nSeed = 0)
+    {
+        return Bytes(str.data(), str.size(), nSeed);
+    }
+
+    /// \brief Hashes a block of bytes with the per-process random seed
+    /// \details Values differ between runs, which defeats hash-flooding attacks on
+    /// tables keyed by external input.
+    static unsigned long long Randomized(const void *pData, size_t nLen)
+    {
+        return Bytes(pData, nLen, ProcessSeed());
+    }
+
+    /// \brief Returns the random seed used by Randomized, fixed for the process
+    static unsigned long long ProcessSeed();
+
+    /// \brief Mixes the bits of an integer so that every input bit affects every
+    /// output bit
+    /// \details A bijection (the SplitMix64 finalizer), so distinct integers never
+    /// collide; suited to integer keys and pointers.
+    static constexpr unsigned long long Mix(unsigned long long nValue)
+    {
+        nValue ^= nValue >> 30;
+        nValue *= 0xBF58476D1CE4E5B9ULL;
+        nValue ^= nValue >> 27;
+        nValue *= 0x94D049BB133111EBULL;
+        nValue ^= nValue >> 31;
+        return nValue;
+    }
+
+    /// \brief Multiplies two integers to a 128-bit product
+    /// \param a The first factor
+    /// \param b The second factor
+    /// \param nLow Receives the low 64 bits of the product
+    /// \param nHigh Receives the high 64 bits of the product
+    static void MulWide(unsigned long long a, unsigned long long b,
+                        unsigned long long &nLow, unsigned long long &nHigh)
+    {
+#if defined(__SIZEOF_INT128__)
+        unsigned __int128 r = static_cast<unsigned __int128>(a) * b;
+        nLow = static_cast<unsigned long long>(r);
+        nHigh = static_cast<unsigned long long>(r >> 64);
+#elif defined(_MSC_VER) && defined(_M_X64)
+        nLow = _umul128(a, b, &nHigh);
+#else
+        unsigned long long ha = a >> 32, la = a & 0xFFFFFFFFULL;
+        unsigned long long hb = b >> 32, lb = b & 0xFFFFFFFFULL;
+        unsigned long long rh = ha * hb, rm0 = ha * lb, rm1 = hb * la,
+                           rl = la * lb;
+        unsigned long long t = rl + (rm0 << 32);
+        unsigned long long c = t < rl;
+        nLow = t + (rm1 << 32);
+        c += nLow < t;
+        nHigh = rh + (rm0 >> 32) + (rm1 >> 32) + c;
+#endif
+    }
+
+    /// \brief Multiplies two integers to 128 bits and folds the halves together
+    /// \details The core step of the byte hash, a fast non-linear mix of two words.
+    static unsigned long long MulFold(unsigned long long a, unsigned long long b)
+    {
+        unsigned long long nLow, nHigh;
+        MulWide(a, b, nLow, nHigh);
+        return nLow ^ nHigh;
+    }
+
+    /// \brief Combines a hash with the hash of the next field of a composite key
+    /// \details The result depends on the order of the fields.
+    static constexpr unsigned long long Combine(unsigned long long nHash,
+                                                unsigned long long nValue)
+    {
+        return Mix(nHash ^ (Mix(nValue) + 0x9E3779B97F4A7C15ULL + (nHash << 6) +
+                            (nHash >> 2)));
+    }
+};
+
+/// \brief Hash functor for unordered containers keyed by strings
+/// \details Hashes any key convertible to std::string_view with Hash::String. It is
+/// marked transparent; together with StringEqual this lets C++20 unordered containers
+/// keyed by std::string be searched with a std::string_view or a C string. C++17
+/// containers have no such lookup and always convert to the key type.
+struct StringHash
+{
+    using is_transparent = void;
+
+    size_t operator()(std::string_view str) const
+    {
+        return static_cast<size_t>(Hash::String(str));
+    }
+};
+
+/// \brief Transparent equality functor to pair with StringHash
+struct StringEqual
+{
+    using is_transparent = void;
+
+    bool operator()(std::string_view strA, std::string_view strB) const
+    {
+        return strA == strB;
+    }
+};
+
+}// namespace CPL
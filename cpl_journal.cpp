@@ -0,0 +1,328 @@
+/**
+ * CPL - Common Portability Library
+ *
+ * Copyright (C) 2024 Merlot.Rain
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "cpl_journal.h"
+#include <chrono>
+#include <climits>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+#ifdef _WIN32
+#include <fcntl.h>
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+#if defined(__SSE4_2__)
+#include <nmmintrin.h>
+#elif defined(__ARM_FEATURE_CRC32)
+#include <arm_acle.h>
+#endif
+
+namespace CPL {
+
+static const unsigned int JOURNAL_HEADER_SIZE = 8;
+
+static void storeUInt32(unsigned char *p, unsigned int v)
+{
+    p[0] = static_cast<unsigned char>(v);
+    p[1] = static_cast<unsigned char>(v >> 8);
+    p[2] = static_cast<unsigned char>(v >> 16);
+    p[3] = static_cast<unsigned char>(v >> 24);
+}
+
+static unsigned int loadUInt32(const unsigned char *p)
+{
+    return static_cast<unsigned int>(p[0]) |
+           (static_cast<unsigned int>(p[1]) << 8) |
+           (static_cast<unsigned int>(p[2]) << 16) |
+           (static_cast<unsigned int>(p[3]) << 24);
+}
+
+static bool truncateFile(const char *path, unsigned long long nLen)
+{
+#ifdef _WIN32
+    int fd = -1;
+    if (_sopen_s(&fd, path, _O_RDWR | _O_BINARY, _SH_DENYNO, 0) != 0)
+        return false;
+    bool ok = _chsize_s(fd, static_cast<long long>(nLen)) == 0;
+    _close(fd);
+    return ok;
+#else
+    return ::truncate(path, static_cast<off_t>(nLen)) == 0;
+#endif
+}
+
+unsigned int JournalWriter::Crc32C(const void *pData, size_t nLen,
+                                   unsigned int crc)
+{
+    const unsigned char *p = static_cast<const unsigned char *>(pData);
+    crc = ~crc;
+#if defined(__SSE4_2__) && (defined(__x86_64__) || defined(_M_X64))
+    for (; nLen >= 8; nLen -= 8, p += 8)
+    {
+        unsigned long long v;
+        std::memcpy(&v, p, 8);
+        crc = static_cast<unsigned int>(_mm_crc32_u64(crc, v));
+    }
+    for (; nLen; --nLen) crc = _mm_crc32_u8(crc, *p++);
+#elif defined(__ARM_FEATURE_CRC32)
+    for (; nLen >= 8; nLen -= 8, p += 8)
+    {
+        unsigned long long v;
+        std::memcpy(&v, p, 8);
+        crc = __crc32cd(crc, v);
+    }
+    for (; nLen; --nLen) crc = __crc32cb(crc, *p++);
+#else
+    static const struct Table
+    {
+        unsigned int Value[256];
+        Table()
+        {
+            for (unsigned int i = 0; i < 256; ++i)
+            {
+                unsigned int c = i;
+                for (int k = 0; k < 8; ++k)
+                    c = (c & 1) ? (c >> 1) ^ 0x82F63B78u : c >> 1;
+                Value[i] = c;
+            }
+        }
+    } table;
+    for (; nLen; --nLen) crc = table.Value[(crc ^ *p++) & 0xFF] ^ (crc >> 8);
+#endif
+    return ~crc;
+}
+
+/* ------------------------------ JournalWriter ----------------------------- */
+
+/// Rejects record limits that RawRead and RawWrite cannot handle in one call
+static unsigned int checkMaxRecordSize(unsigned int nMaxRecordSize)
+{
+    if (nMaxRecordSize > static_cast<unsigned int>(INT_MAX))
+    {
+        throw std::invalid_argument("MaxRecordSize cannot exceed INT_MAX");
+    }
+    return nMaxRecordSize;
+}
+
+JournalWriter::JournalWriter(const char *path, const JournalOptions &options)
+    : m_pStream(nullptr), m_Options(options)
+{
+    checkMaxRecordSize(m_Options.MaxRecordSize);
+    // Drop a torn tail first, otherwise new records would be appended
+    // behind bytes that readers stop at.
+    FILE *f = std::fopen(path, "rb");
+    if (f)
+    {
+        std::fclose(f);
+        JournalReader reader(path, m_Options.MaxRecordSize);
+        std::string record;
+        while (reader.Next(record)) {}
+        if (reader.TornTail() && !truncateFile(path, reader.ValidLength()))
+        {
+            throw std::runtime_error("Failed to truncate torn journal tail: " +
+                                     std::string(path));
+        }
+    }
+    m_File = new FileOutputStream(path, true, true);
+    m_pStream = m_File.p;
+}
+
+JournalWriter::JournalWriter(OutputStream *stream, const JournalOptions &options)
+    : m_pStream(stream), m_Options(options)
+{
+    if (!m_pStream) { throw std::invalid_argument("stream cannot be null"); }
+    checkMaxRecordSize(m_Options.MaxRecordSize);
+}
+
+JournalWriter::~JournalWriter()
+{
+    std::unique_lock<std::mutex> lock(m_Mutex);
+    while (!m_Pending.empty() && !m_bFailed)
+    {
+        if (!m_bCommitting) Commit(lock);
+        else
+            m_Committed.wait(lock);
+    }
+}
+
+unsigned long long JournalWriter::Append(const unsigned char *pData,
+                                         unsigned int nLen)
+{
+    if (nLen > m_Options.MaxRecordSize)
+    {
+        throw std::length_error("Journal record exceeds MaxRecordSize");
+    }
+    unsigned char header[JOURNAL_HEADER_SIZE];
+    storeUInt32(header, nLen);
+    unsigned int crc = Crc32C(header, 4);
+    storeUInt32(header + 4, Crc32C(pData, nLen, crc));
+
+    std::unique_lock<std::mutex> lock(m_Mutex);
+    if (m_bFailed) { throw std::runtime_error("Journal write failed"); }
+    m_Pending.append(reinterpret_cast<const char *>(header), sizeof(header));
+    m_Pending.append(reinterpret_cast<const char *>(pData), nLen);
+    unsigned long long nSeq = ++m_nNextSeq;
+    if (m_bCommitting) m_Enqueued.notify_one();
+
+    while (m_nDurableSeq < nSeq)
+    {
+        if (m_bFailed) { throw std::runtime_error("Journal write failed"); }
+        if (!m_bCommitting) Commit(lock);
+        else
+            m_Committed.wait(lock);
+    }
+    return nSeq;
+}
+
+unsigned long long JournalWriter::Append(const std::string &record)
+{
+    if (record.size() > m_Options.MaxRecordSize)
+    {
+        throw std::length_error("Journal record exceeds MaxRecordSize");
+    }
+    return Append(reinterpret_cast<const unsigned char *>(record.data()),
+                  static_cast<unsigned int>(record.size()));
+}
+
+JournalStats JournalWriter::Stats()
+{
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    return m_Stats;
+}
+
+void JournalWriter::Commit(std::unique_lock<std::mutex> &lock)
+{
+    m_bCommitting = true;
+    if (m_Options.MaxBatchDelay &&
+        m_Pending.size() < m_Options.MaxBatchBytes)
+    {
+        auto deadline = std::chrono::steady_clock::now() +
+                        std::chrono::microseconds(m_Options.MaxBatchDelay);
+        m_Enqueued.wait_until(lock, deadline, [this] {
+            return m_Pending.size() >= m_Options.MaxBatchBytes;
+        });
+    }
+
+    std::string batch;
+    batch.swap(m_Pending);
+    unsigned long long nLastSeq = m_nNextSeq;
+    unsigned long long nRecords = nLastSeq - m_nDurableSeq;
+    lock.unlock();
+
+    // Records arriving from now on are collected for the next batch.
+    // A batch of several large records can exceed the int range of RawWrite.
+    bool ok = m_pStream->WriteFully(reinterpret_cast<const unsigned char *>(
+                                            batch.data()),
+                                    batch.size()) == batch.size();
+    if (ok)
+        ok = m_Options.Durable && m_File ? m_File->Sync() : m_pStream->Flush();
+
+    lock.lock();
+    m_bCommitting = false;
+    if (ok)
+    {
+        m_nDurableSeq = nLastSeq;
+        m_Stats.Records += nRecords;
+        m_Stats.Bytes += batch.size();
+        ++m_Stats.Batches;
+        if (m_Pending.empty())
+        {
+            // Keep the grown capacity for the next batch.
+            batch.clear();
+            m_Pending.swap(batch);
+        }
+    }
+    else { m_bFailed = true; }
+    m_Committed.notify_all();
+}
+
+/* ------------------------------ JournalReader ----------------------------- */
+
+JournalReader::JournalReader(const char *path, unsigned int nMaxRecordSize)
+    : m_nMaxRecordSize(checkMaxRecordSize(nMaxRecordSize))
+{
+    m_OwnedStream = new FileInputStream(path);
+    m_pStream = m_OwnedStream.p;
+}
+
+JournalReader::JournalReader(InputStream *stream, unsigned int nMaxRecordSize)
+    : m_pStream(stream), m_nMaxRecordSize(checkMaxRecordSize(nMaxRecordSize))
+{
+    if (!m_pStream) { throw std::invalid_argument("stream cannot be null"); }
+}
+
+static unsigned int readFully(InputStream *stream, unsigned char *buff,
+                              unsigned int nLen)
+{
+    unsigned int nRead = 0;
+    while (nRead < nLen)
+    {
+        int n = stream->RawRead(buff + nRead, static_cast<int>(nLen - nRead));
+        if (n <= 0) break;
+        nRead += n;
+    }
+    return nRead;
+}
+
+bool JournalReader::Next(std::string &record)
+{
+    if (m_bEnd) return false;
+
+    unsigned char header[JOURNAL_HEADER_SIZE];
+    unsigned int n = readFully(m_pStream, header, sizeof(header));
+    if (n < sizeof(header))
+    {
+        m_bEnd = true;
+        m_bTornTail = n > 0;
+        return false;
+    }
+
+    unsigned int nLen = loadUInt32(header);
+    if (nLen > m_nMaxRecordSize)
+    {
+        m_bEnd = m_bTornTail = true;
+        return false;
+    }
+
+    record.resize(nLen);
+    unsigned char *p = reinterpret_cast<unsigned char *>(&record[0]);
+    if (readFully(m_pStream, p, nLen) < nLen ||
+        JournalWriter::Crc32C(p, nLen, JournalWriter::Crc32C(header, 4)) !=
+                loadUInt32(header + 4))
+    {
+        record.clear();
+        m_bEnd = m_bTornTail = true;
+        return false;
+    }
+
+    m_nValidLength += sizeof(header) + nLen;
+    return true;
+}
+
+bool JournalReader::TornTail() const { return m_bTornTail; }
+
+unsigned long long JournalReader::ValidLength() const
+{
+    return m_nValidLength;
+}
+
+}// namespace CPL
@@ -0,0 +1,161 @@
+/**
+ * CPL - Common Portability Library
+ *
+ * Copyright (C) 2024 Merlot.Rain
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include "cpl_memorymanager.h"
+#include <condition_variable>
+#include <cpl_exports.h>
+#include <mutex>
+#include <string>
+
+namespace CPL {
+
+/// \brief Tuning knobs for JournalWriter group commit
+struct JournalOptions
+{
+    /// \brief Microseconds the thread committing a batch waits for more records to join it
+    /// \details 0 commits immediately; records arriving during a sync always form the next batch.
+    unsigned int MaxBatchDelay = 0;
+
+    /// \brief Batch size in bytes at which the commit starts without waiting for MaxBatchDelay
+    unsigned int MaxBatchBytes = 1 << 20;
+
+    /// \brief Whether each batch is forced to the storage device with fdatasync
+    bool Durable = true;
+
+    /// \brief Largest record payload in bytes that Append accepts
+    /// \details Opening an existing journal reads it with this limit, and a longer record
+    /// counts as a torn tail. Keep it the same for the life of a journal and pass it to
+    /// JournalReader as well. Values above INT_MAX are rejected with std::invalid_argument.
+    unsigned int MaxRecordSize = 1u << 30;
+};
+
+/// \brief Counters describing the work done by a JournalWriter
+struct JournalStats
+{
+    unsigned long long Records = 0;///< Records appended
+    unsigned long long Bytes = 0;  ///< Bytes written, including record headers
+    unsigned long long Batches = 0;///< Batches written, i.e. syncs issued when durable
+};
+
+/// \brief Append-only journal of length-prefixed, CRC-checked records
+/// \details Each record is stored as a 4-byte little-endian payload length, a 4-byte CRC-32C
+/// over the length and the payload, followed by the payload.
+/// Append may be called from many threads. Records appended while a batch is being written
+/// are collected into the next batch, so one fdatasync makes a whole group durable.
+/// Opening an existing journal truncates a torn tail left by an interrupted write.
+class CPL_API JournalWriter
+{
+    OutputStream *m_pStream;             ///< Stream the batches are written to
+    FileOutputStreamPtr m_File;          ///< Holds the file opened from a path
+    JournalOptions m_Options;            ///< Batching options
+    JournalStats m_Stats;                ///< Counters, guarded by m_Mutex
+    std::mutex m_Mutex;                  ///< Guards all members below
+    std::condition_variable m_Committed; ///< Signals a finished batch
+    std::condition_variable m_Enqueued;  ///< Signals the committing thread about new records
+    std::string m_Pending;               ///< Encoded records waiting for the next batch
+    unsigned long long m_nNextSeq = 0;   ///< Sequence number of the last enqueued record
+    unsigned long long m_nDurableSeq = 0;///< Sequence number of the last committed record
+    bool m_bCommitting = false;          ///< Whether a thread is writing a batch
+    bool m_bFailed = false;              ///< Whether a batch failed to be written
+
+public:
+    /// \brief Opens or creates a journal file for appending
+    /// \param path The path of the journal file
+    /// \param options Group commit options
+    JournalWriter(const char *path, const JournalOptions &options = JournalOptions());
+
+    /// \brief Appends records to a stream positioned behind the existing records
+    /// \details No torn tail is recovered. Batches are flushed rather than synced, since
+    /// JournalOptions::Durable only applies to files.
+    /// \param stream The output stream, which must outlive the writer
+    /// \param options Group commit options
+    JournalWriter(OutputStream *stream, const JournalOptions &options = JournalOptions());
+
+    /// \brief Commits pending records and closes the file
+    ~JournalWriter();
+
+    CPL_DISABLE_COPY(JournalWriter)
+
+    /// \brief Appends a record and waits until it is committed
+    /// \details Throws std::length_error if nLen exceeds JournalOptions::MaxRecordSize and
+    /// std::runtime_error if the batch holding the record cannot be written.
+    /// \param pData Pointer to the record payload
+    /// \param nLen Length of the payload in bytes
+    /// \return The sequence number of the record, starting at 1
+    unsigned long long Append(const unsigned char *pData, unsigned int nLen);
+
+    /// \brief Appends a record and waits until it is committed
+    /// \param record The record payload
+    /// \return The sequence number of the record, starting at 1
+    unsigned long long Append(const std::string &record);
+
+    /// \brief Returns a snapshot of the writer counters
+    JournalStats Stats();
+
+    /// \brief Computes the CRC-32C (Castagnoli) checksum used by journal records
+    /// \param pData Pointer to the data
+    /// \param nLen Length of the data in bytes
+    /// \param crc The checksum of the preceding data, 0 to start
+    /// \return The updated checksum
+    static unsigned int Crc32C(const void *pData, size_t nLen,
+                               unsigned int crc = 0);
+
+private:
+    void Commit(std::unique_lock<std::mutex> &lock);
+};
+
+/// \brief Sequential reader for files written by JournalWriter
+/// \details Reading stops at the first incomplete or corrupted record, which is how a
+/// torn tail from an interrupted write appears.
+class CPL_API JournalReader
+{
+    InputStream *m_pStream;               ///< Stream the records are read from
+    InputStreamPtr m_OwnedStream;         ///< Holds the stream opened from a path
+    unsigned long long m_nValidLength = 0;///< Bytes covered by the records read so far
+    unsigned int m_nMaxRecordSize;        ///< Length above which a header is treated as corrupt
+    bool m_bTornTail = false;             ///< Whether reading stopped at a damaged record
+    bool m_bEnd = false;                  ///< Whether the end of the journal was reached
+
+public:
+    /// \brief Reads the journal from a file
+    /// \param path The path of the journal file
+    /// \param nMaxRecordSize Largest record length accepted as valid, at most INT_MAX
+    JournalReader(const char *path, unsigned int nMaxRecordSize = 1u << 30);
+
+    /// \brief Reads the journal from a stream positioned at the first record
+    /// \param stream The input stream
+    /// \param nMaxRecordSize Largest record length accepted as valid, at most INT_MAX
+    JournalReader(InputStream *stream, unsigned int nMaxRecordSize = 1u << 30);
+
+    /// \brief Reads the next record
+    /// \param record Receives the record payload
+    /// \return True if a valid record was read, false at the end of the journal
+    bool Next(std::string &record);
+
+    /// \brief Checks whether reading stopped at an incomplete or corrupted record
+    bool TornTail() const;
+
+    /// \brief Length of the journal prefix made of valid records read so far
+    unsigned long long ValidLength() const;
+};
+
+}// namespace CPL
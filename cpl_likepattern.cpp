@@ -0,0 +1,268 @@
+/**
+ * CPL - Common Portability Library
+ *
+ * Copyright (C) 2024 Merlot.Rain
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "cpl_likepattern.h"
+#include <algorithm>
+#include <cstring>
+
+namespace CPL {
+
+LikePattern::LikePattern(std::string_view pattern, char chEscape)
+{
+    size_t nPercents = 0;
+    m_Segments.emplace_back();
+    for (size_t i = 0; i < pattern.size(); ++i)
+    {
+        Segment &seg = m_Segments.back();
+        char c = pattern[i];
+        if (chEscape && c == chEscape && i + 1 < pattern.size()) { c = pattern[++i]; }
+        else if (c == '%')
+        {
+            ++nPercents;
+            m_Segments.emplace_back();
+            continue;
+        }
+        else if (c == '_')
+        {
+            if (seg.Any.empty()) seg.Any.assign(seg.Text.size(), 0);
+            seg.Text += '\0';
+            seg.Any.push_back(1);
+            continue;
+        }
+        seg.Text += c;
+        if (!seg.Any.empty()) seg.Any.push_back(0);
+    }
+
+    if (nPercents > 0)
+    {
+        // Leading and trailing empty segments only mean the ends are free;
+        // empty inner segments come from repeated '%' and match trivially.
+        m_bAnchorStart = !m_Segments.front().Text.empty();
+        m_bAnchorEnd = !m_Segments.back().Text.empty();
+        m_Segments.erase(std::remove_if(m_Segments.begin(), m_Segments.end(),
+                                        [](const Segment &seg) {
+                                            return seg.Text.empty();
+                                        }),
+                         m_Segments.end());
+        if (m_Segments.empty()) m_Segments.emplace_back();
+    }
+
+    bool bHasAny = false;
+    for (const Segment &seg: m_Segments)
+    {
+        bHasAny |= !seg.Any.empty();
+        m_nMinLength += seg.Text.size();
+    }
+
+    if (bHasAny) { m_Kind = LikeKind::eGeneral; }
+    else if (nPercents == 0) { m_Kind = LikeKind::eExact; }
+    else if (m_Segments.size() == 1)
+    {
+        if (m_bAnchorStart) m_Kind = LikeKind::ePrefix;
+        else if (m_bAnchorEnd)
+            m_Kind = LikeKind::eSuffix;
+        else
+            m_Kind = LikeKind::eContains;
+    }
+    Build();
+}
+
+LikePattern::LikePattern(const LikePattern &rhs)
+    : m_Kind(rhs.m_Kind), m_Segments(rhs.m_Segments),
+      m_bAnchorStart(rhs.m_bAnchorStart), m_bAnchorEnd(rhs.m_bAnchorEnd),
+      m_nMinLength(rhs.m_nMinLength)
+{
+    Build();
+}
+
+LikePattern &LikePattern::operator=(const LikePattern &rhs)
+{
+    if (this != &rhs)
+    {
+        m_Kind = rhs.m_Kind;
+        m_Segments = rhs.m_Segments;
+        m_bAnchorStart = rhs.m_bAnchorStart;
+        m_bAnchorEnd = rhs.m_bAnchorEnd;
+        m_nMinLength = rhs.m_nMinLength;
+        Build();
+    }
+    return *this;
+}
+
+void LikePattern::Build()
+{
+    // Searchers reference the segment text, so they are rebuilt whenever the
+    // segments are copied.
+    m_Searchers.clear();
+    m_Searchers.reserve(m_Segments.size());
+    for (const Segment &seg: m_Segments)
+    {
+        m_Searchers.emplace_back(seg.Any.empty() ? std::string_view(seg.Text)
+                                                 : std::string_view());
+    }
+}
+
+LikePattern::LikeKind LikePattern::Kind() const { return m_Kind; }
+
+bool LikePattern::SegmentAt(const Segment &seg, const char *p)
+{
+    if (seg.Any.empty())
+        return std::memcmp(p, seg.Text.data(), seg.Text.size()) == 0;
+    for (size_t i = 0; i < seg.Text.size(); ++i)
+    {
+        if (!seg.Any[i] && p[i] != seg.Text[i]) return false;
+    }
+    return true;
+}
+
+size_t LikePattern::FindSegment(size_t nIndex, std::string_view str,
+                                size_t nFrom) const
+{
+    const Segment &seg = m_Segments[nIndex];
+    if (seg.Any.empty()) return m_Searchers[nIndex].Find(str, nFrom);
+    for (size_t p = nFrom; p + seg.Text.size() <= str.size(); ++p)
+    {
+        if (SegmentAt(seg, str.data() + p)) return p;
+    }
+    return std::string_view::npos;
+}
+
+bool LikePattern::MatchGeneral(std::string_view str) const
+{
+    if (str.size() < m_nMinLength) return false;
+    if (m_bAnchorStart && m_bAnchorEnd && m_Segments.size() == 1)
+    {
+        return str.size() == m_nMinLength && SegmentAt(m_Segments[0], str.data());
+    }
+
+    size_t nFirst = 0;
+    size_t nLast = m_Segments.size();
+    size_t nPos = 0;
+    size_t nEnd = str.size();
+    if (m_bAnchorStart)
+    {
+        if (!SegmentAt(m_Segments[0], str.data())) return false;
+        nPos = m_Segments[0].Text.size();
+        ++nFirst;
+    }
+    if (m_bAnchorEnd)
+    {
+        const Segment &seg = m_Segments[nLast - 1];
+        if (nEnd - nPos < seg.Text.size() ||
+            !SegmentAt(seg, str.data() + nEnd - seg.Text.size()))
+            return false;
+        nEnd -= seg.Text.size();
+        --nLast;
+    }
+
+    // Between '%' the leftmost occurrence of each segment leaves the most
+    // room for the following ones, so no backtracking is needed.
+    std::string_view body = str.substr(0, nEnd);
+    for (size_t i = nFirst; i < nLast; ++i)
+    {
+        size_t nHit = FindSegment(i, body, nPos);
+        if (nHit == std::string_view::npos) return false;
+        nPos = nHit + m_Segments[i].Text.size();
+    }
+    return true;
+}
+
+bool LikePattern::Match(std::string_view str) const
+{
+    const std::string &lit = m_Segments[0].Text;
+    switch (m_Kind)
+    {
+        case LikeKind::eExact:
+            return str.size() == lit.size() &&
+                   std::memcmp(str.data(), lit.data(), lit.size()) == 0;
+        case LikeKind::ePrefix:
+            return str.size() >= lit.size() &&
+                   std::memcmp(str.data(), lit.data(), lit.size()) == 0;
+        case LikeKind::eSuffix:
+            return str.size() >= lit.size() &&
+                   std::memcmp(str.data() + str.size() - lit.size(),
+                               lit.data(), lit.size()) == 0;
+        case LikeKind::eContains:
+            return m_Searchers[0].Find(str) != std::string_view::npos;
+        default:
+            return MatchGeneral(str);
+    }
+}
+
+/// Evaluates a predicate over all strings, assembling each bitmap word in a
+/// register before storing it.
+template<class Pred>
+static size_t fillBitmap(const std::string_view *strs, size_t nCount,
+                         unsigned long long *bitmap, Pred pred)
+{
+    size_t nMatches = 0;
+    for (size_t nBase = 0; nBase < nCount; nBase += 64)
+    {
+        size_t nBlock = std::min<size_t>(64, nCount - nBase);
+        unsigned long long word = 0;
+        for (size_t i = 0; i < nBlock; ++i)
+            word |= static_cast<unsigned long long>(pred(strs[nBase + i])) << i;
+        bitmap[nBase / 64] = word;
+#if defined(__GNUC__)
+        nMatches += __builtin_popcountll(word);
+#else
+        for (; word; word &= word - 1) ++nMatches;
+#endif
+    }
+    return nMatches;
+}
+
+size_t LikePattern::MatchAll(const std::string_view *strs, size_t nCount,
+                             unsigned long long *bitmap) const
+{
+    // Dispatch once per batch so each loop body is a single specialized test.
+    const std::string &lit = m_Segments[0].Text;
+    const char *pLit = lit.data();
+    const size_t nLit = lit.size();
+    switch (m_Kind)
+    {
+        case LikeKind::eExact:
+            return fillBitmap(strs, nCount, bitmap, [=](std::string_view s) {
+                return s.size() == nLit && std::memcmp(s.data(), pLit, nLit) == 0;
+            });
+        case LikeKind::ePrefix:
+            return fillBitmap(strs, nCount, bitmap, [=](std::string_view s) {
+                return s.size() >= nLit && std::memcmp(s.data(), pLit, nLit) == 0;
+            });
+        case LikeKind::eSuffix:
+            return fillBitmap(strs, nCount, bitmap, [=](std::string_view s) {
+                return s.size() >= nLit &&
+                       std::memcmp(s.data() + s.size() - nLit, pLit, nLit) == 0;
+            });
+        case LikeKind::eContains:
+        {
+            const Searcher &searcher = m_Searchers[0];
+            return fillBitmap(strs, nCount, bitmap, [&](std::string_view s) {
+                return searcher.Find(s) != std::string_view::npos;
+            });
+        }
+        default:
+            return fillBitmap(strs, nCount, bitmap, [this](std::string_view s) {
+                return MatchGeneral(s);
+            });
+    }
+}
+
+}// namespace CPL
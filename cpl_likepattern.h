@@ -0,0 +1,97 @@
+/**
+ * CPL - Common Portability Library
+ *
+ * Copyright (C) 2024 Merlot.Rain
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include "cpl_searcher.h"
+#include <cpl_exports.h>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace CPL {
+
+/// \brief Precompiled SQL LIKE pattern
+/// \details `%` matches any sequence of bytes, including none, and `_` matches exactly one
+/// byte; the escape character makes the following character literal. The pattern is
+/// parsed once and classified, so the common shapes run as a single comparison or
+/// substring search and only mixed patterns use the general segment matcher.
+/// Matching is case-sensitive and byte-based, independent of the text encoding.
+class CPL_API LikePattern
+{
+public:
+    /// \brief Shape of a parsed pattern
+    enum class LikeKind : int
+    {
+        eExact,   ///< No wildcard, e.g. `abc`
+        ePrefix,  ///< Literal followed by `%`, e.g. `abc%`
+        eSuffix,  ///< `%` followed by a literal, e.g. `%abc`
+        eContains,///< Literal between two `%`, e.g. `%abc%`, or `%` alone
+        eGeneral, ///< Any other mix of literals, `%` and `_`
+    };
+
+    /// \brief Parses a pattern
+    /// \param pattern The LIKE pattern
+    /// \param chEscape The escape character, '\0' for none
+    explicit LikePattern(std::string_view pattern, char chEscape = '\0');
+
+    /// \brief Copy constructor
+    LikePattern(const LikePattern &rhs);
+
+    /// \brief Copy assignment operator
+    LikePattern &operator=(const LikePattern &rhs);
+
+    /// \brief The shape the pattern was classified as
+    LikeKind Kind() const;
+
+    /// \brief Checks whether a string matches the pattern
+    bool Match(std::string_view str) const;
+
+    /// \brief Matches many strings at once
+    /// \param strs The strings to match
+    /// \param nCount Number of strings
+    /// \param bitmap Receives one bit per string, bit i % 64 of word i / 64 is set when
+    /// string i matches; must hold (nCount + 63) / 64 words
+    /// \return The number of matching strings
+    size_t MatchAll(const std::string_view *strs, size_t nCount,
+                    unsigned long long *bitmap) const;
+
+private:
+    /// \brief Text between two `%`, where `_` positions are marked in Any
+    struct Segment
+    {
+        std::string Text;             ///< Literal bytes, `_` positions hold a placeholder
+        std::vector<unsigned char> Any;///< 1 for each `_` position, empty if there is none
+    };
+
+    void Build();
+    bool MatchGeneral(std::string_view str) const;
+    static bool SegmentAt(const Segment &seg, const char *p);
+    size_t FindSegment(size_t nIndex, std::string_view str, size_t nFrom) const;
+
+    LikeKind m_Kind = LikeKind::eGeneral;
+    std::vector<Segment> m_Segments;///< Segments in pattern order
+    std::vector<Searcher> m_Searchers;///< Searcher for each segment without `_`
+    bool m_bAnchorStart = true;     ///< The pattern does not start with `%`
+    bool m_bAnchorEnd = true;       ///< The pattern does not end with `%`
+    size_t m_nMinLength = 0;        ///< Sum of the segment lengths
+};
+
+}// namespace CPL
@@ -19,6 +19,7 @@
  */
 
 #include "cpl_mathhelp.h"
+#include "cpl_hash.h"
 #include <float.h>
 #include <iomanip>
 #include <math.h>
@@ -80,6 +81,8 @@ void Guid::Swap(Guid &guid)
     std::memcpy(guid.Data, temp, 16);
 }
 
+unsigned long long Guid::HashCode() const { return Hash::Bytes(Data, 16); }
+
 std::string Guid::ToString(Format formatType) const
 {
     std::ostringstream oss;
@@ -21,6 +21,7 @@
 #pragma once
 
 #include <cpl_exports.h>
+#include <functional>
 #include <string>
 
 namespace CPL {
@@ -100,6 +101,10 @@ public:
     /// \details Swaps the contents of the current GUID with the provided GUID.
     void Swap(Guid &guid);
 
+    /// \brief Calculates the hash code of the GUID
+    /// \return A hash of the 16 bytes, see Hash::Bytes
+    unsigned long long HashCode() const;
+
     /// \brief Converts the GUID to a formatted string
     /// \param formatType The format in which to return the string
     /// \return A string representing the GUID in the specified format
@@ -425,4 +430,15 @@ public:
     double NextDouble();
 };
 
-}// namespace CPL
\ No newline at end of file
+}// namespace CPL
+
+namespace std {
+template<>
+struct hash<CPL::Guid>
+{
+    size_t operator()(const CPL::Guid &guid) const
+    {
+        return static_cast<size_t>(guid.HashCode());
+    }
+};
+}// namespace std
@@ -19,6 +19,21 @@
  */
 
 #include <cpl_memorymanager.h>
+#include "cpl_codec.h"
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <climits>
+#include <stdexcept>
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <sys/uio.h>
+#include <unistd.h>
+#endif
+#ifdef __linux__
+#include <sys/mman.h>
+#endif
 
 namespace CPL {
 
@@ -79,87 +94,12 @@ unsigned char *ByteBuffer::EndPtr() const { return Ptr() + BufferSize(); }
 
 std::string ByteBuffer::ToBase64() const
 {
-    static const char encode_table[] =
-            "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
-    std::ostringstream oss;
-
-    unsigned char *data = Ptr();
-    unsigned int size = BufferSize();
-    int padding = (3 - size % 3) % 3;// Calculate the padding needed
-    size_t length = size + padding;
-
-    // Process the buffer in chunks of 3 bytes
-    for (size_t i = 0; i < length; i += 3)
-    {
-        unsigned char b0 = i < size ? data[i] : 0;
-        unsigned char b1 = i + 1 < size ? data[i + 1] : 0;
-        unsigned char b2 = i + 2 < size ? data[i + 2] : 0;
-
-        oss.put(encode_table[(b0 >> 2) & 0x3F]);
-        oss.put(encode_table[((b0 << 4) | (b1 >> 4)) & 0x3F]);
-        oss.put(encode_table[((b1 << 2) | (b2 >> 6)) & 0x3F]);
-        oss.put(encode_table[b2 & 0x3F]);
-    }
-
-    // Add padding if needed
-    for (int i = 0; i < padding; ++i) { oss.put('='); }
-
-    return oss.str();
+    return Base64::Encode(Ptr(), BufferSize());
 }
 
 bool ByteBuffer::FromBase64(const char *strBase64)
 {
-    static const unsigned char decode_table[256] = {
-            // Initialize the decode table with values for each Base64 character
-            0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
-            0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
-            0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
-            0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
-            0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
-            0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
-            0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
-            0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
-            0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
-            0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
-            0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
-            0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF};
-
-    size_t length = strlen(strBase64);
-    size_t padding = 0;
-
-    // Count the number of padding characters
-    if (length > 0 && strBase64[length - 1] == '=')
-    {
-        padding++;
-        if (strBase64[length - 2] == '=') { padding++; }
-    }
-
-    // Calculate the size of the decoded buffer
-    size_t decoded_size = (length * 3) / 4 - padding;
-    unsigned char *decoded_buffer = Allocate(decoded_size);
-
-    size_t idx = 0;
-    for (size_t i = 0; i < length; i += 4)
-    {
-        unsigned char c0 = decode_table[(unsigned char) strBase64[i]];
-        unsigned char c1 = decode_table[(unsigned char) strBase64[i + 1]];
-        unsigned char c2 = decode_table[(unsigned char) strBase64[i + 2]];
-        unsigned char c3 = decode_table[(unsigned char) strBase64[i + 3]];
-
-        if (c0 == 0xFF || c1 == 0xFF || c2 == 0xFF || c3 == 0xFF)
-        {
-            return false;
-        }
-
-        decoded_buffer[idx++] = (c0 << 2) | (c1 >> 4);
-        if (idx < decoded_size)
-        {
-            decoded_buffer[idx++] = (c1 << 4) | (c2 >> 2);
-        }
-        if (idx < decoded_size) { decoded_buffer[idx++] = (c2 << 6) | c3; }
-    }
-
-    return true;
+    return strBase64 && Base64::Decode(strBase64, this);
 }
 
 bool ByteBuffer::IsBase64(const char *strBase64)
@@ -402,6 +342,220 @@ GrowByteBuffer &GrowByteBuffer::operator=(GrowByteBuffer &&rhs) noexcept
 }
 
 
+static std::atomic<size_t> s_nHugePageThreshold{LargeByteBuffer::HugePageSize};
+static std::atomic<unsigned long long> s_nHugePageAllocations{0};
+static std::atomic<unsigned long long> s_nRegularAllocations{0};
+
+static unsigned char *allocateLarge(size_t nLen, size_t &nMapped)
+{
+    nMapped = 0;
+#ifdef __linux__
+    if (nLen && nLen >= s_nHugePageThreshold.load(std::memory_order_relaxed))
+    {
+        const size_t nPage = LargeByteBuffer::HugePageSize;
+        size_t nRounded = (nLen + nPage - 1) & ~(nPage - 1);
+#ifdef CPL_USE_HUGETLB
+        void *pHuge = mmap(nullptr, nRounded, PROT_READ | PROT_WRITE,
+                           MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        if (pHuge != MAP_FAILED)
+        {
+            nMapped = nRounded;
+            s_nHugePageAllocations.fetch_add(1, std::memory_order_relaxed);
+            return static_cast<unsigned char *>(pHuge);
+        }
+#endif
+        // Over-map by one huge page, then trim both ends so the block
+        // starts on a huge page boundary.
+        size_t nSpan = nRounded + nPage;
+        void *p = mmap(nullptr, nSpan, PROT_READ | PROT_WRITE,
+                       MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (p != MAP_FAILED)
+        {
+            uintptr_t nBase = reinterpret_cast<uintptr_t>(p);
+            uintptr_t nAligned = (nBase + nPage - 1) & ~(nPage - 1);
+            if (nAligned > nBase) munmap(p, nAligned - nBase);
+            size_t nTail = nBase + nSpan - (nAligned + nRounded);
+            if (nTail) munmap(reinterpret_cast<void *>(nAligned + nRounded), nTail);
+#ifdef MADV_HUGEPAGE
+            madvise(reinterpret_cast<void *>(nAligned), nRounded, MADV_HUGEPAGE);
+#endif
+            nMapped = nRounded;
+            s_nHugePageAllocations.fetch_add(1, std::memory_order_relaxed);
+            return reinterpret_cast<unsigned char *>(nAligned);
+        }
+    }
+#endif
+    s_nRegularAllocations.fetch_add(1, std::memory_order_relaxed);
+    return new unsigned char[nLen];
+}
+
+static void freeLarge(unsigned char *p, size_t nMapped)
+{
+    if (!p) return;
+#ifdef __linux__
+    if (nMapped)
+    {
+        munmap(p, nMapped);
+        return;
+    }
+#endif
+    delete[] p;
+}
+
+/// Returns the data length after adding nLen bytes to nReal bytes
+static unsigned int grownLength(unsigned int nReal, int nLen)
+{
+    if (nLen < 0 || static_cast<unsigned int>(nLen) > UINT_MAX - nReal)
+        throw std::length_error("LargeByteBuffer: length out of range");
+    return nReal + static_cast<unsigned int>(nLen);
+}
+
+LargeByteBuffer::LargeByteBuffer(unsigned int nLen)
+{
+    if (nLen) Reserve(nLen, 0);
+}
+
+LargeByteBuffer::LargeByteBuffer(LargeByteBuffer &&rhs) noexcept
+    : m_pData(rhs.m_pData), m_nMapped(rhs.m_nMapped), m_nSize(rhs.m_nSize),
+      m_nReal(rhs.m_nReal)
+{
+    rhs.m_pData = nullptr;
+    rhs.m_nMapped = 0;
+    rhs.m_nSize = rhs.m_nReal = 0;
+}
+
+LargeByteBuffer &LargeByteBuffer::operator=(LargeByteBuffer &&rhs) noexcept
+{
+    if (this != &rhs)
+    {
+        freeLarge(m_pData, m_nMapped);
+        m_pData = rhs.m_pData;
+        m_nMapped = rhs.m_nMapped;
+        m_nSize = rhs.m_nSize;
+        m_nReal = rhs.m_nReal;
+        rhs.m_pData = nullptr;
+        rhs.m_nMapped = 0;
+        rhs.m_nSize = rhs.m_nReal = 0;
+    }
+    return *this;
+}
+
+LargeByteBuffer::~LargeByteBuffer() { freeLarge(m_pData, m_nMapped); }
+
+void LargeByteBuffer::Reserve(unsigned int nLen, unsigned int nKeep)
+{
+    size_t nMapped = 0;
+    unsigned char *pData = allocateLarge(nLen, nMapped);
+    if (nKeep) std::memcpy(pData, m_pData, nKeep);
+    freeLarge(m_pData, m_nMapped);
+    m_pData = pData;
+    m_nMapped = nMapped;
+    // A mapping is rounded up to whole huge pages; use all of it.
+    m_nSize = nMapped ? static_cast<unsigned int>(
+                                std::min<size_t>(nMapped, UINT_MAX))
+                      : nLen;
+}
+
+bool LargeByteBuffer::IsHugePageBacked() const { return m_nMapped != 0; }
+
+unsigned int LargeByteBuffer::RealSize() const { return m_nReal; }
+
+unsigned char *LargeByteBuffer::Ptr() const { return m_pData; }
+
+unsigned char *LargeByteBuffer::BufferHead() const { return m_pData; }
+
+unsigned int LargeByteBuffer::BufferSize() const { return m_nSize; }
+
+unsigned char *LargeByteBuffer::SetBufferValue(int nValue)
+{
+    if (m_nReal) std::memset(m_pData, nValue, m_nReal);
+    return Ptr();
+}
+
+unsigned char *LargeByteBuffer::Append(const unsigned char *pBuff, int nLen)
+{
+    unsigned int nNewReal = grownLength(m_nReal, nLen);
+    if (nNewReal > m_nSize)
+    {
+        unsigned long long newSize = nNewReal * 2ULL;
+        Reserve(static_cast<unsigned int>(
+                        std::min<unsigned long long>(newSize, UINT_MAX)),
+                m_nReal);
+    }
+    std::memcpy(m_pData + m_nReal, pBuff, nLen);
+    m_nReal += nLen;
+    return Ptr();
+}
+
+unsigned char *LargeByteBuffer::Append(const char *pStr)
+{
+    return Append(reinterpret_cast<const unsigned char *>(pStr),
+                  std::strlen(pStr));
+}
+
+unsigned char *LargeByteBuffer::Insert(unsigned int nPos,
+                                       const unsigned char *pStr, int nLen)
+{
+    if (nPos > m_nReal) { return nullptr; }
+    unsigned int nNewReal = grownLength(m_nReal, nLen);
+    if (nNewReal > m_nSize)
+    {
+        unsigned long long newSize = nNewReal * 2ULL;
+        Reserve(static_cast<unsigned int>(
+                        std::min<unsigned long long>(newSize, UINT_MAX)),
+                m_nReal);
+    }
+    std::memmove(m_pData + nPos + nLen, m_pData + nPos, m_nReal - nPos);
+    std::memcpy(m_pData + nPos, pStr, nLen);
+    m_nReal += nLen;
+    return Ptr();
+}
+
+unsigned char *LargeByteBuffer::Allocate(unsigned int nLen)
+{
+    if (nLen > m_nSize) Reserve(nLen, m_nReal);
+    m_nReal = nLen;
+    return Ptr();
+}
+
+void LargeByteBuffer::Clear() { m_nReal = 0; }
+
+void LargeByteBuffer::Reset()
+{
+    freeLarge(m_pData, m_nMapped);
+    m_pData = nullptr;
+    m_nMapped = 0;
+    m_nSize = m_nReal = 0;
+}
+
+unsigned char *LargeByteBuffer::Copy(const unsigned char *pBuff, int nLen)
+{
+    if (static_cast<unsigned int>(nLen) > m_nSize) Reserve(nLen, 0);
+    std::memcpy(m_pData, pBuff, nLen);
+    m_nReal = nLen;
+    return Ptr();
+}
+
+size_t LargeByteBuffer::HugePageThreshold()
+{
+    return s_nHugePageThreshold.load(std::memory_order_relaxed);
+}
+
+void LargeByteBuffer::SetHugePageThreshold(size_t nBytes)
+{
+    s_nHugePageThreshold.store(nBytes, std::memory_order_relaxed);
+}
+
+unsigned long long LargeByteBuffer::HugePageAllocations()
+{
+    return s_nHugePageAllocations.load(std::memory_order_relaxed);
+}
+
+unsigned long long LargeByteBuffer::RegularAllocations()
+{
+    return s_nRegularAllocations.load(std::memory_order_relaxed);
+}
+
 InputStream::~InputStream() {}
 
 InputStream::InputStream() : m_nCapability(0) {}
@@ -786,6 +940,20 @@ bool OutputStream::Close()
     return true;
 }
 
+long long OutputStream::RawWriteV(const IoVec *vec, int nCount)
+{
+    long long nTotal = 0;
+    for (int i = 0; i < nCount; ++i)
+    {
+        if (vec[i].Length == 0) continue;
+        int n = RawWrite(vec[i].Data, static_cast<int>(vec[i].Length));
+        if (n <= 0) break;
+        nTotal += n;
+        if (n < static_cast<int>(vec[i].Length)) break;
+    }
+    return nTotal;
+}
+
 int OutputStream::WriteString(const char *str, int nLen)
 {
     if (nLen < 0) { nLen = std::strlen(str); }
@@ -803,6 +971,20 @@ int OutputStream::WriteBuffer(const ByteBuffer *buff)
     return RawWrite(buff->BufferHead(), static_cast<int>(buff->BufferSize()));
 }
 
+size_t OutputStream::WriteFully(const unsigned char *buff, size_t nLen)
+{
+    size_t nWritten = 0;
+    while (nWritten < nLen)
+    {
+        int nChunk = static_cast<int>(
+                std::min<size_t>(nLen - nWritten, INT_MAX));
+        int n = RawWrite(buff + nWritten, nChunk);
+        if (n <= 0) break;
+        nWritten += static_cast<size_t>(std::min(n, nChunk));
+    }
+    return nWritten;
+}
+
 
 MemoryOutputStream::MemoryOutputStream()
 {
@@ -944,6 +1126,57 @@ int FileOutputStream::RawWrite(const unsigned char *buff, int nLen)
     return static_cast<int>(std::fwrite(buff, 1, nLen, m_pFile));
 }
 
+long long FileOutputStream::RawWriteV(const IoVec *vec, int nCount)
+{
+    if (!m_pFile) { throw std::runtime_error("File not open"); }
+#ifdef _WIN32
+    return OutputStream::RawWriteV(vec, nCount);
+#else
+    // Buffered bytes must reach the descriptor before the gathered blocks.
+    if (std::fflush(m_pFile) != 0) { return 0; }
+
+    int fd = fileno(m_pFile);
+    long long nTotal = 0;
+    struct iovec iov[64];
+    int nIndex = 0;
+    unsigned int nSkip = 0;// bytes of vec[nIndex] already written
+    while (nIndex < nCount)
+    {
+        int nBatch = 0;
+        for (int i = nIndex; i < nCount && nBatch < 64; ++i)
+        {
+            unsigned int nOffset = (i == nIndex) ? nSkip : 0;
+            if (vec[i].Length <= nOffset) continue;
+            iov[nBatch].iov_base =
+                    const_cast<unsigned char *>(vec[i].Data) + nOffset;
+            iov[nBatch].iov_len = vec[i].Length - nOffset;
+            ++nBatch;
+        }
+        if (nBatch == 0) break;
+
+        ssize_t n = ::writev(fd, iov, nBatch);
+        // Nothing accepted while bytes are pending would never advance.
+        if (n <= 0)
+        {
+            if (n < 0 && errno == EINTR) continue;
+            break;
+        }
+        nTotal += n;
+
+        // Advance the cursor past the bytes the kernel accepted.
+        size_t nLeft = static_cast<size_t>(n);
+        while (nIndex < nCount && nLeft >= vec[nIndex].Length - nSkip)
+        {
+            nLeft -= vec[nIndex].Length - nSkip;
+            nSkip = 0;
+            ++nIndex;
+        }
+        nSkip += static_cast<unsigned int>(nLeft);
+    }
+    return nTotal;
+#endif
+}
+
 unsigned long long FileOutputStream::Offset() const
 {
     if (!m_pFile) { throw std::runtime_error("File not open"); }
@@ -978,4 +1211,22 @@ bool FileOutputStream::Seek(int offset, StreamSeekOrigin origin)
     return std::fseek(m_pFile, offset, whence) == 0;
 }
 
-}// namespace CPL
\ No newline at end of file
+bool FileOutputStream::Flush()
+{
+    if (!m_pFile) { return false; }
+    return std::fflush(m_pFile) == 0;
+}
+
+bool FileOutputStream::Sync()
+{
+    if (!Flush()) { return false; }
+#ifdef _WIN32
+    return _commit(_fileno(m_pFile)) == 0;
+#elif defined(__APPLE__)
+    return fsync(fileno(m_pFile)) == 0;
+#else
+    return fdatasync(fileno(m_pFile)) == 0;
+#endif
+}
+
+}// namespace CPL
@@ -366,6 +366,73 @@ public:
     GrowByteBuffer &operator=(GrowByteBuffer &&rsh) noexcept;
 };
 
+/// \brief Growing memory block for large data, backed by huge pages where available
+/// \details Blocks of at least HugePageThreshold() bytes are mapped with mmap, aligned to
+/// HugePageSize and advised with MADV_HUGEPAGE so the kernel backs them with transparent
+/// huge pages; when built with CPL_USE_HUGETLB, explicit MAP_HUGETLB pages are tried first.
+/// Smaller blocks, and platforms without huge page support, use regular heap memory.
+class CPL_API LargeByteBuffer : public ByteBuffer
+{
+    unsigned char *m_pData = nullptr;///< Pointer to the memory block
+    size_t m_nMapped = 0;            ///< Mapped length, 0 if the block is heap memory
+    unsigned int m_nSize = 0;        ///< Allocated size of the block in bytes
+    unsigned int m_nReal = 0;        ///< Used size of the block in bytes
+
+public:
+    /// \brief Alignment and rounding granularity of huge page backed blocks
+    static constexpr size_t HugePageSize = 2 * 1024 * 1024;
+
+    /// \brief Constructor with optional initial buffer size
+    /// \param nLen Initial buffer size in bytes (default is 0)
+    explicit LargeByteBuffer(unsigned int nLen = 0);
+
+    /// \brief Move constructor
+    LargeByteBuffer(LargeByteBuffer &&rhs) noexcept;
+
+    /// \brief Move assignment operator
+    LargeByteBuffer &operator=(LargeByteBuffer &&rhs) noexcept;
+
+    /// \brief Destructor, releases the memory block
+    virtual ~LargeByteBuffer();
+
+    CPL_DISABLE_COPY(LargeByteBuffer)
+
+    /// \brief Checks whether the current block was allocated on the huge page path
+    bool IsHugePageBacked() const;
+
+    /// \brief Returns the actual size of the buffer used
+    unsigned int RealSize() const;
+
+    virtual unsigned char *Ptr() const;
+    virtual unsigned char *BufferHead() const;
+    virtual unsigned int BufferSize() const;
+    virtual unsigned char *SetBufferValue(int nValue);
+    virtual unsigned char *Append(const unsigned char *pBuff, int nLen);
+    virtual unsigned char *Append(const char *pStr);
+    using ByteBuffer::Append;
+    virtual unsigned char *Insert(unsigned int nPos, const unsigned char *pStr,
+                                  int nLen);
+    virtual unsigned char *Allocate(unsigned int nLen);
+    virtual void Clear();
+    virtual void Reset();
+    virtual unsigned char *Copy(const unsigned char *pBuff, int nLen);
+
+    /// \brief Block size from which the huge page path is taken, default HugePageSize
+    static size_t HugePageThreshold();
+
+    /// \brief Sets the block size from which the huge page path is taken
+    static void SetHugePageThreshold(size_t nBytes);
+
+    /// \brief Number of blocks allocated on the huge page path since startup
+    static unsigned long long HugePageAllocations();
+
+    /// \brief Number of blocks allocated from the heap since startup
+    static unsigned long long RegularAllocations();
+
+private:
+    void Reserve(unsigned int nLen, unsigned int nKeep);
+};
+
 
 /// \brief The origin point for stream seeking operations
 enum class StreamSeekOrigin : int
@@ -674,6 +741,13 @@ public:
 CPL_SMARTER_PTR(FileInputStream)
 
 
+/// \brief Describes one contiguous block for a vectored (scatter/gather) write
+struct IoVec
+{
+    const unsigned char *Data;///< Pointer to the block
+    unsigned int Length;      ///< Length of the block in bytes
+};
+
 /// \brief Base class for output data streams
 class CPL_API OutputStream : public RefObject
 {
@@ -698,6 +772,13 @@ public:
     bool TestCapability(GsCapability cap);
     /// \brief Writes a block of data to the output stream. Derived classes must implement this method.
     virtual int RawWrite(const unsigned char *buff, int nLen) = 0;
+    /// \brief Writes several blocks of data in order as one logical write.
+    /// \details The default implementation calls RawWrite for each block. Derived classes
+    /// that can hand the blocks to the system in one call should override this method.
+    /// \param vec Array of blocks to write
+    /// \param nCount Number of blocks in the array
+    /// \return The total number of bytes written
+    virtual long long RawWriteV(const IoVec *vec, int nCount);
     /// \brief Returns the offset of the next write, i.e., the length of data already written. Derived classes must implement this method.
     virtual unsigned long long Offset() const = 0;
     /// \brief Seeks to a specified position in the output stream. Derived classes supporting seeking must implement this method.
@@ -730,6 +811,14 @@ public:
 
     /// \brief Writes a block of memory to the output stream
     int WriteBuffer(const ByteBuffer *buff);
+
+    /// \brief Writes a block of any length, continuing after short writes
+    /// \details RawWrite is called with at most INT_MAX bytes at a time until all data is
+    /// written or a call writes nothing.
+    /// \param buff Pointer to the data to write
+    /// \param nLen Length of the data in bytes
+    /// \return The number of bytes written, less than nLen only if a write failed
+    size_t WriteFully(const unsigned char *buff, size_t nLen);
 };
 CPL_SMARTER_PTR(OutputStream)
 
@@ -832,6 +921,13 @@ public:
     /// \return The number of bytes written.
     virtual int RawWrite(const unsigned char *buff, int nLen);
 
+    /// \brief Writes several blocks of data with a single system call where possible.
+    /// \details Pending buffered data is flushed first so that the blocks land after it.
+    /// \param vec Array of blocks to write.
+    /// \param nCount Number of blocks in the array.
+    /// \return The total number of bytes written.
+    virtual long long RawWriteV(const IoVec *vec, int nCount);
+
     /// \brief Returns the offset of the next write, i.e., the length of data already written.
     /// \details Derived classes must implement this method.
     /// \return The current offset in the output stream.
@@ -843,6 +939,15 @@ public:
     /// \param origin The origin for seeking (e.g., start, current, end).
     /// \return `true` if the seek operation was successful, `false` otherwise.
     virtual bool Seek(int offset, StreamSeekOrigin origin);
+
+    /// \brief Hands the buffered data to the operating system.
+    /// \return `true` if successful, `false` otherwise.
+    virtual bool Flush();
+
+    /// \brief Flushes the stream and waits until the file data reaches the storage device.
+    /// \details Uses fdatasync where available, so file metadata such as timestamps is not forced out.
+    /// \return `true` if successful, `false` otherwise.
+    bool Sync();
 };
 CPL_SMARTER_PTR(FileOutputStream)
 
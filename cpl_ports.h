@@ -23,16 +23,30 @@
 #include "cpl_stringhelp.h"
 
 #include "cpl_atomic.h"
+#include "cpl_bufferchain.h"
 #include "cpl_byteendian.h"
+#include "cpl_charset.h"
+#include "cpl_codec.h"
+#include "cpl_csvreader.h"
 #include "cpl_datetime.h"
 #include "cpl_delegate.h"
 #include "cpl_flags.h"
+#include "cpl_hash.h"
+#include "cpl_journal.h"
+#include "cpl_likepattern.h"
 
 #include "cpl_mathhelp.h"
 #include "cpl_memorymanager.h"
 #include "cpl_object.h"
+#include "cpl_regex.h"
+#include "cpl_searcher.h"
+#include "cpl_streamstats.h"
+#include "cpl_stringpool.h"
+#include "cpl_tokenizer.h"
+#include "cpl_transcoder.h"
 
 #include "cpl_any.h"
+#include "cpl_format.h"
 
 #include <algorithm>
 #include <map>
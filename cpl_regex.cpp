@@ -0,0 +1,342 @@
+/**
+ * CPL - Common Portability Library
+ *
+ * Copyright (C) 2024 Merlot.Rain
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "cpl_regex.h"
+#include <list>
+#include <mutex>
+#include <stdexcept>
+#include <unordered_map>
+#ifndef PCRE2_CODE_UNIT_WIDTH
+#define PCRE2_CODE_UNIT_WIDTH 8
+#endif
+#include <pcre2.h>
+
+namespace CPL {
+
+static pcre2_code *compilePattern(std::string_view pattern,
+                                  unsigned int nOptions, bool &bJit)
+{
+    int nError = 0;
+    PCRE2_SIZE nOffset = 0;
+    pcre2_code *code =
+            pcre2_compile(reinterpret_cast<PCRE2_SPTR>(pattern.data()),
+                          pattern.size(), nOptions, &nError, &nOffset, nullptr);
+    if (!code)
+    {
+        PCRE2_UCHAR message[256];
+        pcre2_get_error_message(nError, message, sizeof(message));
+        throw std::invalid_argument(
+                "Invalid regular expression at offset " +
+                std::to_string(nOffset) + ": " +
+                reinterpret_cast<const char *>(message));
+    }
+    bJit = pcre2_jit_compile(code, PCRE2_JIT_COMPLETE) == 0;
+    return code;
+}
+
+/// Match data reused by every match on a thread, grown to the largest
+/// capture count seen so far.
+struct ThreadMatchData
+{
+    pcre2_match_data *Data = nullptr;
+    unsigned int nPairs = 0;
+
+    ~ThreadMatchData()
+    {
+        if (Data) pcre2_match_data_free(Data);
+    }
+
+    pcre2_match_data *Get(unsigned int nNeeded)
+    {
+        if (nNeeded > nPairs)
+        {
+            if (Data) pcre2_match_data_free(Data);
+            Data = pcre2_match_data_create(nNeeded, nullptr);
+            if (!Data) throw std::bad_alloc();
+            nPairs = nNeeded;
+        }
+        return Data;
+    }
+};
+
+static thread_local ThreadMatchData t_MatchData;
+
+/* ---------------------------------- Regex --------------------------------- */
+
+Regex::Regex(std::string_view pattern, RegexOptions options)
+    : m_Pattern(pattern), m_pFullCode(nullptr)
+{
+    if (options.TestFlag(eIgnoreCase)) m_nCompileOptions |= PCRE2_CASELESS;
+    if (options.TestFlag(eMultiline)) m_nCompileOptions |= PCRE2_MULTILINE;
+    if (options.TestFlag(eDotAll)) m_nCompileOptions |= PCRE2_DOTALL;
+    if (options.TestFlag(eExtended)) m_nCompileOptions |= PCRE2_EXTENDED;
+    if (options.TestFlag(eUtf))
+    {
+        m_nCompileOptions |= PCRE2_UTF;
+#ifdef PCRE2_MATCH_INVALID_UTF
+        m_nCompileOptions |= PCRE2_MATCH_INVALID_UTF;
+#endif
+    }
+
+    pcre2_code *code = compilePattern(m_Pattern, m_nCompileOptions, m_bJit);
+    m_pCode = code;
+    uint32_t nCaptures = 0;
+    pcre2_pattern_info(code, PCRE2_INFO_CAPTURECOUNT, &nCaptures);
+    m_nCaptures = nCaptures;
+}
+
+Regex::Regex(Regex &&rhs) noexcept
+    : m_Pattern(std::move(rhs.m_Pattern)),
+      m_nCompileOptions(rhs.m_nCompileOptions), m_pCode(rhs.m_pCode),
+      m_pFullCode(rhs.m_pFullCode.exchange(nullptr)),
+      m_nCaptures(rhs.m_nCaptures), m_bJit(rhs.m_bJit)
+{
+    rhs.m_pCode = nullptr;
+}
+
+Regex &Regex::operator=(Regex &&rhs) noexcept
+{
+    if (this != &rhs)
+    {
+        if (m_pCode) pcre2_code_free(static_cast<pcre2_code *>(m_pCode));
+        if (void *pFull = m_pFullCode.load())
+            pcre2_code_free(static_cast<pcre2_code *>(pFull));
+        m_Pattern = std::move(rhs.m_Pattern);
+        m_nCompileOptions = rhs.m_nCompileOptions;
+        m_pCode = rhs.m_pCode;
+        m_pFullCode.store(rhs.m_pFullCode.exchange(nullptr));
+        m_nCaptures = rhs.m_nCaptures;
+        m_bJit = rhs.m_bJit;
+        rhs.m_pCode = nullptr;
+    }
+    return *this;
+}
+
+Regex::~Regex()
+{
+    if (m_pCode) pcre2_code_free(static_cast<pcre2_code *>(m_pCode));
+    if (void *pFull = m_pFullCode.load())
+        pcre2_code_free(static_cast<pcre2_code *>(pFull));
+}
+
+void *Regex::FullMatchCode() const
+{
+    void *pFull = m_pFullCode.load(std::memory_order_acquire);
+    if (pFull) return pFull;
+
+    // Anchoring at compile time keeps the JIT path; match-time anchoring
+    // would fall back to the interpreter.
+    bool bJit = false;
+    pcre2_code *code = compilePattern(
+            m_Pattern, m_nCompileOptions | PCRE2_ANCHORED | PCRE2_ENDANCHORED,
+            bJit);
+    void *pExpected = nullptr;
+    if (!m_pFullCode.compare_exchange_strong(pExpected, code,
+                                             std::memory_order_acq_rel))
+    {
+        pcre2_code_free(code);
+        return pExpected;
+    }
+    return code;
+}
+
+int Regex::Exec(void *pCode, std::string_view subject, size_t nFrom,
+                unsigned int nOptions,
+                std::vector<std::string_view> *groups) const
+{
+    if (!m_pCode) { throw std::logic_error("Regex has been moved from"); }
+    pcre2_match_data *data = t_MatchData.Get(m_nCaptures + 1);
+    const char *pSubject = subject.data() ? subject.data() : "";
+    int rc = pcre2_match(static_cast<pcre2_code *>(pCode),
+                         reinterpret_cast<PCRE2_SPTR>(pSubject),
+                         subject.size(), nFrom, nOptions, data, nullptr);
+    if (rc > 0 && groups)
+    {
+        const PCRE2_SIZE *ovector = pcre2_get_ovector_pointer(data);
+        groups->resize(m_nCaptures + 1);
+        for (unsigned int i = 0; i <= m_nCaptures; ++i)
+        {
+            PCRE2_SIZE nStart = ovector[2 * i];
+            if (static_cast<int>(i) >= rc || nStart == PCRE2_UNSET)
+            {
+                (*groups)[i] = std::string_view();
+                continue;
+            }
+            (*groups)[i] = subject.substr(nStart, ovector[2 * i + 1] - nStart);
+        }
+    }
+    return rc;
+}
+
+bool Regex::Match(std::string_view subject) const
+{
+    return Exec(FullMatchCode(), subject, 0, 0, nullptr) > 0;
+}
+
+bool Regex::Search(std::string_view subject, size_t nFrom) const
+{
+    if (nFrom > subject.size()) return false;
+    return Exec(m_pCode, subject, nFrom, 0, nullptr) > 0;
+}
+
+bool Regex::Search(std::string_view subject,
+                   std::vector<std::string_view> &groups, size_t nFrom) const
+{
+    if (nFrom > subject.size()) return false;
+    return Exec(m_pCode, subject, nFrom, 0, &groups) > 0;
+}
+
+Regex::Iterator Regex::Iterate(std::string_view subject) const
+{
+    return Iterator(*this, subject);
+}
+
+unsigned int Regex::CaptureCount() const { return m_nCaptures; }
+
+bool Regex::IsJitCompiled() const { return m_bJit; }
+
+/* ----------------------------- Regex::Iterator ---------------------------- */
+
+Regex::Iterator::Iterator(const Regex &regex, std::string_view subject)
+    : m_pRegex(&regex), m_Subject(subject)
+{
+}
+
+bool Regex::Iterator::Next(std::vector<std::string_view> &groups)
+{
+    while (!m_bDone)
+    {
+        // After an empty match, first look for a non-empty match at the same
+        // position before stepping over one character.
+        unsigned int nOptions =
+                m_bLastEmpty ? PCRE2_NOTEMPTY_ATSTART | PCRE2_ANCHORED : 0;
+        int rc = m_pRegex->Exec(m_pRegex->m_pCode, m_Subject, m_nPos, nOptions,
+                                &groups);
+        if (rc <= 0)
+        {
+            if (!m_bLastEmpty || m_nPos >= m_Subject.size())
+            {
+                m_bDone = true;
+                return false;
+            }
+            ++m_nPos;
+            if (m_pRegex->m_nCompileOptions & PCRE2_UTF)
+            {
+                while (m_nPos < m_Subject.size() &&
+                       (static_cast<unsigned char>(m_Subject[m_nPos]) & 0xC0) ==
+                               0x80)
+                    ++m_nPos;
+            }
+            m_bLastEmpty = false;
+            continue;
+        }
+        const char *pEnd = groups[0].data() + groups[0].size();
+        m_nPos = static_cast<size_t>(pEnd - m_Subject.data());
+        m_bLastEmpty = groups[0].empty();
+        return true;
+    }
+    return false;
+}
+
+/* ------------------------------- Regex cache ------------------------------ */
+
+struct RegexCache
+{
+    using Entry = std::pair<std::string, std::shared_ptr<const Regex>>;
+
+    std::mutex Mutex;
+    size_t nCapacity = 64;
+    std::list<Entry> Lru;///< Most recently used first
+    std::unordered_map<std::string, std::list<Entry>::iterator> Index;
+
+    void Trim()
+    {
+        while (Lru.size() > nCapacity)
+        {
+            Index.erase(Lru.back().first);
+            Lru.pop_back();
+        }
+    }
+};
+
+static RegexCache &regexCache()
+{
+    static RegexCache cache;
+    return cache;
+}
+
+std::shared_ptr<const Regex> Regex::Cached(std::string_view pattern,
+                                           RegexOptions options)
+{
+    std::string key(1, static_cast<char>(options.ToInt()));
+    key.append(pattern);
+
+    RegexCache &cache = regexCache();
+    {
+        std::lock_guard<std::mutex> lock(cache.Mutex);
+        auto it = cache.Index.find(key);
+        if (it != cache.Index.end())
+        {
+            cache.Lru.splice(cache.Lru.begin(), cache.Lru, it->second);
+            return it->second->second;
+        }
+    }
+
+    // Compile without holding the lock; a concurrent miss on the same key
+    // compiles twice and keeps the first result.
+    auto regex = std::make_shared<const Regex>(pattern, options);
+    std::lock_guard<std::mutex> lock(cache.Mutex);
+    auto it = cache.Index.find(key);
+    if (it != cache.Index.end())
+    {
+        cache.Lru.splice(cache.Lru.begin(), cache.Lru, it->second);
+        return it->second->second;
+    }
+    if (cache.nCapacity == 0) return regex;
+    cache.Lru.emplace_front(key, regex);
+    cache.Index.emplace(std::move(key), cache.Lru.begin());
+    cache.Trim();
+    return regex;
+}
+
+void Regex::SetCacheCapacity(size_t nCapacity)
+{
+    RegexCache &cache = regexCache();
+    std::lock_guard<std::mutex> lock(cache.Mutex);
+    cache.nCapacity = nCapacity;
+    cache.Trim();
+}
+
+size_t Regex::CacheSize()
+{
+    RegexCache &cache = regexCache();
+    std::lock_guard<std::mutex> lock(cache.Mutex);
+    return cache.Lru.size();
+}
+
+void Regex::ClearCache()
+{
+    RegexCache &cache = regexCache();
+    std::lock_guard<std::mutex> lock(cache.Mutex);
+    cache.Index.clear();
+    cache.Lru.clear();
+}
+
+}// namespace CPL
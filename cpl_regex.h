@@ -0,0 +1,147 @@
+/**
+ * CPL - Common Portability Library
+ *
+ * Copyright (C) 2024 Merlot.Rain
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include "cpl_flags.h"
+#include "cpl_object.h"
+#include <atomic>
+#include <cpl_exports.h>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace CPL {
+
+/// \brief Compiled Perl-compatible regular expression
+/// \details Patterns are compiled once with PCRE2 and, where the platform supports it,
+/// JIT-compiled to machine code. Matching is thread-safe and allocation-free: each thread
+/// reuses its own match data block. Positions and captures are byte offsets into the
+/// subject, and captures are returned as views into it.
+class CPL_API Regex
+{
+public:
+    /// \brief Compile options
+    enum RegexOption
+    {
+        eNone = 0,       ///< Default options
+        eIgnoreCase = 1, ///< Case-insensitive matching
+        eMultiline = 2,  ///< `^` and `$` also match at line breaks
+        eDotAll = 4,     ///< `.` also matches line breaks
+        eExtended = 8,   ///< Ignore unescaped whitespace and `#` comments in the pattern
+        eUtf = 16,       ///< Treat pattern and subject as UTF-8 code points instead of bytes
+    };
+    CPL_DECLARE_FLAGS(RegexOptions, RegexOption)
+
+    /// \brief Iterates over the successive non-overlapping matches in a subject
+    class CPL_API Iterator
+    {
+        const Regex *m_pRegex;
+        std::string_view m_Subject;
+        size_t m_nPos = 0;
+        bool m_bLastEmpty = false;
+        bool m_bDone = false;
+
+    public:
+        /// \brief Creates an iterator over a subject, which must outlive it
+        Iterator(const Regex &regex, std::string_view subject);
+
+        /// \brief Finds the next match
+        /// \param groups Receives the whole match followed by the capture groups;
+        /// unset groups are empty views with a null data pointer
+        /// \return True if a match was found, false when there are no more
+        bool Next(std::vector<std::string_view> &groups);
+    };
+
+    /// \brief Compiles a pattern
+    /// \details Throws std::invalid_argument with the PCRE2 error message if the pattern is invalid.
+    /// \param pattern The regular expression
+    /// \param options Compile options
+    explicit Regex(std::string_view pattern, RegexOptions options = eNone);
+
+    /// \brief Move constructor
+    Regex(Regex &&rhs) noexcept;
+
+    /// \brief Move assignment operator
+    Regex &operator=(Regex &&rhs) noexcept;
+
+    /// \brief Destructor
+    ~Regex();
+
+    CPL_DISABLE_COPY(Regex)
+
+    /// \brief Checks whether the whole subject matches the pattern
+    bool Match(std::string_view subject) const;
+
+    /// \brief Checks whether the pattern matches anywhere in the subject
+    /// \param subject The subject string
+    /// \param nFrom Offset to start searching at
+    bool Search(std::string_view subject, size_t nFrom = 0) const;
+
+    /// \brief Finds the first match and its capture groups
+    /// \param subject The subject string
+    /// \param groups Receives the whole match followed by the capture groups;
+    /// unset groups are empty views with a null data pointer
+    /// \param nFrom Offset to start searching at
+    /// \return True if a match was found
+    bool Search(std::string_view subject, std::vector<std::string_view> &groups,
+                size_t nFrom = 0) const;
+
+    /// \brief Creates an iterator over all matches in a subject
+    Iterator Iterate(std::string_view subject) const;
+
+    /// \brief Number of capture groups in the pattern
+    unsigned int CaptureCount() const;
+
+    /// \brief Whether the pattern was JIT-compiled
+    bool IsJitCompiled() const;
+
+    /// \brief Returns a compiled pattern from the process-wide cache, compiling it on a miss
+    /// \details The cache is bounded and evicts the least recently used pattern;
+    /// evicted patterns stay valid while references to them are held.
+    /// \param pattern The regular expression
+    /// \param options Compile options
+    static std::shared_ptr<const Regex> Cached(std::string_view pattern,
+                                               RegexOptions options = eNone);
+
+    /// \brief Sets the maximum number of patterns kept by the cache, default 64
+    static void SetCacheCapacity(size_t nCapacity);
+
+    /// \brief Number of patterns currently in the cache
+    static size_t CacheSize();
+
+    /// \brief Removes all patterns from the cache
+    static void ClearCache();
+
+private:
+    int Exec(void *pCode, std::string_view subject, size_t nFrom,
+             unsigned int nOptions, std::vector<std::string_view> *groups) const;
+    void *FullMatchCode() const;
+
+    std::string m_Pattern;                   ///< Source pattern, kept to compile the anchored form
+    unsigned int m_nCompileOptions = 0;      ///< PCRE2 compile options
+    void *m_pCode = nullptr;                 ///< The pcre2_code
+    mutable std::atomic<void *> m_pFullCode; ///< pcre2_code anchored at both ends, compiled on first Match
+    unsigned int m_nCaptures = 0;            ///< Number of capture groups
+    bool m_bJit = false;                     ///< Whether JIT compilation succeeded
+};
+
+}// namespace CPL
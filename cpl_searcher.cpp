@@ -0,0 +1,344 @@
+/**
+ * CPL - Common Portability Library
+ *
+ * Copyright (C) 2024 Merlot.Rain
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "cpl_searcher.h"
+#include "cpl_simd.h"
+#include <cstring>
+#include <deque>
+#include <stdexcept>
+
+namespace CPL {
+
+/* -------------------------------- Searcher -------------------------------- */
+
+Searcher::Searcher(std::string_view pattern) : m_Pattern(pattern)
+{
+    const size_t nLen = m_Pattern.size();
+    if (nLen < 2) { return; }
+    const size_t nLast = nLen - 1;
+    const unsigned int nDefault =
+            static_cast<unsigned int>(nLen < UINT_MAX ? nLen : UINT_MAX);
+    for (unsigned int &shift: m_Shift) shift = nDefault;
+    for (size_t i = 0; i < nLast; ++i)
+    {
+        size_t nShift = nLast - i;
+        m_Shift[static_cast<unsigned char>(m_Pattern[i])] =
+                static_cast<unsigned int>(nShift < UINT_MAX ? nShift : UINT_MAX);
+    }
+}
+
+size_t Searcher::Find(std::string_view text, size_t nFrom) const
+{
+    const size_t m = m_Pattern.size();
+    const size_t n = text.size();
+    if (nFrom > n) { return std::string_view::npos; }
+    if (m == 0) { return nFrom; }
+    if (m > n - nFrom) { return std::string_view::npos; }
+
+    const char *s = text.data();
+    const char *p = m_Pattern.data();
+    if (m == 1)
+    {
+        const char *hit = Simd::FindChar(s + nFrom, s + n, p[0]);
+        return hit == s + n ? std::string_view::npos
+                            : static_cast<size_t>(hit - s);
+    }
+
+    // Candidate starts run from nFrom to nLastStart inclusive.
+    const size_t nLastStart = n - m;
+    size_t i = nFrom;
+#if defined(CPL_SIMD_AVX2)
+    {
+        const __m256i first = _mm256_set1_epi8(p[0]);
+        const __m256i last = _mm256_set1_epi8(p[m - 1]);
+        for (; i + 32 <= nLastStart + 1; i += 32)
+        {
+            __m256i blockFirst = _mm256_loadu_si256(
+                    reinterpret_cast<const __m256i *>(s + i));
+            __m256i blockLast = _mm256_loadu_si256(
+                    reinterpret_cast<const __m256i *>(s + i + m - 1));
+            unsigned int mask = static_cast<unsigned int>(
+                    _mm256_movemask_epi8(_mm256_and_si256(
+                            _mm256_cmpeq_epi8(blockFirst, first),
+                            _mm256_cmpeq_epi8(blockLast, last))));
+            while (mask)
+            {
+                size_t nCand = i + Simd::CountTrailingZeros(mask);
+                if (std::memcmp(s + nCand + 1, p + 1, m - 2) == 0)
+                    return nCand;
+                mask &= mask - 1;
+            }
+        }
+    }
+#endif
+#if defined(CPL_SIMD_SSE2)
+    {
+        const __m128i first = _mm_set1_epi8(p[0]);
+        const __m128i last = _mm_set1_epi8(p[m - 1]);
+        for (; i + 16 <= nLastStart + 1; i += 16)
+        {
+            __m128i blockFirst =
+                    _mm_loadu_si128(reinterpret_cast<const __m128i *>(s + i));
+            __m128i blockLast = _mm_loadu_si128(
+                    reinterpret_cast<const __m128i *>(s + i + m - 1));
+            unsigned int mask = static_cast<unsigned int>(_mm_movemask_epi8(
+                    _mm_and_si128(_mm_cmpeq_epi8(blockFirst, first),
+                                  _mm_cmpeq_epi8(blockLast, last))));
+            while (mask)
+            {
+                size_t nCand = i + Simd::CountTrailingZeros(mask);
+                if (std::memcmp(s + nCand + 1, p + 1, m - 2) == 0)
+                    return nCand;
+                mask &= mask - 1;
+            }
+        }
+    }
+#elif defined(CPL_SIMD_NEON)
+    {
+        const uint8x16_t first = vdupq_n_u8(static_cast<unsigned char>(p[0]));
+        const uint8x16_t last = vdupq_n_u8(static_cast<unsigned char>(p[m - 1]));
+        const unsigned char *u = reinterpret_cast<const unsigned char *>(s);
+        for (; i + 16 <= nLastStart + 1; i += 16)
+        {
+            uint8x16_t eq = vandq_u8(vceqq_u8(vld1q_u8(u + i), first),
+                                     vceqq_u8(vld1q_u8(u + i + m - 1), last));
+            unsigned long long mask = vget_lane_u64(
+                    vreinterpret_u64_u8(
+                            vshrn_n_u16(vreinterpretq_u16_u8(eq), 4)),
+                    0);
+            while (mask)
+            {
+                int nBit = Simd::CountTrailingZeros64(mask);
+                size_t nCand = i + (nBit >> 2);
+                if (std::memcmp(s + nCand + 1, p + 1, m - 2) == 0)
+                    return nCand;
+                mask &= ~(0xFULL << (nBit & ~3));
+            }
+        }
+    }
+#endif
+
+    const char chLast = p[m - 1];
+    while (i <= nLastStart)
+    {
+        char c = s[i + m - 1];
+        if (c == chLast && std::memcmp(s + i, p, m - 1) == 0) return i;
+        i += m_Shift[static_cast<unsigned char>(c)];
+    }
+    return std::string_view::npos;
+}
+
+size_t Searcher::Count(std::string_view text) const
+{
+    if (m_Pattern.empty()) { return 0; }
+    size_t nCount = 0;
+    size_t nPos = 0;
+    while ((nPos = Find(text, nPos)) != std::string_view::npos)
+    {
+        ++nCount;
+        nPos += m_Pattern.size();
+    }
+    return nCount;
+}
+
+std::string_view Searcher::Pattern() const { return m_Pattern; }
+
+/* ------------------------------ MultiReplacer ----------------------------- */
+
+MultiReplacer::MultiReplacer() {}
+
+MultiReplacer::MultiReplacer(
+        const std::vector<std::pair<std::string, std::string>> &table)
+{
+    for (const auto &entry: table) Add(entry.first, entry.second);
+    Compile();
+}
+
+void MultiReplacer::Add(std::string_view pattern, std::string_view replacement)
+{
+    if (pattern.empty())
+    {
+        throw std::invalid_argument("pattern cannot be empty");
+    }
+    m_Patterns.emplace_back(pattern);
+    m_Replacements.emplace_back(replacement);
+    m_bCompiled = false;
+}
+
+void MultiReplacer::Compile()
+{
+    // Bytes that occur in no pattern behave identically, so they share one
+    // input class; this keeps the transition table small.
+    bool used[256] = {};
+    for (const std::string &pattern: m_Patterns)
+    {
+        for (char c: pattern) used[static_cast<unsigned char>(c)] = true;
+    }
+    int nUsed = 0;
+    for (int b = 0; b < 256; ++b)
+    {
+        if (used[b]) m_ByteClass[b] = static_cast<unsigned short>(nUsed++);
+    }
+    for (int b = 0; b < 256; ++b)
+    {
+        if (!used[b]) m_ByteClass[b] = static_cast<unsigned short>(nUsed);
+    }
+    m_nClasses = nUsed < 256 ? nUsed + 1 : nUsed;
+    const size_t C = static_cast<size_t>(m_nClasses);
+
+    // Trie
+    m_Next.assign(C, -1);
+    m_Depth.assign(1, 0);
+    m_Match.assign(1, -1);
+    for (size_t id = 0; id < m_Patterns.size(); ++id)
+    {
+        int state = 0;
+        for (char c: m_Patterns[id])
+        {
+            size_t nSlot = state * C + m_ByteClass[static_cast<unsigned char>(c)];
+            if (m_Next[nSlot] < 0)
+            {
+                m_Next[nSlot] = static_cast<int>(m_Depth.size());
+                m_Depth.push_back(m_Depth[state] + 1);
+                m_Match.push_back(-1);
+                m_Next.resize(m_Next.size() + C, -1);
+            }
+            state = m_Next[nSlot];
+        }
+        if (m_Match[state] < 0) m_Match[state] = static_cast<int>(id);
+    }
+
+    // Failure links in breadth-first order, folded into a full transition table.
+    std::vector<int> fail(m_Depth.size(), 0);
+    std::deque<int> queue;
+    for (size_t cls = 0; cls < C; ++cls)
+    {
+        int v = m_Next[cls];
+        if (v < 0) { m_Next[cls] = 0; }
+        else { queue.push_back(v); }
+    }
+    while (!queue.empty())
+    {
+        int u = queue.front();
+        queue.pop_front();
+        // The failure state is shallower and already final; its longest match
+        // is the longest match of u unless u completes a pattern itself.
+        if (m_Match[u] < 0) m_Match[u] = m_Match[fail[u]];
+        for (size_t cls = 0; cls < C; ++cls)
+        {
+            int v = m_Next[u * C + cls];
+            int f = m_Next[fail[u] * C + cls];
+            if (v < 0) { m_Next[u * C + cls] = f; }
+            else
+            {
+                fail[v] = f;
+                queue.push_back(v);
+            }
+        }
+    }
+    m_bCompiled = true;
+}
+
+size_t MultiReplacer::PatternCount() const { return m_Patterns.size(); }
+
+template<class Emit>
+size_t MultiReplacer::Run(std::string_view text, Emit &&emit) const
+{
+    if (!m_bCompiled)
+    {
+        throw std::logic_error("MultiReplacer must be compiled before use");
+    }
+
+    const unsigned char *s = reinterpret_cast<const unsigned char *>(text.data());
+    const size_t n = text.size();
+    const size_t C = static_cast<size_t>(m_nClasses);
+    size_t nEmitted = 0;
+    size_t nReplaced = 0;
+    size_t i = 0;
+    int state = 0;
+    int nBest = -1;
+    size_t nBestStart = 0;
+
+    for (;;)
+    {
+        if (i < n)
+        {
+            state = m_Next[state * C + m_ByteClass[s[i]]];
+            ++i;
+            int id = m_Match[state];
+            if (id >= 0)
+            {
+                size_t nLen = m_Patterns[id].size();
+                size_t nStart = i - nLen;
+                if (nBest < 0 || nStart < nBestStart ||
+                    (nStart == nBestStart && nLen > m_Patterns[nBest].size()))
+                {
+                    nBest = id;
+                    nBestStart = nStart;
+                }
+            }
+            // Any later match starts within the prefix the state stands for;
+            // keep scanning while that could still beat the best match.
+            if (nBest < 0 || nBestStart >= i - m_Depth[state]) continue;
+        }
+        else if (nBest < 0) { break; }
+
+        if (nBestStart > nEmitted)
+            emit(text.data() + nEmitted, nBestStart - nEmitted);
+        const std::string &replacement = m_Replacements[nBest];
+        if (!replacement.empty())
+            emit(replacement.data(), replacement.size());
+        ++nReplaced;
+        nEmitted = nBestStart + m_Patterns[nBest].size();
+        // Restart after the replaced text so matches never overlap.
+        i = nEmitted;
+        state = 0;
+        nBest = -1;
+    }
+    if (n > nEmitted) emit(text.data() + nEmitted, n - nEmitted);
+    return nReplaced;
+}
+
+size_t MultiReplacer::Replace(std::string_view text, std::string &out) const
+{
+    out.clear();
+    return Run(text, [&out](const char *p, size_t nLen) { out.append(p, nLen); });
+}
+
+size_t MultiReplacer::Replace(std::string_view text, OutputStream *stream) const
+{
+    if (!stream) { throw std::invalid_argument("stream cannot be null"); }
+    return Run(text, [stream](const char *p, size_t nLen) {
+        if (stream->WriteFully(reinterpret_cast<const unsigned char *>(p),
+                               nLen) != nLen)
+        {
+            throw std::runtime_error("Failed to write to stream");
+        }
+    });
+}
+
+std::string MultiReplacer::Replace(std::string_view text) const
+{
+    std::string out;
+    Replace(text, out);
+    return out;
+}
+
+}// namespace CPL
@@ -0,0 +1,125 @@
+/**
+ * CPL - Common Portability Library
+ *
+ * Copyright (C) 2024 Merlot.Rain
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include "cpl_memorymanager.h"
+#include <cpl_exports.h>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace CPL {
+
+/// \brief Precompiled single-pattern substring search
+/// \details Built once per pattern and reused for any number of texts. Candidate
+/// positions are found by comparing the first and last pattern byte against 16 or 32
+/// text positions at a time; the remaining tail is searched with Horspool shifts.
+/// One-byte patterns use a plain vectorized byte scan.
+class CPL_API Searcher
+{
+    std::string_view m_Pattern;///< The pattern, must outlive the searcher
+    unsigned int m_Shift[256]; ///< Horspool bad-character shifts, for patterns of 2 bytes or more
+
+public:
+    /// \brief Precompiles a pattern
+    /// \param pattern The pattern to search for, which is referenced and not copied
+    explicit Searcher(std::string_view pattern);
+
+    /// \brief Finds the first occurrence of the pattern
+    /// \param text The text to search
+    /// \param nFrom Position in the text to start searching at
+    /// \return The position of the occurrence, or std::string_view::npos if there is none.
+    /// An empty pattern matches at nFrom.
+    size_t Find(std::string_view text, size_t nFrom = 0) const;
+
+    /// \brief Counts the non-overlapping occurrences of the pattern
+    /// \param text The text to search
+    /// \return The number of occurrences, 0 for an empty pattern
+    size_t Count(std::string_view text) const;
+
+    /// \brief The pattern searched for
+    std::string_view Pattern() const;
+};
+
+/// \brief Replaces many patterns in a single pass over the text
+/// \details The patterns are compiled into an Aho-Corasick automaton over byte classes.
+/// At each position the leftmost match wins, and among matches starting there the
+/// longest one; replaced text is not searched again.
+class CPL_API MultiReplacer
+{
+public:
+    /// \brief Creates an empty replacer, add patterns and call Compile before use
+    MultiReplacer();
+
+    /// \brief Creates and compiles a replacer from a table of pattern/replacement pairs
+    /// \param table The replacement table
+    explicit MultiReplacer(
+            const std::vector<std::pair<std::string, std::string>> &table);
+
+    /// \brief Adds a pattern and its replacement
+    /// \details Throws std::invalid_argument for an empty pattern. If a pattern is added
+    /// twice, the first replacement is used. Compile must be called again afterwards.
+    /// \param pattern The text to replace
+    /// \param replacement The text to write instead
+    void Add(std::string_view pattern, std::string_view replacement);
+
+    /// \brief Builds the automaton from the patterns added so far
+    void Compile();
+
+    /// \brief Number of patterns added
+    size_t PatternCount() const;
+
+    /// \brief Replaces all patterns and writes the result into a caller-supplied string
+    /// \details Throws std::logic_error if the replacer has not been compiled.
+    /// \param text The input text, must not overlap `out`
+    /// \param out Receives the result, previous contents are cleared
+    /// \return The number of replacements made
+    size_t Replace(std::string_view text, std::string &out) const;
+
+    /// \brief Replaces all patterns and writes the result to a stream
+    /// \details Short writes are continued. Throws std::runtime_error if the stream stops
+    /// accepting data, after which it holds an incomplete result.
+    /// \param text The input text
+    /// \param stream The output stream
+    /// \return The number of replacements made
+    size_t Replace(std::string_view text, OutputStream *stream) const;
+
+    /// \brief Replaces all patterns and returns the result
+    /// \param text The input text
+    /// \return The text with replacements
+    std::string Replace(std::string_view text) const;
+
+private:
+    template<class Emit>
+    size_t Run(std::string_view text, Emit &&emit) const;
+
+    std::vector<std::string> m_Patterns;    ///< Added patterns
+    std::vector<std::string> m_Replacements;///< Replacement for each pattern
+    unsigned short m_ByteClass[256];        ///< Maps bytes to automaton input classes
+    int m_nClasses = 0;                     ///< Number of input classes
+    std::vector<int> m_Next;                ///< Transitions, m_nClasses entries per state
+    std::vector<int> m_Depth;               ///< Length of the prefix each state stands for
+    std::vector<int> m_Match;               ///< Longest pattern ending in each state, -1 for none
+    bool m_bCompiled = false;               ///< Whether the automaton matches the patterns
+};
+
+}// namespace CPL
@@ -0,0 +1,313 @@
+/**
+ * CPL - Common Portability Library
+ *
+ * Copyright (C) 2024 Merlot.Rain
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstring>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define CPL_SIMD_AVX2 1
+#endif
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define CPL_SIMD_SSE2 1
+#endif
+#if defined(__SSSE3__) || defined(__AVX2__)
+#include <tmmintrin.h>
+#define CPL_SIMD_SSSE3 1
+#endif
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define CPL_SIMD_NEON 1
+#endif
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace CPL {
+
+/// \brief Small vector helpers shared by the string and codec routines
+/// \details The widest instruction set enabled at compile time is used, SSE2 on every
+/// x86-64 build, SSSE3 and AVX2 when building with CPL_NATIVE_ARCH or an equivalent
+/// -m flag, and NEON on ARM; other targets fall back to scalar code.
+namespace Simd {
+
+/// \brief Index of the lowest set bit, the mask must not be zero
+inline int CountTrailingZeros(unsigned int nMask)
+{
+#ifdef _MSC_VER
+    unsigned long idx;
+    _BitScanForward(&idx, nMask);
+    return static_cast<int>(idx);
+#else
+    return __builtin_ctz(nMask);
+#endif
+}
+
+/// \brief Index of the lowest set bit, the mask must not be zero
+inline int CountTrailingZeros64(unsigned long long nMask)
+{
+#if defined(_MSC_VER) && defined(_M_X64)
+    unsigned long idx;
+    _BitScanForward64(&idx, nMask);
+    return static_cast<int>(idx);
+#elif defined(_MSC_VER)
+    unsigned int lo = static_cast<unsigned int>(nMask);
+    return lo ? CountTrailingZeros(lo)
+              : 32 + CountTrailingZeros(static_cast<unsigned int>(nMask >> 32));
+#else
+    return __builtin_ctzll(nMask);
+#endif
+}
+
+/// \brief Number of set bits
+inline int PopCount64(unsigned long long nMask)
+{
+#if defined(_MSC_VER) && defined(_M_X64)
+    return static_cast<int>(__popcnt64(nMask));
+#elif defined(_MSC_VER)
+    return static_cast<int>(__popcnt(static_cast<unsigned int>(nMask)) +
+                            __popcnt(static_cast<unsigned int>(nMask >> 32)));
+#else
+    return __builtin_popcountll(nMask);
+#endif
+}
+
+/// \brief Marks the bytes of a 64-byte block equal to c
+/// \param p Start of the block, all 64 bytes must be readable
+/// \param c The byte to look for
+/// \return A mask whose bit i is set when p[i] == c
+inline unsigned long long MatchMask64(const char *p, char c)
+{
+#if defined(CPL_SIMD_AVX2)
+    const __m256i needle = _mm256_set1_epi8(c);
+    unsigned int lo = static_cast<unsigned int>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(
+            _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p)), needle)));
+    unsigned int hi = static_cast<unsigned int>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(
+            _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p + 32)), needle)));
+    return lo | static_cast<unsigned long long>(hi) << 32;
+#elif defined(CPL_SIMD_SSE2)
+    const __m128i needle = _mm_set1_epi8(c);
+    unsigned long long nMask = 0;
+    for (int i = 0; i < 4; ++i)
+    {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p + i * 16));
+        nMask |= static_cast<unsigned long long>(static_cast<unsigned int>(
+                         _mm_movemask_epi8(_mm_cmpeq_epi8(v, needle))))
+                 << (i * 16);
+    }
+    return nMask;
+#elif defined(CPL_SIMD_NEON) && defined(__aarch64__)
+    const uint8x16_t needle = vdupq_n_u8(static_cast<uint8_t>(c));
+    const uint8x16_t bits = {1, 2, 4, 8, 16, 32, 64, 128, 1, 2, 4, 8, 16, 32, 64, 128};
+    const uint8_t *q = reinterpret_cast<const uint8_t *>(p);
+    uint8x16_t m0 = vandq_u8(vceqq_u8(vld1q_u8(q), needle), bits);
+    uint8x16_t m1 = vandq_u8(vceqq_u8(vld1q_u8(q + 16), needle), bits);
+    uint8x16_t m2 = vandq_u8(vceqq_u8(vld1q_u8(q + 32), needle), bits);
+    uint8x16_t m3 = vandq_u8(vceqq_u8(vld1q_u8(q + 48), needle), bits);
+    uint8x16_t sum = vpaddq_u8(vpaddq_u8(m0, m1), vpaddq_u8(m2, m3));
+    sum = vpaddq_u8(sum, sum);
+    return vgetq_lane_u64(vreinterpretq_u64_u8(sum), 0);
+#else
+    unsigned long long nMask = 0;
+    for (int i = 0; i < 64; ++i)
+        if (p[i] == c) nMask |= 1ULL << i;
+    return nMask;
+#endif
+}
+
+/// \brief Finds the first occurrence of a byte
+/// \param p Start of the range
+/// \param pEnd End of the range
+/// \param c The byte to find
+/// \return Pointer to the byte, or pEnd if it does not occur
+inline const char *FindChar(const char *p, const char *pEnd, char c)
+{
+#if defined(CPL_SIMD_AVX2)
+    const __m256i needle32 = _mm256_set1_epi8(c);
+    for (; pEnd - p >= 32; p += 32)
+    {
+        __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p));
+        unsigned int mask = static_cast<unsigned int>(
+                _mm256_movemask_epi8(_mm256_cmpeq_epi8(block, needle32)));
+        if (mask) return p + CountTrailingZeros(mask);
+    }
+#endif
+#if defined(CPL_SIMD_SSE2)
+    const __m128i needle = _mm_set1_epi8(c);
+    for (; pEnd - p >= 16; p += 16)
+    {
+        __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+        unsigned int mask = static_cast<unsigned int>(
+                _mm_movemask_epi8(_mm_cmpeq_epi8(block, needle)));
+        if (mask) return p + CountTrailingZeros(mask);
+    }
+#elif defined(CPL_SIMD_NEON)
+    const uint8x16_t needle = vdupq_n_u8(static_cast<unsigned char>(c));
+    for (; pEnd - p >= 16; p += 16)
+    {
+        uint8x16_t eq = vceqq_u8(
+                vld1q_u8(reinterpret_cast<const unsigned char *>(p)), needle);
+        // Narrow each byte to 4 bits, giving a 64-bit mask with a nibble per byte.
+        unsigned long long mask = vget_lane_u64(
+                vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(eq), 4)),
+                0);
+        if (mask) return p + (CountTrailingZeros64(mask) >> 2);
+    }
+#endif
+    const void *hit = std::memchr(p, c, static_cast<size_t>(pEnd - p));
+    return hit ? static_cast<const char *>(hit) : pEnd;
+}
+
+/// \brief Converts the ASCII letters at the start of a string to one case
+/// \details Works block by block and stops before the first block that holds a
+/// byte outside ASCII, leaving such bytes to locale-aware code.
+/// \param src The source bytes
+/// \param nLen The number of bytes
+/// \param dst Receives the converted bytes, may equal src
+/// \param bUpper Whether to convert to upper case instead of lower case
+/// \return The number of bytes converted
+inline size_t ConvertAsciiCase(const char *src, size_t nLen, char *dst,
+                               bool bUpper)
+{
+    size_t i = 0;
+    const char chFirst = bUpper ? 'a' : 'A';
+#if defined(CPL_SIMD_AVX2)
+    const __m256i first32 = _mm256_set1_epi8(chFirst);
+    const __m256i last32 = _mm256_set1_epi8(25);
+    const __m256i flip32 = _mm256_set1_epi8(0x20);
+    for (; nLen - i >= 32; i += 32)
+    {
+        __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + i));
+        if (_mm256_movemask_epi8(block)) return i;
+        __m256i d = _mm256_sub_epi8(block, first32);
+        __m256i letter = _mm256_cmpeq_epi8(_mm256_min_epu8(d, last32), d);
+        _mm256_storeu_si256(
+                reinterpret_cast<__m256i *>(dst + i),
+                _mm256_xor_si256(block, _mm256_and_si256(letter, flip32)));
+    }
+#endif
+#if defined(CPL_SIMD_SSE2)
+    const __m128i first = _mm_set1_epi8(chFirst);
+    const __m128i last = _mm_set1_epi8(25);
+    const __m128i flip = _mm_set1_epi8(0x20);
+    for (; nLen - i >= 16; i += 16)
+    {
+        __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i));
+        if (_mm_movemask_epi8(block)) return i;
+        __m128i d = _mm_sub_epi8(block, first);
+        __m128i letter = _mm_cmpeq_epi8(_mm_min_epu8(d, last), d);
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i),
+                         _mm_xor_si128(block, _mm_and_si128(letter, flip)));
+    }
+#elif defined(CPL_SIMD_NEON) && defined(__aarch64__)
+    const uint8x16_t first = vdupq_n_u8(static_cast<unsigned char>(chFirst));
+    const uint8x16_t count = vdupq_n_u8(26);
+    const uint8x16_t flip = vdupq_n_u8(0x20);
+    for (; nLen - i >= 16; i += 16)
+    {
+        uint8x16_t block = vld1q_u8(reinterpret_cast<const unsigned char *>(src + i));
+        if (vmaxvq_u8(block) & 0x80) return i;
+        uint8x16_t letter = vcltq_u8(vsubq_u8(block, first), count);
+        vst1q_u8(reinterpret_cast<unsigned char *>(dst + i),
+                 veorq_u8(block, vandq_u8(letter, flip)));
+    }
+#endif
+    for (; i < nLen; ++i)
+    {
+        unsigned char c = static_cast<unsigned char>(src[i]);
+        if (c & 0x80) break;
+        dst[i] = static_cast<char>(
+                static_cast<unsigned char>(c - chFirst) < 26 ? c ^ 0x20 : c);
+    }
+    return i;
+}
+
+/// \brief Finds how many leading bytes of two strings are equal ignoring ASCII case
+/// \details Works block by block and stops before the first block that differs or
+/// holds a byte outside ASCII, so the result is a lower bound the caller refines.
+/// \param a The first string
+/// \param b The second string
+/// \param nLen The number of bytes to compare
+/// \return The number of bytes known to be equal
+inline size_t EqualPrefixNoCase(const char *a, const char *b, size_t nLen)
+{
+    size_t i = 0;
+#if defined(CPL_SIMD_AVX2)
+    const __m256i first32 = _mm256_set1_epi8('A');
+    const __m256i last32 = _mm256_set1_epi8(25);
+    const __m256i flip32 = _mm256_set1_epi8(0x20);
+    for (; nLen - i >= 32; i += 32)
+    {
+        __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(a + i));
+        __m256i y = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(b + i));
+        __m256i dx = _mm256_sub_epi8(x, first32);
+        __m256i dy = _mm256_sub_epi8(y, first32);
+        x = _mm256_or_si256(x, _mm256_and_si256(
+                                       _mm256_cmpeq_epi8(_mm256_min_epu8(dx, last32), dx),
+                                       flip32));
+        y = _mm256_or_si256(y, _mm256_and_si256(
+                                       _mm256_cmpeq_epi8(_mm256_min_epu8(dy, last32), dy),
+                                       flip32));
+        if (_mm256_movemask_epi8(_mm256_cmpeq_epi8(x, y)) != -1 ||
+            _mm256_movemask_epi8(_mm256_or_si256(x, y)))
+            return i;
+    }
+#endif
+#if defined(CPL_SIMD_SSE2)
+    const __m128i first = _mm_set1_epi8('A');
+    const __m128i last = _mm_set1_epi8(25);
+    const __m128i flip = _mm_set1_epi8(0x20);
+    for (; nLen - i >= 16; i += 16)
+    {
+        __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i *>(a + i));
+        __m128i y = _mm_loadu_si128(reinterpret_cast<const __m128i *>(b + i));
+        __m128i dx = _mm_sub_epi8(x, first);
+        __m128i dy = _mm_sub_epi8(y, first);
+        x = _mm_or_si128(x, _mm_and_si128(
+                                    _mm_cmpeq_epi8(_mm_min_epu8(dx, last), dx), flip));
+        y = _mm_or_si128(y, _mm_and_si128(
+                                    _mm_cmpeq_epi8(_mm_min_epu8(dy, last), dy), flip));
+        if (_mm_movemask_epi8(_mm_cmpeq_epi8(x, y)) != 0xFFFF ||
+            _mm_movemask_epi8(_mm_or_si128(x, y)))
+            break;
+    }
+#elif defined(CPL_SIMD_NEON) && defined(__aarch64__)
+    const uint8x16_t first = vdupq_n_u8('A');
+    const uint8x16_t count = vdupq_n_u8(26);
+    const uint8x16_t flip = vdupq_n_u8(0x20);
+    for (; nLen - i >= 16; i += 16)
+    {
+        uint8x16_t x = vld1q_u8(reinterpret_cast<const unsigned char *>(a + i));
+        uint8x16_t y = vld1q_u8(reinterpret_cast<const unsigned char *>(b + i));
+        x = vorrq_u8(x, vandq_u8(vcltq_u8(vsubq_u8(x, first), count), flip));
+        y = vorrq_u8(y, vandq_u8(vcltq_u8(vsubq_u8(y, first), count), flip));
+        if (vminvq_u8(vceqq_u8(x, y)) != 0xFF || (vmaxvq_u8(vorrq_u8(x, y)) & 0x80))
+            break;
+    }
+#endif
+    return i;
+}
+
+}// namespace Simd
+
+}// namespace CPL
@@ -0,0 +1,285 @@
+/**
+ * CPL - Common Portability Library
+ *
+ * Copyright (C) 2024 Merlot.Rain
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "cpl_streamstats.h"
+#include <chrono>
+#include <stdexcept>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace CPL {
+
+using StatsClock = std::chrono::steady_clock;
+
+static unsigned long long elapsedNanos(StatsClock::time_point start)
+{
+    return static_cast<unsigned long long>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    StatsClock::now() - start)
+                    .count());
+}
+
+static int latencyBucket(unsigned long long nNanos)
+{
+    if (nNanos < 2) return 0;
+#if defined(_MSC_VER) && defined(_M_X64)
+    unsigned long idx;
+    _BitScanReverse64(&idx, nNanos);
+    int bucket = static_cast<int>(idx);
+#elif defined(__GNUC__)
+    int bucket = 63 - __builtin_clzll(nNanos);
+#else
+    int bucket = 0;
+    while (nNanos >>= 1) ++bucket;
+#endif
+    return bucket < StreamLatencyBuckets ? bucket : StreamLatencyBuckets - 1;
+}
+
+/// Single writer: a relaxed load/store pair avoids a locked read-modify-write.
+static inline void bump(std::atomic<unsigned long long> &counter,
+                        unsigned long long v)
+{
+    counter.store(counter.load(std::memory_order_relaxed) + v,
+                  std::memory_order_relaxed);
+}
+
+unsigned long long StreamOpStats::Percentile(double p) const
+{
+    if (Calls == 0) return 0;
+    if (p < 0) p = 0;
+    if (p > 1) p = 1;
+    unsigned long long nRank = static_cast<unsigned long long>(p * Calls);
+    if (nRank == 0) nRank = 1;
+    unsigned long long nSeen = 0;
+    for (int i = 0; i < StreamLatencyBuckets; ++i)
+    {
+        nSeen += Histogram[i];
+        if (nSeen >= nRank) return std::min(1ULL << (i + 1), MaxNanos);
+    }
+    return MaxNanos;
+}
+
+/* ---------------------------- StreamOpCounters ---------------------------- */
+
+void StreamOpCounters::Record(unsigned long long nNanos,
+                              unsigned long long nBytes, bool bShort)
+{
+    bump(m_nCalls, 1);
+    bump(m_nBytes, nBytes);
+    if (bShort) bump(m_nShortCalls, 1);
+    bump(m_nTotalNanos, nNanos);
+    if (nNanos > m_nMaxNanos.load(std::memory_order_relaxed))
+        m_nMaxNanos.store(nNanos, std::memory_order_relaxed);
+    bump(m_Histogram[latencyBucket(nNanos)], 1);
+}
+
+StreamOpStats StreamOpCounters::Snapshot() const
+{
+    StreamOpStats stats;
+    stats.Calls = m_nCalls.load(std::memory_order_relaxed);
+    stats.Bytes = m_nBytes.load(std::memory_order_relaxed);
+    stats.ShortCalls = m_nShortCalls.load(std::memory_order_relaxed);
+    stats.TotalNanos = m_nTotalNanos.load(std::memory_order_relaxed);
+    stats.MaxNanos = m_nMaxNanos.load(std::memory_order_relaxed);
+    for (int i = 0; i < StreamLatencyBuckets; ++i)
+        stats.Histogram[i] = m_Histogram[i].load(std::memory_order_relaxed);
+    return stats;
+}
+
+void StreamOpCounters::Reset()
+{
+    m_nCalls.store(0, std::memory_order_relaxed);
+    m_nBytes.store(0, std::memory_order_relaxed);
+    m_nShortCalls.store(0, std::memory_order_relaxed);
+    m_nTotalNanos.store(0, std::memory_order_relaxed);
+    m_nMaxNanos.store(0, std::memory_order_relaxed);
+    for (auto &bucket: m_Histogram) bucket.store(0, std::memory_order_relaxed);
+}
+
+/* ---------------------------- StatsInputStream ---------------------------- */
+
+StatsInputStream::StatsInputStream(InputStream *inner, bool bEnabled)
+    : m_Inner(inner), m_bEnabled(bEnabled)
+{
+    if (!inner) { throw std::invalid_argument("inner stream cannot be null"); }
+    for (GsCapability cap: {GsCapability::eZeroCopy, GsCapability::eLength,
+                             GsCapability::eSeek})
+    {
+        if (inner->TestCapability(cap)) MarkCapability(cap);
+    }
+}
+
+InputStream *StatsInputStream::Inner() const { return m_Inner.p; }
+
+void StatsInputStream::SetEnabled(bool bEnabled)
+{
+    m_bEnabled.store(bEnabled, std::memory_order_relaxed);
+}
+
+bool StatsInputStream::IsEnabled() const
+{
+    return m_bEnabled.load(std::memory_order_relaxed);
+}
+
+InputStreamStats StatsInputStream::Stats() const
+{
+    InputStreamStats stats;
+    stats.Read = m_Read.Snapshot();
+    stats.Seek = m_Seek.Snapshot();
+    return stats;
+}
+
+void StatsInputStream::ResetStats()
+{
+    m_Read.Reset();
+    m_Seek.Reset();
+}
+
+int StatsInputStream::Skip(int nLen)
+{
+    if (!IsEnabled()) return m_Inner->Skip(nLen);
+    auto start = StatsClock::now();
+    int n = m_Inner->Skip(nLen);
+    m_Seek.Record(elapsedNanos(start), 0, n < nLen);
+    return n;
+}
+
+int StatsInputStream::RawRead(unsigned char *buff, int nLen)
+{
+    if (!IsEnabled()) return m_Inner->RawRead(buff, nLen);
+    auto start = StatsClock::now();
+    int n = m_Inner->RawRead(buff, nLen);
+    m_Read.Record(elapsedNanos(start), n > 0 ? n : 0, n < nLen);
+    return n;
+}
+
+int StatsInputStream::RawRead(unsigned char *buff, int nLen,
+                              const unsigned char **pointer)
+{
+    if (!IsEnabled()) return m_Inner->RawRead(buff, nLen, pointer);
+    auto start = StatsClock::now();
+    int n = m_Inner->RawRead(buff, nLen, pointer);
+    m_Read.Record(elapsedNanos(start), n > 0 ? n : 0, n < nLen);
+    return n;
+}
+
+long long StatsInputStream::Length() const { return m_Inner->Length(); }
+
+unsigned long long StatsInputStream::Offset() const
+{
+    return m_Inner->Offset();
+}
+
+bool StatsInputStream::Seek(int offset, StreamSeekOrigin origin)
+{
+    if (!IsEnabled()) return m_Inner->Seek(offset, origin);
+    auto start = StatsClock::now();
+    bool ok = m_Inner->Seek(offset, origin);
+    m_Seek.Record(elapsedNanos(start), 0, !ok);
+    return ok;
+}
+
+bool StatsInputStream::Eof() const { return m_Inner->Eof(); }
+
+/* ---------------------------- StatsOutputStream --------------------------- */
+
+StatsOutputStream::StatsOutputStream(OutputStream *inner, bool bEnabled)
+    : m_Inner(inner), m_bEnabled(bEnabled)
+{
+    if (!inner) { throw std::invalid_argument("inner stream cannot be null"); }
+    if (inner->TestCapability(GsCapability::eSeek))
+        MarkCapability(GsCapability::eSeek);
+}
+
+OutputStream *StatsOutputStream::Inner() const { return m_Inner.p; }
+
+void StatsOutputStream::SetEnabled(bool bEnabled)
+{
+    m_bEnabled.store(bEnabled, std::memory_order_relaxed);
+}
+
+bool StatsOutputStream::IsEnabled() const
+{
+    return m_bEnabled.load(std::memory_order_relaxed);
+}
+
+OutputStreamStats StatsOutputStream::Stats() const
+{
+    OutputStreamStats stats;
+    stats.Write = m_Write.Snapshot();
+    stats.Seek = m_Seek.Snapshot();
+    stats.Flush = m_Flush.Snapshot();
+    return stats;
+}
+
+void StatsOutputStream::ResetStats()
+{
+    m_Write.Reset();
+    m_Seek.Reset();
+    m_Flush.Reset();
+}
+
+int StatsOutputStream::RawWrite(const unsigned char *buff, int nLen)
+{
+    if (!IsEnabled()) return m_Inner->RawWrite(buff, nLen);
+    auto start = StatsClock::now();
+    int n = m_Inner->RawWrite(buff, nLen);
+    m_Write.Record(elapsedNanos(start), n > 0 ? n : 0, n < nLen);
+    return n;
+}
+
+long long StatsOutputStream::RawWriteV(const IoVec *vec, int nCount)
+{
+    if (!IsEnabled()) return m_Inner->RawWriteV(vec, nCount);
+    long long nTotal = 0;
+    for (int i = 0; i < nCount; ++i) nTotal += vec[i].Length;
+    auto start = StatsClock::now();
+    long long n = m_Inner->RawWriteV(vec, nCount);
+    m_Write.Record(elapsedNanos(start), n > 0 ? n : 0, n < nTotal);
+    return n;
+}
+
+unsigned long long StatsOutputStream::Offset() const
+{
+    return m_Inner->Offset();
+}
+
+bool StatsOutputStream::Seek(int offset, StreamSeekOrigin origin)
+{
+    if (!IsEnabled()) return m_Inner->Seek(offset, origin);
+    auto start = StatsClock::now();
+    bool ok = m_Inner->Seek(offset, origin);
+    m_Seek.Record(elapsedNanos(start), 0, !ok);
+    return ok;
+}
+
+bool StatsOutputStream::Flush()
+{
+    if (!IsEnabled()) return m_Inner->Flush();
+    auto start = StatsClock::now();
+    bool ok = m_Inner->Flush();
+    m_Flush.Record(elapsedNanos(start), 0, !ok);
+    return ok;
+}
+
+bool StatsOutputStream::Close() { return m_Inner->Close(); }
+
+}// namespace CPL
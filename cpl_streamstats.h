@@ -0,0 +1,177 @@
+/**
+ * CPL - Common Portability Library
+ *
+ * Copyright (C) 2024 Merlot.Rain
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include "cpl_memorymanager.h"
+#include <atomic>
+#include <cpl_exports.h>
+
+namespace CPL {
+
+/// \brief Number of latency histogram buckets kept per stream operation
+/// \details Bucket i counts calls that took [2^i, 2^(i+1)) nanoseconds; bucket 0 also
+/// holds calls below one nanosecond and the last bucket everything above its lower bound.
+static constexpr int StreamLatencyBuckets = 32;
+
+/// \brief Snapshot of the counters of one stream operation
+struct StreamOpStats
+{
+    unsigned long long Calls = 0;     ///< Number of calls
+    unsigned long long Bytes = 0;     ///< Bytes transferred
+    unsigned long long ShortCalls = 0;///< Calls that transferred fewer bytes than requested, or failed
+    unsigned long long TotalNanos = 0;///< Sum of the call latencies in nanoseconds
+    unsigned long long MaxNanos = 0;  ///< Largest call latency in nanoseconds
+    unsigned long long Histogram[StreamLatencyBuckets] = {};///< Call counts per log2 latency bucket
+
+    /// \brief Estimates a latency percentile from the histogram
+    /// \param p The percentile in the range [0, 1]
+    /// \return Upper bound in nanoseconds of the bucket holding the percentile
+    unsigned long long Percentile(double p) const;
+};
+
+/// \brief Snapshot of the counters of a StatsInputStream
+struct InputStreamStats
+{
+    StreamOpStats Read;///< RawRead calls
+    StreamOpStats Seek;///< Seek and Skip calls
+};
+
+/// \brief Snapshot of the counters of a StatsOutputStream
+struct OutputStreamStats
+{
+    StreamOpStats Write;///< RawWrite and RawWriteV calls
+    StreamOpStats Seek; ///< Seek calls
+    StreamOpStats Flush;///< Flush calls
+};
+
+/// \brief Counters of one stream operation
+/// \details Updated by the single thread using the stream with relaxed stores, so recording
+/// a call costs no locked instruction; Snapshot may be called from any thread.
+class CPL_API StreamOpCounters
+{
+    std::atomic<unsigned long long> m_nCalls{0};
+    std::atomic<unsigned long long> m_nBytes{0};
+    std::atomic<unsigned long long> m_nShortCalls{0};
+    std::atomic<unsigned long long> m_nTotalNanos{0};
+    std::atomic<unsigned long long> m_nMaxNanos{0};
+    std::atomic<unsigned long long> m_Histogram[StreamLatencyBuckets] = {};
+
+public:
+    /// \brief Records one call
+    /// \param nNanos Latency of the call in nanoseconds
+    /// \param nBytes Bytes transferred by the call
+    /// \param bShort Whether the call transferred fewer bytes than requested
+    void Record(unsigned long long nNanos, unsigned long long nBytes,
+                bool bShort);
+
+    /// \brief Copies the counters into a snapshot
+    StreamOpStats Snapshot() const;
+
+    /// \brief Sets all counters to zero
+    void Reset();
+};
+
+/// \brief Input stream decorator that measures the calls made to another stream
+/// \details Forwards every call to the wrapped stream, which keeps its capabilities,
+/// and records bytes, call counts, short reads and latencies of RawRead and Seek.
+/// While disabled, a call costs one extra branch.
+class CPL_API StatsInputStream : public InputStream
+{
+    InputStreamPtr m_Inner;       ///< The wrapped stream
+    std::atomic<bool> m_bEnabled; ///< Whether calls are measured
+    StreamOpCounters m_Read;      ///< Counters of RawRead
+    StreamOpCounters m_Seek;      ///< Counters of Seek and Skip
+
+public:
+    /// \brief Wraps an input stream
+    /// \param inner The stream to measure, a reference to it is held
+    /// \param bEnabled Whether measuring starts enabled
+    explicit StatsInputStream(InputStream *inner, bool bEnabled = true);
+
+    /// \brief Returns the wrapped stream
+    InputStream *Inner() const;
+
+    /// \brief Enables or disables measuring
+    void SetEnabled(bool bEnabled);
+
+    /// \brief Checks whether measuring is enabled
+    bool IsEnabled() const;
+
+    /// \brief Returns a snapshot of the counters
+    InputStreamStats Stats() const;
+
+    /// \brief Sets all counters to zero
+    void ResetStats();
+
+    virtual int Skip(int nLen);
+    virtual int RawRead(unsigned char *buff, int nLen);
+    virtual int RawRead(unsigned char *buff, int nLen,
+                        const unsigned char **pointer);
+    virtual long long Length() const;
+    virtual unsigned long long Offset() const;
+    virtual bool Seek(int offset, StreamSeekOrigin origin);
+    virtual bool Eof() const;
+};
+CPL_SMARTER_PTR(StatsInputStream)
+
+/// \brief Output stream decorator that measures the calls made to another stream
+/// \details Forwards every call to the wrapped stream, which keeps its capabilities,
+/// and records bytes, call counts, short writes and latencies of RawWrite, RawWriteV,
+/// Seek and Flush. While disabled, a call costs one extra branch.
+class CPL_API StatsOutputStream : public OutputStream
+{
+    OutputStreamPtr m_Inner;      ///< The wrapped stream
+    std::atomic<bool> m_bEnabled; ///< Whether calls are measured
+    StreamOpCounters m_Write;     ///< Counters of RawWrite and RawWriteV
+    StreamOpCounters m_Seek;      ///< Counters of Seek
+    StreamOpCounters m_Flush;     ///< Counters of Flush
+
+public:
+    /// \brief Wraps an output stream
+    /// \param inner The stream to measure, a reference to it is held
+    /// \param bEnabled Whether measuring starts enabled
+    explicit StatsOutputStream(OutputStream *inner, bool bEnabled = true);
+
+    /// \brief Returns the wrapped stream
+    OutputStream *Inner() const;
+
+    /// \brief Enables or disables measuring
+    void SetEnabled(bool bEnabled);
+
+    /// \brief Checks whether measuring is enabled
+    bool IsEnabled() const;
+
+    /// \brief Returns a snapshot of the counters
+    OutputStreamStats Stats() const;
+
+    /// \brief Sets all counters to zero
+    void ResetStats();
+
+    virtual int RawWrite(const unsigned char *buff, int nLen);
+    virtual long long RawWriteV(const IoVec *vec, int nCount);
+    virtual unsigned long long Offset() const;
+    virtual bool Seek(int offset, StreamSeekOrigin origin);
+    virtual bool Flush();
+    virtual bool Close();
+};
+CPL_SMARTER_PTR(StatsOutputStream)
+
+}// namespace CPL
@@ -19,11 +19,30 @@
  */
 
 #include "cpl_stringhelp.h"
+#include "cpl_byteendian.h"
+#include "cpl_charset.h"
+#include "cpl_codec.h"
+#include "cpl_hash.h"
+#include "cpl_likepattern.h"
+#include "cpl_regex.h"
+#include "cpl_searcher.h"
+#include "cpl_simd.h"
+#include "cpl_tokenizer.h"
+#include "cpl_transcoder.h"
 
 #include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <cerrno>
+#include <cstdarg>
+#include <charconv>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
 #include <double-conversion/double-conversion.h>
 #include <double-conversion/double-to-string.h>
 #include <iconv.h>
+#include <limits>
 #include <stdexcept>
 #include <string>
 #include <unordered_map>
@@ -116,6 +135,243 @@ CodePageID LocalCodePage()
 #endif
 }
 
+/* ------------------------------- IconvCache ------------------------------- */
+
+namespace {
+
+std::atomic<size_t> g_nIconvCapacity{8};
+std::atomic<unsigned long long> g_nIconvHits{0};
+std::atomic<unsigned long long> g_nIconvMisses{0};
+std::atomic<unsigned long long> g_nIconvEvictions{0};
+
+const char *wideEncoding()
+{
+    return sizeof(wchar_t) == 2 ? "UTF-16LE" : "UTF-32LE";
+}
+
+/// Whether an iconv encoding name denotes UTF-8, which the Transcoder handles natively
+bool isUtf8Encoding(const char *codepage)
+{
+    std::string_view name(codepage);
+    return StringHelp::CompareNoCase(name, "UTF-8") == 0 ||
+           StringHelp::CompareNoCase(name, "UTF8") == 0;
+}
+
+struct IconvEntry
+{
+    std::string To;
+    std::string From;
+    iconv_t Cd = (iconv_t) -1;
+};
+
+/// Converts a wide string to UTF-8; dst must hold 3 or 4 bytes per wide character
+TranscodeResult wideToUtf8(const wchar_t *src, size_t nLen, char *dst)
+{
+    if constexpr (sizeof(wchar_t) == 2)
+        return Transcoder::Utf16ToUtf8(reinterpret_cast<const char16_t *>(src),
+                                       nLen, dst);
+    else
+        return Transcoder::Utf32ToUtf8(reinterpret_cast<const char32_t *>(src),
+                                       nLen, dst);
+}
+
+/// Converts UTF-8 to a wide string; dst must hold one wide character per byte
+TranscodeResult utf8ToWide(const char *src, size_t nLen, wchar_t *dst)
+{
+    if constexpr (sizeof(wchar_t) == 2)
+        return Transcoder::Utf8ToUtf16(src, nLen, reinterpret_cast<char16_t *>(dst));
+    else
+        return Transcoder::Utf8ToUtf32(src, nLen, reinterpret_cast<char32_t *>(dst));
+}
+
+[[noreturn]] void throwTranscodeError(const char *encoding,
+                                      const TranscodeResult &result)
+{
+    throw std::runtime_error(std::string("Invalid ") + encoding + " at offset " +
+                             std::to_string(result.Read) + ": " +
+                             Transcoder::StatusText(result.Status));
+}
+
+/// Appends a converted piece to a caller buffer as far as it fits, counting all of it
+template<typename Char>
+void putBounded(const Char *src, size_t nLen, Char *dst, size_t nSize,
+                size_t &nTotal)
+{
+    if (nTotal < nSize)
+        std::memcpy(dst + nTotal, src, std::min(nLen, nSize - nTotal) * sizeof(Char));
+    nTotal += nLen;
+}
+
+/// Idle descriptors of one thread, most recently used first
+struct IconvThreadCache
+{
+    std::vector<IconvEntry> Entries;
+
+    ~IconvThreadCache() { Trim(0); }
+
+    void Trim(size_t nCapacity)
+    {
+        while (Entries.size() > nCapacity)
+        {
+            iconv_close(Entries.back().Cd);
+            Entries.pop_back();
+            g_nIconvEvictions.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+};
+
+IconvThreadCache &threadIconvCache()
+{
+    thread_local IconvThreadCache cache;
+    return cache;
+}
+
+/// Borrows a descriptor from the thread cache for the duration of one conversion.
+/// The descriptor leaves the cache while borrowed, so nested conversions never share it.
+class IconvLease
+{
+    IconvEntry m_Entry;
+
+public:
+    IconvLease(const char *to, const char *from)
+    {
+        IconvThreadCache &cache = threadIconvCache();
+        for (auto it = cache.Entries.begin(); it != cache.Entries.end(); ++it)
+        {
+            if (it->To == to && it->From == from)
+            {
+                m_Entry = std::move(*it);
+                cache.Entries.erase(it);
+                g_nIconvHits.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+        }
+        m_Entry.To = to;
+        m_Entry.From = from;
+        m_Entry.Cd = iconv_open(to, from);
+        g_nIconvMisses.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    ~IconvLease()
+    {
+        if (!IsValid()) return;
+        // return to the initial shift state so the next user starts clean
+        iconv(m_Entry.Cd, nullptr, nullptr, nullptr, nullptr);
+        IconvThreadCache &cache = threadIconvCache();
+        cache.Entries.insert(cache.Entries.begin(), std::move(m_Entry));
+        cache.Trim(g_nIconvCapacity.load(std::memory_order_relaxed));
+    }
+
+    IconvLease(const IconvLease &) = delete;
+    IconvLease &operator=(const IconvLease &) = delete;
+
+    bool IsValid() const { return m_Entry.Cd != (iconv_t) -1; }
+
+    /// Converts nIn bytes into a buffer of nDst bytes, continuing into scratch space
+    /// once it is full; returns the size of the whole result, or npos on invalid input
+    size_t ConvertInto(const char *in, size_t nIn, char *dst, size_t nDst)
+    {
+        char scratch[512];
+        char *pIn = const_cast<char *>(in);
+        size_t nLeft = nIn;
+        char *pOut = dst;
+        size_t nRoom = nDst;
+        size_t nTotal = 0;
+        bool bInputDone = false;
+        for (;;)
+        {
+            char *pBase = pOut;
+            size_t r = bInputDone ? iconv(m_Entry.Cd, nullptr, nullptr, &pOut, &nRoom)
+                                  : iconv(m_Entry.Cd, &pIn, &nLeft, &pOut, &nRoom);
+            nTotal += pOut - pBase;
+            if (r == (size_t) -1)
+            {
+                if (errno != E2BIG) return std::string::npos;
+                pOut = scratch;
+                nRoom = sizeof(scratch);
+                continue;
+            }
+            if (bInputDone) break;
+            bInputDone = true;
+        }
+        return nTotal;
+    }
+
+    /// Converts nIn bytes into out, growing it as needed; false on invalid input
+    template<typename String>
+    bool Convert(const char *in, size_t nIn, String &out)
+    {
+        using Char = typename String::value_type;
+        out.resize(nIn + 16);
+        char *pIn = const_cast<char *>(in);
+        size_t nLeft = nIn;
+        size_t nDone = 0;
+        bool bInputDone = false;
+        for (;;)
+        {
+            char *pBase = reinterpret_cast<char *>(&out[0]);
+            char *pOut = pBase + nDone;
+            size_t nRoom = out.size() * sizeof(Char) - nDone;
+            // after the input, flush any pending shift sequence
+            size_t r = bInputDone
+                               ? iconv(m_Entry.Cd, nullptr, nullptr, &pOut, &nRoom)
+                               : iconv(m_Entry.Cd, &pIn, &nLeft, &pOut, &nRoom);
+            nDone = pOut - pBase;
+            if (r == (size_t) -1)
+            {
+                if (errno != E2BIG)
+                {
+                    out.clear();
+                    return false;
+                }
+                out.resize(out.size() * 2);
+                continue;
+            }
+            if (bInputDone) break;
+            bInputDone = true;
+        }
+        out.resize(nDone / sizeof(Char));
+        return true;
+    }
+};
+
+}// namespace
+
+void IconvCache::SetCapacity(size_t nCapacity)
+{
+    g_nIconvCapacity.store(nCapacity, std::memory_order_relaxed);
+    threadIconvCache().Trim(nCapacity);
+}
+
+size_t IconvCache::Capacity()
+{
+    return g_nIconvCapacity.load(std::memory_order_relaxed);
+}
+
+IconvCacheStats IconvCache::Stats()
+{
+    IconvCacheStats stats;
+    stats.Hits = g_nIconvHits.load(std::memory_order_relaxed);
+    stats.Misses = g_nIconvMisses.load(std::memory_order_relaxed);
+    stats.Evictions = g_nIconvEvictions.load(std::memory_order_relaxed);
+    stats.Cached = threadIconvCache().Entries.size();
+    return stats;
+}
+
+void IconvCache::ResetStats()
+{
+    g_nIconvHits.store(0, std::memory_order_relaxed);
+    g_nIconvMisses.store(0, std::memory_order_relaxed);
+    g_nIconvEvictions.store(0, std::memory_order_relaxed);
+}
+
+void IconvCache::Clear()
+{
+    IconvThreadCache &cache = threadIconvCache();
+    for (auto &entry: cache.Entries) iconv_close(entry.Cd);
+    cache.Entries.clear();
+}
+
 /* ------------------------------- CW2A impls ------------------------------- */
 
 CW2A::CW2A(const wchar_t *str) { Init(str, "UTF-8"); }
@@ -150,48 +406,29 @@ CW2A::operator std::string() const { return m_Str; }
 
 bool CW2A::Init(const wchar_t *str, const char *codepage)
 {
-    // Open iconv descriptor
-    iconv_t cd = iconv_open(codepage,
-                            sizeof(wchar_t) == 2 ? "UTF-16LE" : "UTF-32LE");
-    if (cd == (iconv_t) -1)
+    size_t nLen = std::wcslen(str);
+    if (isUtf8Encoding(codepage))
     {
-        return false;// Failed to open iconv
+        m_Str.resize(nLen * (sizeof(wchar_t) == 2 ? 3 : 4));
+        TranscodeResult result = wideToUtf8(str, nLen, &m_Str[0]);
+        m_Str.resize(result.Ok() ? result.Written : 0);
+        return result.Ok();
     }
 
-    // Length of wide-character string in bytes
-    size_t inBytes = std::wcslen(str) * sizeof(wchar_t);
-    // Assuming the worst case: UTF-8 encoding could take up to 4 times the bytes
-    size_t outBytes = inBytes * 4;
-
-    // Allocate buffer for output narrow string
-    char *outBuf = new char[outBytes];
-    char *inBuf = reinterpret_cast<char *>(const_cast<wchar_t *>(str));
-
-    char *outPtr = outBuf;
-    char *inPtr = inBuf;
-
-    // Perform the conversion
-    size_t result = iconv(cd, &inPtr, &inBytes, &outPtr, &outBytes);
-    if (result == (size_t) -1)
+    IconvLease cd(codepage, wideEncoding());
+    if (!cd.IsValid())
     {
-        iconv_close(cd);
-        delete[] outBuf;
-        return false;// Conversion failed
+        return false;// Failed to open iconv
     }
 
-    // Store the converted string
-    m_Str.assign(outBuf, outPtr - outBuf);
-
-    // Clean up
-    iconv_close(cd);
-    delete[] outBuf;
-    return true;
+    // Length of wide-character string in bytes
+    size_t inBytes = nLen * sizeof(wchar_t);
+    return cd.Convert(reinterpret_cast<const char *>(str), inBytes, m_Str);
 }
 
 bool CW2A::Init(const wchar_t *str, CodePageID eCodePage)
 {
-    // For simplicity, assume we convert to UTF-8 by default
-    return Init(str, "UTF-8");
+    return Init(str, CodePageToIconvEncoding(eCodePage).c_str());
 }
 
 CW2A &CW2A::operator=(const CW2A &rhs)
@@ -237,43 +474,26 @@ CA2W::operator std::wstring() const { return m_WStr; }
 
 bool CA2W::Init(const char *str, const char *codepage)
 {
-    // Open iconv descriptor for conversion from narrow string to wide string
-    iconv_t cd = iconv_open(sizeof(wchar_t) == 2 ? "UTF-16LE" : "UTF-32LE",
-                            codepage);
-    if (cd == (iconv_t) -1)
+    if (isUtf8Encoding(codepage))
     {
-        throw std::runtime_error("Failed to open iconv descriptor");
+        size_t nLen = std::strlen(str);
+        m_WStr.resize(nLen);
+        TranscodeResult result = utf8ToWide(str, nLen, &m_WStr[0]);
+        if (!result.Ok()) throwTranscodeError("UTF-8", result);
+        m_WStr.resize(result.Written);
+        return true;
     }
 
-    size_t inBytes =
-            std::strlen(str);// Length of narrow-character string in bytes
-    size_t outBytes =
-            inBytes * 2;// Assuming worst case for UTF-16 or other encodings
-
-    // Allocate buffer for output wide string (wchar_t)
-    char *outBuf = new char[outBytes];
-    char *inBuf = const_cast<char *>(str);
-
-    char *outPtr = outBuf;
-    char *inPtr = inBuf;
+    IconvLease cd(wideEncoding(), codepage);
+    if (!cd.IsValid())
+    {
+        throw std::runtime_error("Failed to open iconv descriptor");
+    }
 
-    // Perform the conversion
-    size_t result = iconv(cd, &inPtr, &inBytes, &outPtr, &outBytes);
-    if (result == (size_t) -1)
+    if (!cd.Convert(str, std::strlen(str), m_WStr))
     {
-        iconv_close(cd);
-        delete[] outBuf;
         throw std::runtime_error("iconv conversion failed");
     }
-
-    // Convert the narrow-character result into a wide string (wchar_t)
-    size_t wideLen = (outPtr - outBuf) / sizeof(wchar_t);
-    m_WStr.assign(reinterpret_cast<wchar_t *>(outBuf), wideLen);
-
-    // Clean up
-    iconv_close(cd);
-    delete[] outBuf;
-
     return true;
 }
 
@@ -298,27 +518,15 @@ std::string Encoding::ToUtf8(const char *str)
     if (!str) { throw std::invalid_argument("Input string is null"); }
 
     CodePageID local_id = LocalCodePage();
-    std::string toEncoding = CodePageToIconvEncoding(local_id);
-
-    iconv_t cd = iconv_open("UTF-8", toEncoding.c_str());
-    if (cd == (iconv_t) -1) { throw std::runtime_error("iconv_open failed"); }
+    IconvLease cd("UTF-8", CodePageToIconvEncoding(local_id).c_str());
+    if (!cd.IsValid()) { throw std::runtime_error("iconv_open failed"); }
 
-    size_t inBytesLeft = strlen(str);
-    size_t outBytesLeft = inBytesLeft * 4 + 4;
-    std::vector<char> outputBuffer(outBytesLeft);
-
-    char *inBuf = const_cast<char *>(str);
-    char *outBuf = outputBuffer.data();
-    char *outBufStart = outBuf;
-
-    if (iconv(cd, &inBuf, &inBytesLeft, &outBuf, &outBytesLeft) == (size_t) -1)
+    std::string result;
+    if (!cd.Convert(str, strlen(str), result))
     {
-        iconv_close(cd);
         throw std::runtime_error("iconv conversion failed");
     }
-
-    iconv_close(cd);
-    return std::string(outBufStart, outBuf - outBufStart);
+    return result;
 }
 
 std::string Encoding::ToUtf8(const wchar_t *str)
@@ -329,7 +537,7 @@ std::string Encoding::ToUtf8(const wchar_t *str)
 
 std::string Encoding::ToLocal(const wchar_t *str)
 {
-    CW2A cw2a(str);
+    CW2A cw2a(str, LocalCodePage());
     return cw2a.m_Str;
 }
 
@@ -349,59 +557,215 @@ std::wstring Encoding::LocalToUnicode(const char *str)
 
 std::string Encoding::ToLocal(const char *str)
 {
-    CodePageID local_id = LocalCodePage();
-    std::string encoding = CodePageToIconvEncoding(local_id);
     if (!str) { throw std::invalid_argument("Input string is null"); }
 
-    iconv_t cd = iconv_open(encoding.c_str(), "UTF-8");
-    if (cd == (iconv_t) -1) { throw std::runtime_error("iconv_open failed"); }
+    CodePageID local_id = LocalCodePage();
+    IconvLease cd(CodePageToIconvEncoding(local_id).c_str(), "UTF-8");
+    if (!cd.IsValid()) { throw std::runtime_error("iconv_open failed"); }
 
-    size_t inBytesLeft = strlen(str);
-    size_t outBytesLeft = inBytesLeft * 4 + 4;
-    std::vector<char> outputBuffer(outBytesLeft);
+    std::string result;
+    if (!cd.Convert(str, strlen(str), result))
+    {
+        throw std::runtime_error("iconv conversion failed");
+    }
+    return result;
+}
 
-    char *inBuf = const_cast<char *>(str);
-    char *outBuf = outputBuffer.data();
-    char *outBufStart = outBuf;
+size_t Encoding::Convert(std::string_view src, CodePageID eFrom, CodePageID eTo,
+                         char *dst, size_t nSize)
+{
+    if (eFrom == eTo)
+    {
+        size_t nTotal = 0;
+        putBounded(src.data(), src.size(), dst, nSize, nTotal);
+        return nTotal;
+    }
 
-    if (iconv(cd, &inBuf, &inBytesLeft, &outBuf, &outBytesLeft) == (size_t) -1)
+    IconvLease cd(CodePageToIconvEncoding(eTo).c_str(),
+                  CodePageToIconvEncoding(eFrom).c_str());
+    if (!cd.IsValid()) { throw std::runtime_error("iconv_open failed"); }
+    size_t nTotal = cd.ConvertInto(src.data(), src.size(), dst, nSize);
+    if (nTotal == std::string::npos)
     {
-        iconv_close(cd);
         throw std::runtime_error("iconv conversion failed");
     }
+    return nTotal;
+}
+
+size_t Encoding::Convert(std::string_view src, CodePageID eFrom, CodePageID eTo,
+                         ByteBuffer *pOut)
+{
+    if (!pOut) { throw std::invalid_argument("Output buffer is null"); }
+
+    // most conversions at most double the size; otherwise retry at the exact size
+    size_t nGuess = src.size() * 2 + 16;
+    char *dst = reinterpret_cast<char *>(
+            pOut->Allocate(static_cast<unsigned int>(nGuess)));
+    size_t nLen = Convert(src, eFrom, eTo, dst, nGuess);
+    if (nLen > nGuess)
+    {
+        dst = reinterpret_cast<char *>(
+                pOut->Allocate(static_cast<unsigned int>(nLen)));
+        Convert(src, eFrom, eTo, dst, nLen);
+    }
+    pOut->Allocate(static_cast<unsigned int>(nLen));
+    return nLen;
+}
+
+size_t Encoding::Convert(std::wstring_view src, CodePageID eTo, char *dst,
+                         size_t nSize)
+{
+    if (eTo != CP_UTF8)
+    {
+        IconvLease cd(CodePageToIconvEncoding(eTo).c_str(), wideEncoding());
+        if (!cd.IsValid()) { throw std::runtime_error("iconv_open failed"); }
+        size_t nTotal = cd.ConvertInto(reinterpret_cast<const char *>(src.data()),
+                                       src.size() * sizeof(wchar_t), dst, nSize);
+        if (nTotal == std::string::npos)
+        {
+            throw std::runtime_error("iconv conversion failed");
+        }
+        return nTotal;
+    }
+
+    const size_t nMaxBytes = sizeof(wchar_t) == 2 ? 3 : 4;
+    if (src.size() * nMaxBytes <= nSize)
+    {
+        TranscodeResult result = wideToUtf8(src.data(), src.size(), dst);
+        if (!result.Ok()) throwTranscodeError("wide string", result);
+        return result.Written;
+    }
+
+    // the result may not fit: convert in pieces to find its length
+    char scratch[1024];
+    const size_t nPiece = sizeof(scratch) / nMaxBytes;
+    size_t nTotal = 0;
+    size_t i = 0;
+    while (i < src.size())
+    {
+        size_t nLen = std::min(src.size() - i, nPiece);
+        TranscodeResult result = wideToUtf8(src.data() + i, nLen, scratch);
+        // a surrogate pair split by the end of the piece is completed by the next one
+        bool bSplit = result.Status == TranscodeStatus::eSurrogate &&
+                      result.Read + 1 == nLen && i + nLen < src.size();
+        if (!result.Ok() && !bSplit)
+        {
+            result.Read += i;
+            throwTranscodeError("wide string", result);
+        }
+        putBounded(scratch, result.Written, dst, nSize, nTotal);
+        i += result.Read;
+    }
+    return nTotal;
+}
+
+size_t Encoding::Convert(std::string_view src, CodePageID eFrom, wchar_t *dst,
+                         size_t nSize)
+{
+    if (eFrom != CP_UTF8)
+    {
+        IconvLease cd(wideEncoding(), CodePageToIconvEncoding(eFrom).c_str());
+        if (!cd.IsValid()) { throw std::runtime_error("iconv_open failed"); }
+        size_t nTotal = cd.ConvertInto(src.data(), src.size(),
+                                       reinterpret_cast<char *>(dst),
+                                       nSize * sizeof(wchar_t));
+        if (nTotal == std::string::npos)
+        {
+            throw std::runtime_error("iconv conversion failed");
+        }
+        return nTotal / sizeof(wchar_t);
+    }
 
-    iconv_close(cd);
-    return std::string(outBufStart, outBuf - outBufStart);
+    if (src.size() <= nSize)
+    {
+        TranscodeResult result = utf8ToWide(src.data(), src.size(), dst);
+        if (!result.Ok()) throwTranscodeError("UTF-8", result);
+        return result.Written;
+    }
+
+    // the result may not fit: convert in pieces to find its length
+    wchar_t scratch[256];
+    size_t nTotal = 0;
+    size_t i = 0;
+    while (i < src.size())
+    {
+        size_t nLen = std::min(src.size() - i, sizeof(scratch) / sizeof(wchar_t));
+        TranscodeResult result = utf8ToWide(src.data() + i, nLen, scratch);
+        // a sequence split by the end of the piece is completed by the next one
+        bool bSplit = result.Status == TranscodeStatus::eTruncated &&
+                      result.Read + 4 > nLen && i + nLen < src.size();
+        if (!result.Ok() && !bSplit)
+        {
+            result.Read += i;
+            throwTranscodeError("UTF-8", result);
+        }
+        putBounded(scratch, result.Written, dst, nSize, nTotal);
+        i += result.Read;
+    }
+    return nTotal;
 }
 
 /* ------------------------------- Utf8 impls ------------------------------- */
 
-Utf8::Utf8(const char *ori) : m_Ori(ori) { m_Utf = Encoding::ToUtf8(ori); }
+Utf8::Utf8(const char *ori) : m_Ori(ori) {}
+
+Utf8::Utf8(const std::string &ori)
+    : m_Ori(nullptr),
+      m_Utf(LocalCodePage() == CP_UTF8 ? ori : Encoding::ToUtf8(ori.c_str())),
+      m_bConverted(true)
+{
+}
 
-Utf8::Utf8(const std::string &ori) : m_Ori(ori.c_str())
+const char *Utf8::Result()
 {
-    m_Utf = Encoding::ToUtf8(ori.c_str());
+    if (!m_bConverted)
+    {
+        if (!m_Ori) { throw std::invalid_argument("Input string is null"); }
+        if (LocalCodePage() == CP_UTF8) return m_Ori;
+        m_Utf = Encoding::ToUtf8(m_Ori);
+        m_bConverted = true;
+    }
+    return m_Utf.c_str();
 }
 
-Utf8::operator const char *() { return m_Utf.c_str(); }
+Utf8::operator const char *() { return Result(); }
 
-Utf8::operator std::string() { return m_Utf; }
+Utf8::operator std::string() { return Result(); }
+
+std::string Utf8::Str() { return Result(); }
+
+bool Utf8::Validate(std::string_view str)
+{
+    return Transcoder::ValidateUtf8(str.data(), str.size()).Ok();
+}
 
-std::string Utf8::Str() { return m_Utf; }
 
+Local::Local(const char *ori) : m_Ori(ori) {}
 
-Local::Local(const char *ori) : m_Ori(ori) { m_Utf = Encoding::ToLocal(ori); }
+Local::Local(const std::string &ori)
+    : m_Ori(nullptr),
+      m_Utf(LocalCodePage() == CP_UTF8 ? ori : Encoding::ToLocal(ori.c_str())),
+      m_bConverted(true)
+{
+}
 
-Local::Local(const std::string &ori) : m_Ori(ori.c_str())
+const char *Local::Result()
 {
-    m_Utf = Encoding::ToLocal(ori.c_str());
+    if (!m_bConverted)
+    {
+        if (!m_Ori) { throw std::invalid_argument("Input string is null"); }
+        if (LocalCodePage() == CP_UTF8) return m_Ori;
+        m_Utf = Encoding::ToLocal(m_Ori);
+        m_bConverted = true;
+    }
+    return m_Utf.c_str();
 }
 
-Local::operator const char *() { return m_Utf.c_str(); }
+Local::operator const char *() { return Result(); }
 
-Local::operator std::string() { return m_Utf; }
+Local::operator std::string() { return Result(); }
 
-std::string Local::Str() { return m_Utf; }
+std::string Local::Str() { return Result(); }
 
 /* ---------------------------- StringHelp impls ---------------------------- */
 
@@ -433,160 +797,322 @@ static void doubleToStr(char *buffer, int bufferSize, double value,
     builder.Finalize();
 }
 
-static std::string &replaceInPlace(std::string &str,
-                                   const std::string::value_type from,
-                                   const std::string::value_type to = 0,
-                                   std::string::size_type start = 0)
+/// Shortest round-trip text of a number split into parts, so that precision,
+/// thousands separators and width can be applied while writing instead of by
+/// editing a string.
+struct NumberLayout
 {
-    if (from == to) return str;
-
-    std::string::size_type pos = 0;
-    do {
-        pos = str.find(from, start);
-        if (pos != std::string::npos)
+    char Text[64];       ///< shortest round-trip text
+    char Digits[66];     ///< integer digits then fraction digits, after a
+                         ///< spare slot for a rounding carry
+    size_t nDigitsBegin; ///< 0 when rounding carried into the spare slot
+    size_t nInt;         ///< number of integer digits
+    size_t nFrac;        ///< number of fraction digits kept
+    size_t nZeros;       ///< zeros appended to reach the precision
+    size_t nSeps;        ///< thousands separators in the integer part
+    size_t nPad;         ///< leading spaces to reach the width
+    size_t nTotal;       ///< total length of the output
+    const char *pTail;   ///< exponent, or the text of inf and nan
+    size_t nTail;
+    bool bNegative;
+    bool bPoint;
+};
+
+static void layoutText(NumberLayout &l, int precision, int width, char thSep)
+{
+    const char *p = l.Text;
+    const char *pEnd = p + std::strlen(p);
+    l.bNegative = *p == '-';
+    if (l.bNegative) ++p;
+
+    const char *pMantEnd = p;
+    while (pMantEnd != pEnd && *pMantEnd != 'e' && *pMantEnd != 'E')
+        ++pMantEnd;
+    if (p == pMantEnd || !std::isdigit(static_cast<unsigned char>(*p)))
+        pMantEnd = p;// inf, nan
+    const char *pDot = std::find(p, pMantEnd, '.');
+
+    l.nDigitsBegin = 1;
+    l.nInt = pDot - p;
+    l.nFrac = pDot == pMantEnd ? 0 : pMantEnd - pDot - 1;
+    l.nZeros = 0;
+    l.bPoint = pDot != pMantEnd;
+    l.pTail = pMantEnd;
+    l.nTail = pEnd - pMantEnd;
+    l.Digits[0] = '0';
+    std::memcpy(l.Digits + 1, p, l.nInt);
+    std::memcpy(l.Digits + 1 + l.nInt, pDot + 1, l.nFrac);
+
+    size_t nPrecision = precision > 0 ? static_cast<size_t>(precision) : 0;
+    if (nPrecision && l.nInt)
+    {
+        l.bPoint = true;
+        if (l.nFrac < nPrecision) { l.nZeros = nPrecision - l.nFrac; }
+        else if (l.nFrac > nPrecision)
         {
-            if (to) str[pos] = to;
-            else
-                str.erase(pos, 1);
+            bool bRoundUp = l.Digits[1 + l.nInt + nPrecision] >= '5';
+            l.nFrac = nPrecision;
+            if (bRoundUp)
+            {
+                size_t i = l.nInt + l.nFrac;
+                for (; i > 0; --i)
+                {
+                    if (l.Digits[i] != '9')
+                    {
+                        ++l.Digits[i];
+                        break;
+                    }
+                    l.Digits[i] = '0';
+                }
+                if (i == 0)
+                {
+                    l.Digits[0] = '1';
+                    l.nDigitsBegin = 0;
+                    ++l.nInt;
+                }
+            }
         }
-    } while (pos != std::string::npos);
+    }
 
-    return str;
+    l.nSeps = thSep && l.nInt ? (l.nInt - 1) / 3 : 0;
+    l.nTotal = l.bNegative + l.nInt + l.nSeps + l.nTail +
+               (l.bPoint ? 1 + l.nFrac + l.nZeros : 0);
+    size_t nWidth = width > 0 ? static_cast<size_t>(width) : 0;
+    l.nPad = nWidth > l.nTotal ? nWidth - l.nTotal : 0;
+    l.nTotal += l.nPad;
+}
+
+static void layoutNumber(NumberLayout &l, float v, int precision, int width,
+                         char thSep)
+{
+    if (precision == 0) v = std::floor(v);
+    floatToStr(l.Text, sizeof(l.Text), v);
+    layoutText(l, precision, width, thSep);
 }
 
-static void pad(std::string &str, int precision, int width, char prefix = ' ',
-                char decSep = '.')
+static void layoutNumber(NumberLayout &l, double v, int precision, int width,
+                         char thSep)
 {
-    // these cases should never happen, if they do, it's a library bug
-    assert(precision > 0);
-    assert(str.length());
+    if (precision == 0) v = std::floor(v);
+    doubleToStr(l.Text, sizeof(l.Text), v);
+    layoutText(l, precision, width, thSep);
+}
 
-    std::string::size_type decSepPos = str.find(decSep);
-    if (decSepPos == std::string::npos)
+template<class Sink>
+static void writeNumber(const NumberLayout &l, char thSep, char decSep,
+                        Sink &sink)
+{
+    sink.Fill(' ', l.nPad);
+    if (l.bNegative) sink.Write("-", 1);
+    const char *pDigits = l.Digits + l.nDigitsBegin;
+    size_t nHead = l.nInt - 3 * l.nSeps;
+    sink.Write(pDigits, nHead);
+    for (size_t i = nHead; i < l.nInt; i += 3)
+    {
+        sink.Write(&thSep, 1);
+        sink.Write(pDigits + i, 3);
+    }
+    if (l.bPoint)
     {
-        str.append(1, decSep);
-        decSepPos = str.size() - 1;
+        sink.Write(&decSep, 1);
+        sink.Write(pDigits + l.nInt, l.nFrac);
+        sink.Fill('0', l.nZeros);
     }
+    sink.Write(l.pTail, l.nTail);
+}
 
-    std::string::size_type frac = str.length() - decSepPos - 1;
+struct StringSink
+{
+    std::string &Str;
+    void Write(const char *p, size_t n) { Str.append(p, n); }
+    void Fill(char c, size_t n) { Str.append(n, c); }
+};
+
+struct CharSink
+{
+    char *Ptr;
+    void Write(const char *p, size_t n)
+    {
+        std::memcpy(Ptr, p, n);
+        Ptr += n;
+    }
+    void Fill(char c, size_t n)
+    {
+        std::memset(Ptr, c, n);
+        Ptr += n;
+    }
+};
 
-    std::string::size_type ePos = str.find_first_of("eE");
-    std::unique_ptr<std::string> eStr;
-    if (ePos != std::string::npos)
+struct ByteBufferSink
+{
+    ByteBuffer &Buffer;
+    void Write(const char *p, size_t n)
     {
-        eStr.reset(new std::string(str.substr(ePos, std::string::npos)));
-        frac -= eStr->length();
-        str = str.substr(0, str.length() - eStr->length());
+        if (n) Buffer.Append(reinterpret_cast<const unsigned char *>(p), (int) n);
     }
+    void Fill(char c, size_t n)
+    {
+        char block[32];
+        std::memset(block, c, sizeof(block));
+        for (; n > sizeof(block); n -= sizeof(block))
+            Write(block, sizeof(block));
+        Write(block, n);
+    }
+};
+
+template<class T>
+static void appendNumber(std::string &str, T v, int precision, int width,
+                         char thSep, char decSep)
+{
+    NumberLayout l;
+    layoutNumber(l, v, precision, width, thSep);
+    str.reserve(str.size() + l.nTotal);
+    StringSink sink{str};
+    writeNumber(l, thSep, decSep ? decSep : '.', sink);
+}
 
-    if (frac != precision)
+template<class T>
+static void appendNumber(ByteBuffer &buffer, T v, int precision, int width,
+                         char thSep, char decSep)
+{
+    NumberLayout l;
+    layoutNumber(l, v, precision, width, thSep);
+    if (!decSep) decSep = '.';
+    char text[128];
+    if (l.nTotal <= sizeof(text))
     {
-        if (frac < precision) { str.append(precision - frac, '0'); }
-        else if ((frac > precision) && (decSepPos != std::string::npos))
-        {
-            int pos = static_cast<int>(decSepPos) + 1 + precision;
-            if (str[pos] >= '5')// we must round up
-            {
-                char carry = 0;
-                if (str[--pos] == '9')
-                {
-                    str[pos] = '0';
-                    carry = 1;
-                }
-                else
-                {
-                    ++str[pos];
-                    carry = 0;
-                }
-                while (--pos >= 0)
-                {
-                    if (str[pos] == decSep) continue;
-                    if (carry)
-                    {
-                        if ((str[pos] + carry) <= '9')
-                        {
-                            ++str[pos];
-                            carry = 0;
-                        }
-                        else
-                        {
-                            str[pos] = '0';
-                            carry = 1;
-                        }
-                    }
-                }
-                if (carry) str.insert(str.begin(), 1, '1');
-            }
-            str = str.substr(0, decSepPos + 1 + precision);
-        }
+        CharSink sink{text};
+        writeNumber(l, thSep, decSep, sink);
+        buffer.Append(reinterpret_cast<const unsigned char *>(text),
+                      (int) l.nTotal);
+        return;
     }
+    ByteBufferSink sink{buffer};
+    writeNumber(l, thSep, decSep, sink);
+}
 
-    if (eStr.get()) str += *eStr;
+template<class T>
+static size_t appendNumber(char *buf, size_t nSize, T v, int precision,
+                           int width, char thSep, char decSep)
+{
+    NumberLayout l;
+    layoutNumber(l, v, precision, width, thSep);
+    if (!buf || l.nTotal > nSize) return 0;
+    CharSink sink{buf};
+    writeNumber(l, thSep, decSep ? decSep : '.', sink);
+    return l.nTotal;
+}
 
-    if (width && (str.length() < width))
-        str.insert(str.begin(), width - str.length(), prefix);
+template<class T>
+static size_t integerText(char (&buf)[StringHelp::MaxIntegerLength], T v)
+{
+    return std::to_chars(buf, buf + sizeof(buf), v).ptr - buf;
 }
 
+template<class T>
+static size_t appendInteger(char *buf, size_t nSize, T v)
+{
+    char text[StringHelp::MaxIntegerLength];
+    size_t n = integerText(text, v);
+    if (!buf || n > nSize) return 0;
+    std::memcpy(buf, text, n);
+    return n;
+}
 
-static void insertThousandSep(std::string &str, char thSep, char decSep = '.')
+static inline unsigned char asciiLower(unsigned char c)
 {
-    assert(decSep != thSep);
-    if (str.size() == 0) return;
+    return static_cast<unsigned char>(c - 'A') < 26 ? c | 0x20 : c;
+}
 
-    std::string::size_type exPos = str.find('e');
-    if (exPos == std::string::npos) exPos = str.find('E');
-    std::string::size_type decPos = str.find(decSep);
-    // there's no rinsert, using forward iterator to go backwards
-    std::string::iterator it = str.end();
-    if (exPos != std::string::npos) it -= str.size() - exPos;
+static inline unsigned char asciiUpper(unsigned char c)
+{
+    return static_cast<unsigned char>(c - 'a') < 26 ? c & ~0x20 : c;
+}
 
-    if (decPos != std::string::npos)
-    {
-        while (it != str.begin())
-        {
-            --it;
-            if (*it == decSep) break;
-        }
-    }
-    int thCount = 0;
-    if (it == str.end()) --it;
-    for (; it != str.begin();)
-    {
-        std::string::iterator pos = it;
-        std::string::value_type chr = *it;
-        std::string::value_type prevChr = *--it;
+static inline bool isSpace(char c)
+{
+    return c == ' ' || static_cast<unsigned char>(c - '\t') < 5;
+}
 
-        if (!std::isdigit(chr)) continue;
+/// Lower-cases a byte; bytes outside ASCII follow the current C locale.
+static inline unsigned char foldLower(unsigned char c)
+{
+    return c < 0x80 ? asciiLower(c) : static_cast<unsigned char>(std::tolower(c));
+}
 
-        if (++thCount == 3 && std::isdigit(prevChr))
-            it = str.insert(pos, thSep);
+static inline unsigned char foldUpper(unsigned char c)
+{
+    return c < 0x80 ? asciiUpper(c) : static_cast<unsigned char>(std::toupper(c));
+}
 
-        if (thCount == 3) thCount = 0;
+static bool equalsNoCase(const char *a, const char *b, size_t nLen)
+{
+    for (size_t i = Simd::EqualPrefixNoCase(a, b, nLen); i < nLen; ++i)
+    {
+        if (foldLower(a[i]) != foldLower(b[i])) return false;
     }
+    return true;
 }
 
+/// Converts the case of a string block-wise, handling bytes outside ASCII one
+/// at a time.
+static void convertCase(const char *src, size_t nLen, char *dst, bool bUpper)
+{
+    size_t i = 0;
+    while (i < nLen)
+    {
+        i += Simd::ConvertAsciiCase(src + i, nLen - i, dst + i, bUpper);
+        if (i == nLen) break;
+        unsigned char c = static_cast<unsigned char>(src[i]);
+        dst[i++] = static_cast<char>(bUpper ? foldUpper(c) : foldLower(c));
+    }
+}
 
 int StringHelp::Compare(const char *strA, const char *strB, bool bIgnoreCase)
 {
     if (!strA || !strB) { return (strA == strB) ? 0 : (strA ? 1 : -1); }
+    return Compare(std::string_view(strA), std::string_view(strB),
+                   bIgnoreCase);
+}
+
+int StringHelp::Compare(std::string_view strA, std::string_view strB,
+                        bool bIgnoreCase)
+{
     if (bIgnoreCase) { return CompareNoCase(strA, strB); }
-    return strcmp(strA, strB);
+    return strA.compare(strB);
 }
 
 int StringHelp::CompareNoCase(const char *strA, const char *strB)
 {
-#if defined(_WIN32) || defined(_WIN64)
-    return _stricmp(strA, strB);
-#else
-    return strcasecmp(strA, strB);
-#endif
+    return CompareNoCase(std::string_view(strA), std::string_view(strB));
+}
+
+int StringHelp::CompareNoCase(std::string_view strA, std::string_view strB)
+{
+    size_t nLen = std::min(strA.size(), strB.size());
+    size_t i = Simd::EqualPrefixNoCase(strA.data(), strB.data(), nLen);
+    for (; i < nLen; ++i)
+    {
+        int d = foldLower(strA[i]) - foldLower(strB[i]);
+        if (d) return d;
+    }
+    return strA.size() < strB.size() ? -1 : (strA.size() > strB.size());
 }
 
 bool StringHelp::IsEqual(const char *strA, const char *strB, bool bIgnoreCase)
 {
     if (!strA || !strB) { return strA == strB; }
-    if (bIgnoreCase) { return CompareNoCase(strA, strB) == 0; }
-    return strcmp(strA, strB) == 0;
+    return IsEqual(std::string_view(strA), std::string_view(strB),
+                   bIgnoreCase);
+}
+
+bool StringHelp::IsEqual(std::string_view strA, std::string_view strB,
+                         bool bIgnoreCase)
+{
+    if (strA.size() != strB.size()) return false;
+    if (bIgnoreCase)
+        return equalsNoCase(strA.data(), strB.data(), strA.size());
+    return strA == strB;
 }
 
 std::string StringHelp::ToString(const char *str)
@@ -620,19 +1146,7 @@ std::string StringHelp::ToString(float v, int precision, int width, char thSep,
                                  char decSep)
 {
     std::string str;
-    if (!decSep) decSep = '.';
-    if (precision == 0) v = std::floor(v);
-
-    char buffer[780];
-    floatToStr(buffer, 780, v);
-    str = buffer;
-
-    if (decSep && (decSep != '.') && (str.find('.') != std::string::npos))
-        replaceInPlace(str, '.', decSep);
-
-    if (thSep) insertThousandSep(str, thSep, decSep);
-    if (precision > 0 || width)
-        pad(str, precision, width, ' ', decSep ? decSep : '.');
+    AppendTo(str, v, precision, width, thSep, decSep);
     return str;
 }
 
@@ -640,21 +1154,166 @@ std::string StringHelp::ToString(double v, int precision, int width, char thSep,
                                  char decSep)
 {
     std::string str;
-    if (!decSep) decSep = '.';
-    if (precision == 0) v = std::floor(v);
+    AppendTo(str, v, precision, width, thSep, decSep);
+    return str;
+}
+
+void StringHelp::AppendTo(std::string &str, int v)
+{
+    char text[MaxIntegerLength];
+    str.append(text, integerText(text, v));
+}
 
-    char buffer[780];
-    doubleToStr(buffer, 780, v);
+void StringHelp::AppendTo(std::string &str, unsigned int v)
+{
+    char text[MaxIntegerLength];
+    str.append(text, integerText(text, v));
+}
 
-    str = buffer;
+void StringHelp::AppendTo(std::string &str, long v)
+{
+    char text[MaxIntegerLength];
+    str.append(text, integerText(text, v));
+}
 
-    if (decSep && (decSep != '.') && (str.find('.') != std::string::npos))
-        replaceInPlace(str, '.', decSep);
+void StringHelp::AppendTo(std::string &str, unsigned long v)
+{
+    char text[MaxIntegerLength];
+    str.append(text, integerText(text, v));
+}
 
-    if (thSep) insertThousandSep(str, thSep, decSep);
-    if (precision > 0 || width)
-        pad(str, precision, width, ' ', decSep ? decSep : '.');
-    return str;
+void StringHelp::AppendTo(std::string &str, long long v)
+{
+    char text[MaxIntegerLength];
+    str.append(text, integerText(text, v));
+}
+
+void StringHelp::AppendTo(std::string &str, unsigned long long v)
+{
+    char text[MaxIntegerLength];
+    str.append(text, integerText(text, v));
+}
+
+void StringHelp::AppendTo(std::string &str, char c) { str += c; }
+
+void StringHelp::AppendTo(std::string &str, float v, int precision, int width,
+                          char thSep, char decSep)
+{
+    appendNumber(str, v, precision, width, thSep, decSep);
+}
+
+void StringHelp::AppendTo(std::string &str, double v, int precision, int width,
+                          char thSep, char decSep)
+{
+    appendNumber(str, v, precision, width, thSep, decSep);
+}
+
+void StringHelp::AppendTo(ByteBuffer &buffer, int v)
+{
+    char text[MaxIntegerLength];
+    buffer.Append(reinterpret_cast<const unsigned char *>(text),
+                  (int) integerText(text, v));
+}
+
+void StringHelp::AppendTo(ByteBuffer &buffer, unsigned int v)
+{
+    char text[MaxIntegerLength];
+    buffer.Append(reinterpret_cast<const unsigned char *>(text),
+                  (int) integerText(text, v));
+}
+
+void StringHelp::AppendTo(ByteBuffer &buffer, long v)
+{
+    char text[MaxIntegerLength];
+    buffer.Append(reinterpret_cast<const unsigned char *>(text),
+                  (int) integerText(text, v));
+}
+
+void StringHelp::AppendTo(ByteBuffer &buffer, unsigned long v)
+{
+    char text[MaxIntegerLength];
+    buffer.Append(reinterpret_cast<const unsigned char *>(text),
+                  (int) integerText(text, v));
+}
+
+void StringHelp::AppendTo(ByteBuffer &buffer, long long v)
+{
+    char text[MaxIntegerLength];
+    buffer.Append(reinterpret_cast<const unsigned char *>(text),
+                  (int) integerText(text, v));
+}
+
+void StringHelp::AppendTo(ByteBuffer &buffer, unsigned long long v)
+{
+    char text[MaxIntegerLength];
+    buffer.Append(reinterpret_cast<const unsigned char *>(text),
+                  (int) integerText(text, v));
+}
+
+void StringHelp::AppendTo(ByteBuffer &buffer, char c)
+{
+    buffer.Append(reinterpret_cast<const unsigned char *>(&c), 1);
+}
+
+void StringHelp::AppendTo(ByteBuffer &buffer, float v, int precision,
+                          int width, char thSep, char decSep)
+{
+    appendNumber(buffer, v, precision, width, thSep, decSep);
+}
+
+void StringHelp::AppendTo(ByteBuffer &buffer, double v, int precision,
+                          int width, char thSep, char decSep)
+{
+    appendNumber(buffer, v, precision, width, thSep, decSep);
+}
+
+size_t StringHelp::AppendTo(char *buf, size_t nSize, int v)
+{
+    return appendInteger(buf, nSize, v);
+}
+
+size_t StringHelp::AppendTo(char *buf, size_t nSize, unsigned int v)
+{
+    return appendInteger(buf, nSize, v);
+}
+
+size_t StringHelp::AppendTo(char *buf, size_t nSize, long v)
+{
+    return appendInteger(buf, nSize, v);
+}
+
+size_t StringHelp::AppendTo(char *buf, size_t nSize, unsigned long v)
+{
+    return appendInteger(buf, nSize, v);
+}
+
+size_t StringHelp::AppendTo(char *buf, size_t nSize, long long v)
+{
+    return appendInteger(buf, nSize, v);
+}
+
+size_t StringHelp::AppendTo(char *buf, size_t nSize, unsigned long long v)
+{
+    return appendInteger(buf, nSize, v);
+}
+
+size_t StringHelp::AppendTo(char *buf, size_t nSize, char c)
+{
+    if (!buf || nSize < 1) return 0;
+    buf[0] = c;
+    return 1;
+}
+
+size_t StringHelp::AppendTo(char *buf, size_t nSize, float v, int precision,
+                            int width, char thSep, char decSep)
+{
+    return appendNumber(buf, nSize, v, precision, width, thSep, decSep);
+}
+
+size_t StringHelp::AppendTo(char *buf, size_t nSize, double v, int precision,
+                            int width, char thSep, char decSep)
+{
+    return appendNumber(buf, nSize, v, precision, width, thSep, decSep);
 }
 
 std::string StringHelp::ToString(bool v) { return v ? "true" : "false"; }
@@ -666,19 +1325,28 @@ std::string StringHelp::ToString(const unsigned char *blob, int nLen)
 
 std::string StringHelp::Format(int nMaxLen, const char *format, ...)
 {
-    if (!format || nMaxLen <= 0) { return ""; }
+    if (!format) { return ""; }
+    if (nMaxLen < 0) { nMaxLen = 0; }
 
     std::string result;
     result.resize(nMaxLen);
 
     va_list args;
     va_start(args, format);
+    va_list retry;
+    va_copy(retry, args);
     int len = std::vsnprintf(result.data(), nMaxLen + 1, format, args);
     va_end(args);
 
-    if (len < 0) { return ""; }
+    if (len > nMaxLen)
+    {
+        // the hint was too small, format again into a buffer of the exact size
+        result.resize(len);
+        len = std::vsnprintf(result.data(), len + 1, format, retry);
+    }
+    va_end(retry);
 
-    if (len > nMaxLen) { len = nMaxLen; }
+    if (len < 0) { return ""; }
 
     result.resize(len);
     return result;
@@ -696,165 +1364,769 @@ bool StringHelp::IsNullOrEmpty(const wchar_t *str)
 
 std::vector<std::string> StringHelp::Split(const char *str, const char *strSep)
 {
-    std::vector<std::string> result;
-
-    if (!str || !strSep || *str == '\0' || *strSep == '\0') { return result; }
+    if (!str || !strSep) { return std::vector<std::string>(); }
+    return Split(std::string_view(str), std::string_view(strSep));
+}
 
-    const char *start = str;
-    const char *pos = nullptr;
+std::vector<std::string> StringHelp::Split(const char *str, char sp)
+{
+    if (!str) { return std::vector<std::string>(); }
+    return Split(std::string_view(str), sp);
+}
 
-    while ((pos = std::strstr(start, strSep)) != nullptr)
-    {
-        result.emplace_back(start, pos - start);
-        start = pos + std::strlen(strSep);
-    }
+std::vector<std::string> StringHelp::Split(std::string_view str,
+                                           std::string_view strSep)
+{
+    std::vector<std::string_view> parts;
+    Split(str, strSep, parts);
+    return std::vector<std::string>(parts.begin(), parts.end());
+}
 
-    result.emplace_back(start);
-    return result;
+std::vector<std::string> StringHelp::Split(std::string_view str, char sp)
+{
+    std::vector<std::string_view> parts;
+    Split(str, sp, parts);
+    return std::vector<std::string>(parts.begin(), parts.end());
 }
 
-std::vector<std::string> StringHelp::Split(const char *str, char sp)
+void StringHelp::Split(std::string_view str, std::string_view strSep,
+                       std::vector<std::string_view> &parts)
 {
-    std::vector<std::string> result;
+    parts.clear();
+    if (strSep.empty()) { return; }
 
-    if (!str || *str == '\0') { return result; }
+    Tokenizer tokenizer(str, strSep);
+    std::string_view token;
+    while (tokenizer.Next(token)) parts.push_back(token);
+}
 
-    const char *start = str;
-    const char *pos = nullptr;
+void StringHelp::Split(std::string_view str, char sp,
+                       std::vector<std::string_view> &parts)
+{
+    parts.clear();
+    Tokenizer tokenizer(str, sp);
+    std::string_view token;
+    while (tokenizer.Next(token)) parts.push_back(token);
+}
 
-    while ((pos = std::strchr(start, sp)) != nullptr)
-    {
-        result.emplace_back(start, pos - start);
-        start = pos + 1;
-    }
+std::string StringHelp::Replace(const char *str, const char *src,
+                                const char *dst)
+{
+    if (!str) { return std::string(); }
+    if (!src || !dst) { return std::string(str); }
+    return Replace(std::string_view(str), std::string_view(src),
+                   std::string_view(dst));
+}
 
-    result.emplace_back(start);
+std::string StringHelp::Replace(std::string_view str, std::string_view src,
+                                std::string_view dst)
+{
+    std::string result;
+    Replace(str, src, dst, result);
     return result;
 }
 
-std::string StringHelp::Replace(const char *str, const char *src,
-                                const char *dst)
+void StringHelp::Replace(std::string_view str, std::string_view src,
+                         std::string_view dst, std::string &out)
 {
-    if (!str || !src || !dst || *str == '\0' || *src == '\0')
+    out.clear();
+    if (src.empty())
     {
-        return str ? std::string(str) : std::string();
+        out.append(str);
+        return;
     }
 
-    std::string result;
-    const char *start = str;
-    const char *pos = nullptr;
-    size_t srcLen = std::strlen(src);
-    size_t dstLen = std::strlen(dst);
-
-    while ((pos = std::strstr(start, src)) != nullptr)
+    Searcher searcher(src);
+    size_t start = 0;
+    size_t pos;
+    while ((pos = searcher.Find(str, start)) != std::string_view::npos)
     {
-        result.append(start, pos - start);
-        result.append(dst);
-        start = pos + srcLen;
+        out.append(str.data() + start, pos - start);
+        out.append(dst);
+        start = pos + src.size();
     }
+    out.append(str.data() + start, str.size() - start);
+}
 
-    result.append(start);
-    return result;
+std::string StringHelp::Trim(const char *str)
+{
+    return str ? std::string(Trim(std::string_view(str))) : std::string();
+}
+
+std::string StringHelp::TrimLeft(const char *str)
+{
+    return str ? std::string(TrimLeft(std::string_view(str))) : std::string();
 }
 
-std::string StringHelp::Trim(const char *str) { return std::string(); }
+std::string StringHelp::TrimRight(const char *str)
+{
+    return str ? std::string(TrimRight(std::string_view(str))) : std::string();
+}
+
+std::string_view StringHelp::Trim(std::string_view str)
+{
+    return TrimRight(TrimLeft(str));
+}
 
-std::string StringHelp::TrimLeft(const char *str) { return std::string(); }
+std::string_view StringHelp::TrimLeft(std::string_view str)
+{
+    size_t i = 0;
+    while (i < str.size() && isSpace(str[i])) ++i;
+    return str.substr(i);
+}
 
-std::string StringHelp::TrimRight(const char *str) { return std::string(); }
+std::string_view StringHelp::TrimRight(std::string_view str)
+{
+    size_t n = str.size();
+    while (n > 0 && isSpace(str[n - 1])) --n;
+    return str.substr(0, n);
+}
 
 bool StringHelp::StartWith(const char *str, const char *strHead,
                            bool bIgnoringCase)
 {
-    return false;
+    if (!str || !strHead) { return false; }
+    return StartWith(std::string_view(str), std::string_view(strHead),
+                     bIgnoringCase);
 }
 
 bool StringHelp::EndWith(const char *str, const char *strTail,
                          bool bIgnoringCase)
 {
-    return false;
+    if (!str || !strTail) { return false; }
+    return EndWith(std::string_view(str), std::string_view(strTail),
+                   bIgnoringCase);
+}
+
+bool StringHelp::StartWith(std::string_view str, std::string_view strHead,
+                           bool bIgnoringCase)
+{
+    if (strHead.size() > str.size()) { return false; }
+    return IsEqual(str.substr(0, strHead.size()), strHead, bIgnoringCase);
+}
+
+bool StringHelp::EndWith(std::string_view str, std::string_view strTail,
+                         bool bIgnoringCase)
+{
+    if (strTail.size() > str.size()) { return false; }
+    return IsEqual(str.substr(str.size() - strTail.size()), strTail,
+                   bIgnoringCase);
 }
 
 bool StringHelp::IsMatch(const char *pattern, const char *str, bool bIgnoreCase)
 {
-    return false;
+    if (!pattern || !str) { return false; }
+
+    // Translate the wildcard pattern into an anchored regular expression;
+    // compiled forms are shared through the Regex cache.
+    std::string regex = "\\A";
+    for (const char *p = pattern; *p; ++p)
+    {
+        switch (*p)
+        {
+            case '*':
+                regex += ".+";
+                break;
+            case '?':
+                regex += '.';
+                break;
+            case '\\':
+            case '^':
+            case '$':
+            case '.':
+            case '|':
+            case '+':
+            case '(':
+            case ')':
+            case '[':
+            case ']':
+            case '{':
+            case '}':
+            case '#':
+            case ' ':
+                regex += '\\';
+                regex += *p;
+                break;
+            default:
+                regex += *p;
+                break;
+        }
+    }
+    regex += "\\z";
+
+    Regex::RegexOptions options = Regex::eDotAll;
+    if (bIgnoreCase) options |= Regex::eIgnoreCase;
+    return Regex::Cached(regex, options)->Search(str);
 }
 
 bool StringHelp::IsLike(const char *pattern, const char *str, char chEscape)
 {
-    return false;
+    if (!pattern || !str) { return false; }
+    return LikePattern(pattern, chEscape).Match(str);
 }
 
 std::string StringHelp::ToUpper(const char *str)
 {
     assert(str);
-    std::string result(str);
-    std::transform(result.begin(), result.end(), result.begin(),
-                   [](unsigned char c) { return std::toupper(c); });
-    return result;
+    return ToUpper(std::string_view(str));
 }
 
 std::string StringHelp::ToLower(const char *str)
 {
     assert(str);
-    std::string result(str);
-    std::transform(result.begin(), result.end(), result.begin(),
-                   [](unsigned char c) { return std::tolower(c); });
+    return ToLower(std::string_view(str));
+}
+
+std::string StringHelp::ToUpper(std::string_view str)
+{
+    std::string result(str.size(), '\0');
+    ToUpper(str, &result[0]);
     return result;
 }
 
-bool StringHelp::IsIntString(const char *str) { return false; }
+std::string StringHelp::ToLower(std::string_view str)
+{
+    std::string result(str.size(), '\0');
+    ToLower(str, &result[0]);
+    return result;
+}
 
-bool StringHelp::IsNumberString(const char *str) { return false; }
+void StringHelp::ToUpper(std::string_view str, char *pOut)
+{
+    convertCase(str.data(), str.size(), pOut, true);
+}
 
-bool StringHelp::IsFloatString(const char *str) { return false; }
+void StringHelp::ToLower(std::string_view str, char *pOut)
+{
+    convertCase(str.data(), str.size(), pOut, false);
+}
 
-bool StringHelp::IsBoolString(const char *str) { return false; }
+std::string &StringHelp::ToUpperInPlace(std::string &str)
+{
+    convertCase(str.data(), str.size(), &str[0], true);
+    return str;
+}
+
+std::string &StringHelp::ToLowerInPlace(std::string &str)
+{
+    convertCase(str.data(), str.size(), &str[0], false);
+    return str;
+}
+
+size_t StringHelp::HashNoCase(std::string_view str)
+{
+    const unsigned long long kHigh = 0x8080808080808080ULL;
+    const unsigned long long kOnes = 0x0101010101010101ULL;
+    const unsigned long long kMul = 0x9E3779B97F4A7C15ULL;
+    const char *p = str.data();
+    size_t nLen = str.size();
+    unsigned long long h = nLen * kMul;
+    while (nLen)
+    {
+        size_t n = std::min<size_t>(nLen, 8);
+        unsigned long long word = 0;
+        std::memcpy(&word, p, n);
+        if (word & kHigh)
+        {
+            unsigned char bytes[8] = {};
+            for (size_t i = 0; i < n; ++i)
+                bytes[i] = foldLower(static_cast<unsigned char>(p[i]));
+            std::memcpy(&word, bytes, 8);
+        }
+        else
+        {
+            // Set bit 5 of every byte in 'A'..'Z', eight bytes at a time.
+            unsigned long long geA = word + (0x80 - 'A') * kOnes;
+            unsigned long long gtZ = word + (0x80 - 'Z' - 1) * kOnes;
+            word |= ((geA ^ gtZ) & kHigh) >> 2;
+        }
+        h = Hash::MulFold(h ^ word, kMul);
+        p += n;
+        nLen -= n;
+    }
+    return static_cast<size_t>(h);
+}
+
+namespace {
+
+/// Match masks of a pattern for Myers' algorithm: for each byte value, nWords words
+/// with bit i set where the pattern holds that byte
+void buildMyersPeq(std::string_view pattern, size_t nWords, uint64_t *pPeq)
+{
+    for (size_t i = 0; i < pattern.size(); ++i)
+        pPeq[static_cast<unsigned char>(pattern[i]) * nWords + i / 64] |=
+                1ULL << (i % 64);
+}
+
+/// Whether a score at some column can no longer end at or below nMax,
+/// given that each remaining column changes it by at most one
+inline bool myersHopeless(size_t nScore, size_t nRemaining, size_t nMax)
+{
+    return nScore > nRemaining && nScore - nRemaining > nMax;
+}
+
+/// Edit distance of a pattern of at most 64 bytes, or nMax + 1 once it exceeds nMax
+size_t myersWord(const uint64_t *pPeq, size_t nPattern, std::string_view text,
+                 size_t nMax)
+{
+    const uint64_t last = 1ULL << (nPattern - 1);
+    uint64_t pv = ~0ULL;
+    uint64_t mv = 0;
+    size_t nScore = nPattern;
+    for (size_t j = 0; j < text.size(); ++j)
+    {
+        uint64_t eq = pPeq[static_cast<unsigned char>(text[j])];
+        uint64_t xv = eq | mv;
+        uint64_t xh = (((eq & pv) + pv) ^ pv) | eq;
+        uint64_t ph = mv | ~(xh | pv);
+        uint64_t mh = pv & xh;
+        if (ph & last) ++nScore;
+        else if (mh & last)
+            --nScore;
+        // the first row of the matrix grows by one per column
+        ph = (ph << 1) | 1;
+        mh <<= 1;
+        pv = mh | ~(xv | ph);
+        mv = ph & xv;
+        if (myersHopeless(nScore, text.size() - j - 1, nMax)) return nMax + 1;
+    }
+    return nScore;
+}
+
+/// Edit distance of a pattern of any length, in blocks of 64 rows whose horizontal
+/// deltas carry from one block into the next
+size_t myersBlocked(const uint64_t *pPeq, size_t nPattern, std::string_view text,
+                    size_t nMax)
+{
+    const size_t nWords = (nPattern + 63) / 64;
+    const uint64_t last = 1ULL << ((nPattern - 1) % 64);
+    std::vector<uint64_t> pvs(nWords, ~0ULL);
+    std::vector<uint64_t> mvs(nWords, 0);
+    size_t nScore = nPattern;
+    for (size_t j = 0; j < text.size(); ++j)
+    {
+        const uint64_t *peq = pPeq + static_cast<unsigned char>(text[j]) * nWords;
+        int nCarry = 1;
+        for (size_t b = 0; b < nWords; ++b)
+        {
+            uint64_t eq = peq[b];
+            uint64_t pv = pvs[b];
+            uint64_t mv = mvs[b];
+            uint64_t xv = eq | mv;
+            if (nCarry < 0) eq |= 1;
+            uint64_t xh = (((eq & pv) + pv) ^ pv) | eq;
+            uint64_t ph = mv | ~(xh | pv);
+            uint64_t mh = pv & xh;
+            uint64_t top = b + 1 == nWords ? last : 1ULL << 63;
+            int nOut = (ph & top) ? 1 : (mh & top) ? -1 : 0;
+            ph <<= 1;
+            mh <<= 1;
+            if (nCarry < 0) mh |= 1;
+            else if (nCarry > 0)
+                ph |= 1;
+            pvs[b] = mh | ~(xv | ph);
+            mvs[b] = ph & xv;
+            nCarry = nOut;
+        }
+        nScore += nCarry;
+        if (myersHopeless(nScore, text.size() - j - 1, nMax)) return nMax + 1;
+    }
+    return nScore;
+}
+
+/// Edit distance, or nMax + 1 once it is known to exceed nMax
+size_t boundedEditDistance(std::string_view a, std::string_view b, size_t nMax)
+{
+    // the common prefix and suffix do not change the distance
+    size_t nPrefix = 0;
+    while (nPrefix < a.size() && nPrefix < b.size() && a[nPrefix] == b[nPrefix])
+        ++nPrefix;
+    a.remove_prefix(nPrefix);
+    b.remove_prefix(nPrefix);
+    while (!a.empty() && !b.empty() && a.back() == b.back())
+    {
+        a.remove_suffix(1);
+        b.remove_suffix(1);
+    }
+
+    if (a.size() > b.size()) std::swap(a, b);
+    if (b.size() - a.size() > nMax) return nMax + 1;
+    if (a.empty()) return b.size();
+
+    if (a.size() <= 64)
+    {
+        uint64_t peq[256] = {};
+        buildMyersPeq(a, 1, peq);
+        return myersWord(peq, a.size(), b, nMax);
+    }
+    const size_t nWords = (a.size() + 63) / 64;
+    std::vector<uint64_t> peq(256 * nWords, 0);
+    buildMyersPeq(a, nWords, peq.data());
+    return myersBlocked(peq.data(), a.size(), b, nMax);
+}
+
+}// namespace
+
+size_t StringHelp::EditDistance(std::string_view strA, std::string_view strB)
+{
+    return boundedEditDistance(strA, strB, std::string_view::npos);
+}
+
+bool StringHelp::WithinDistance(std::string_view strA, std::string_view strB,
+                                size_t nMax)
+{
+    return boundedEditDistance(strA, strB, nMax) <= nMax;
+}
+
+void StringHelp::EditDistances(std::string_view query,
+                               const std::string_view *candidates, size_t nCount,
+                               size_t *pOut, size_t nMax)
+{
+    const size_t nWords = std::max<size_t>((query.size() + 63) / 64, 1);
+    std::vector<uint64_t> peq(256 * nWords, 0);
+    buildMyersPeq(query, nWords, peq.data());
+    for (size_t i = 0; i < nCount; ++i)
+    {
+        std::string_view text = candidates[i];
+        size_t nDiff = text.size() > query.size() ? text.size() - query.size()
+                                                  : query.size() - text.size();
+        if (nDiff > nMax) pOut[i] = nMax + 1;
+        else if (query.empty())
+            pOut[i] = text.size();
+        else if (nWords == 1)
+            pOut[i] = myersWord(peq.data(), query.size(), text, nMax);
+        else
+            pOut[i] = myersBlocked(peq.data(), query.size(), text, nMax);
+    }
+}
+
+bool StringHelp::IsIntString(const char *str)
+{
+    if (!str) return false;
+    std::string_view body = Trim(std::string_view(str));
+    if (!body.empty() && (body[0] == '-' || body[0] == '+'))
+        body.remove_prefix(1);
+    if (body.empty()) return false;
+    return std::all_of(body.begin(), body.end(), [](char c) {
+        return c >= '0' && c <= '9';
+    });
+}
+
+bool StringHelp::IsNumberString(const char *str)
+{
+    // TryParse also accepts "inf" and "nan", which are not numbers here
+    double val;
+    return TryParse(str, val) && std::isfinite(val);
+}
 
-bool StringHelp::IsBase64String(const char *str) { return false; }
+bool StringHelp::IsFloatString(const char *str)
+{
+    return IsNumberString(str) && !IsIntString(str);
+}
+
+bool StringHelp::IsBoolString(const char *str)
+{
+    bool val;
+    return TryParse(str, val);
+}
 
-std::string StringHelp::FromHexString(const char *str) { return std::string(); }
+bool StringHelp::IsBase64String(const char *str)
+{
+    return str && Base64::IsValid(str);
+}
+
+std::string StringHelp::FromHexString(const char *str)
+{
+    if (!str) return std::string();
+    size_t nLen = std::strlen(str);
+    std::string result(Hex::DecodedLength(nLen), '\0');
+    if (!Hex::Decode(str, nLen, reinterpret_cast<unsigned char *>(&result[0])))
+        return std::string();
+    return result;
+}
 
-std::string StringHelp::ToHexString(const char *str) { return std::string(); }
+std::string StringHelp::ToHexString(const char *str)
+{
+    if (!str) return std::string();
+    return Hex::Encode(reinterpret_cast<const unsigned char *>(str),
+                       std::strlen(str));
+}
 
 bool StringHelp::FromHexString(const char *str, ByteBuffer *pOut)
 {
-    return false;
+    return str && Hex::Decode(str, pOut);
 }
 
 std::string StringHelp::ToHexString(const unsigned char *blob, int nLen)
 {
-    return std::string();
+    if (!blob || nLen <= 0) return std::string();
+    return Hex::Encode(blob, static_cast<size_t>(nLen));
 }
 
 bool StringHelp::ParseBool(const char *strValue, bool bDefault)
 {
-    return false;
+    bool val;
+    return TryParse(strValue, val) ? val : bDefault;
 }
 
-bool StringHelp::TryParse(const char *strValue, bool &val) { return false; }
+bool StringHelp::TryParse(const char *strValue, bool &val)
+{
+    return strValue && TryParse(std::string_view(strValue), val);
+}
 
 long long StringHelp::ParseInteger(const char *strValue, long long nDefault)
 {
-    return 0;
+    long long val;
+    return TryParse(strValue, val) ? val : nDefault;
 }
 
 bool StringHelp::TryParse(const char *strValue, long long &val)
 {
-    return false;
+    return strValue && TryParse(std::string_view(strValue), val);
 }
 
-bool StringHelp::TryParse(const char *strValue, int &val) { return false; }
+bool StringHelp::TryParse(const char *strValue, int &val)
+{
+    return strValue && TryParse(std::string_view(strValue), val);
+}
 
 double StringHelp::ParseFloat(const char *strValue, double fDefault)
 {
-    return 0.0;
+    double val;
+    return TryParse(strValue, val) ? val : fDefault;
 }
 
-bool StringHelp::TryParse(const char *strValue, double &val) { return false; }
+bool StringHelp::TryParse(const char *strValue, double &val)
+{
+    return strValue && TryParse(std::string_view(strValue), val);
+}
+
+bool StringHelp::TryParse(std::string_view strValue, bool &val)
+{
+    static const std::string_view trueNames[] = {"true", "yes", "on", "1"};
+    static const std::string_view falseNames[] = {"false", "no", "off", "0"};
+    strValue = Trim(strValue);
+    for (std::string_view name: trueNames)
+    {
+        if (IsEqual(strValue, name, true))
+        {
+            val = true;
+            return true;
+        }
+    }
+    for (std::string_view name: falseNames)
+    {
+        if (IsEqual(strValue, name, true))
+        {
+            val = false;
+            return true;
+        }
+    }
+    return false;
+}
+
+/// Removes surrounding whitespace and a leading '+', which from_chars rejects.
+static std::string_view numberBody(std::string_view str)
+{
+    str = StringHelp::Trim(str);
+    if (str.size() > 1 && str[0] == '+' && str[1] != '-') str.remove_prefix(1);
+    return str;
+}
+
+/// Tests whether all eight bytes of a little-endian word are ASCII digits.
+static inline bool isEightDigits(uint64_t v)
+{
+    return ((v & 0xF0F0F0F0F0F0F0F0ULL) |
+            (((v + 0x0606060606060606ULL) & 0xF0F0F0F0F0F0F0F0ULL) >> 4)) ==
+           0x3333333333333333ULL;
+}
+
+/// Converts eight ASCII digits held in a little-endian word with three
+/// multiplications instead of eight dependent steps.
+static inline uint32_t parseEightDigits(uint64_t v)
+{
+    v -= 0x3030303030303030ULL;
+    v = (v * 10) + (v >> 8);
+    v = (((v & 0x000000FF000000FFULL) * (100 + (1000000ULL << 32))) +
+         (((v >> 16) & 0x000000FF000000FFULL) * (1 + (10000ULL << 32)))) >>
+        32;
+    return static_cast<uint32_t>(v);
+}
+
+/// Accumulates at most 19 decimal digits, which always fit in 64 bits.
+/// \return Returns the position of the first character not consumed.
+static const char *scanDigits(const char *p, const char *pEnd, uint64_t &v)
+{
+    const char *pBegin = p;
+#if defined(CPL_LITTLE_ENDIAN)
+    while (pEnd - p >= 8 && p - pBegin <= 8)
+    {
+        uint64_t word;
+        std::memcpy(&word, p, 8);
+        if (!isEightDigits(word)) break;
+        v = v * 100000000 + parseEightDigits(word);
+        p += 8;
+    }
+#endif
+    while (p != pEnd && p - pBegin < 19 && *p >= '0' && *p <= '9')
+        v = v * 10 + static_cast<unsigned>(*p++ - '0');
+    return p;
+}
 
-bool StringHelp::HasContain(const char *str, char c) { return false; }
+template<typename T>
+static bool parseInteger(std::string_view str, T &val)
+{
+    str = numberBody(str);
+    if (str.empty()) return false;
+
+    const char *p = str.data();
+    const char *pEnd = p + str.size();
+    bool bNegative = *p == '-';
+    if (bNegative) ++p;
+    uint64_t v = 0;
+    const char *pStop = scanDigits(p, pEnd, v);
+    if (pStop == p) return false;
+    if (pStop != pEnd)
+    {
+        if (*pStop < '0' || *pStop > '9') return false;
+        // More than 19 digits: leave overflow and leading zeros to from_chars.
+        T slow;
+        auto res = std::from_chars(str.data(), pEnd, slow);
+        if (res.ec != std::errc() || res.ptr != pEnd) return false;
+        val = slow;
+        return true;
+    }
+
+    uint64_t nLimit = static_cast<uint64_t>(std::numeric_limits<T>::max()) +
+                      (bNegative ? 1 : 0);
+    if (v > nLimit) return false;
+    val = bNegative ? static_cast<T>(-static_cast<long long>(v - 1) - 1)
+                    : static_cast<T>(v);
+    return true;
+}
 
-bool StringHelp::HasContainAny(const char *str, const char *c) { return false; }
+/// Clinger's fast path: a mantissa of at most 53 bits scaled by an exact
+/// power of ten within 10^22 is correctly rounded by a single operation.
+/// \return Returns false when the text needs the general algorithm.
+static bool parseDoubleFast(const char *p, const char *pEnd, double &val)
+{
+    static const double powers[] = {1e0,  1e1,  1e2,  1e3,  1e4,  1e5,
+                                    1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+                                    1e12, 1e13, 1e14, 1e15, 1e16, 1e17,
+                                    1e18, 1e19, 1e20, 1e21, 1e22};
+    bool bNegative = p != pEnd && *p == '-';
+    if (bNegative) ++p;
+
+    uint64_t m = 0;
+    const char *pInt = p;
+    p = scanDigits(p, pEnd, m);
+    size_t nDigits = p - pInt;
+    int nExponent = 0;
+    if (p != pEnd && *p == '.')
+    {
+        const char *pFrac = ++p;
+        if (nDigits < 19) p = scanDigits(p, pEnd, m);
+        nExponent = -static_cast<int>(p - pFrac);
+        nDigits += p - pFrac;
+    }
+    if (nDigits == 0 || nDigits > 19) return false;
+    if (p != pEnd && (*p == 'e' || *p == 'E'))
+    {
+        ++p;
+        bool bNegExp = p != pEnd && *p == '-';
+        if (p != pEnd && (*p == '-' || *p == '+')) ++p;
+        const char *pExp = p;
+        int e = 0;
+        while (p != pEnd && *p >= '0' && *p <= '9' && p - pExp < 4)
+            e = e * 10 + (*p++ - '0');
+        if (p == pExp) return false;
+        nExponent += bNegExp ? -e : e;
+    }
+    if (p != pEnd || m > (1ULL << 53) || nExponent < -22 || nExponent > 22)
+        return false;
+
+    double d = static_cast<double>(m);
+    d = nExponent < 0 ? d / powers[-nExponent] : d * powers[nExponent];
+    val = bNegative ? -d : d;
+    return true;
+}
+
+static bool parseDouble(std::string_view str, double &val)
+{
+    str = numberBody(str);
+    if (str.empty()) return false;
+    const char *pEnd = str.data() + str.size();
+    if (parseDoubleFast(str.data(), pEnd, val)) return true;
+    double v;
+    auto res = std::from_chars(str.data(), pEnd, v);
+    if (res.ec != std::errc() || res.ptr != pEnd) return false;
+    val = v;
+    return true;
+}
+
+bool StringHelp::TryParse(std::string_view strValue, long long &val)
+{
+    return parseInteger(strValue, val);
+}
+
+bool StringHelp::TryParse(std::string_view strValue, int &val)
+{
+    return parseInteger(strValue, val);
+}
+
+bool StringHelp::TryParse(std::string_view strValue, double &val)
+{
+    return parseDouble(strValue, val);
+}
+
+template<typename T, typename Parse>
+static size_t parseColumn(const std::string_view *values, size_t nCount,
+                          T *pOut, uint64_t *pNulls, Parse parse)
+{
+    size_t nValid = 0;
+    for (size_t nBase = 0; nBase < nCount; nBase += 64)
+    {
+        size_t nBlock = std::min<size_t>(64, nCount - nBase);
+        uint64_t nulls = 0;
+        for (size_t i = 0; i < nBlock; ++i)
+        {
+            T &out = pOut[nBase + i];
+            if (parse(values[nBase + i], out)) { ++nValid; }
+            else
+            {
+                out = 0;
+                nulls |= 1ULL << i;
+            }
+        }
+        if (pNulls) pNulls[nBase / 64] = nulls;
+    }
+    return nValid;
+}
+
+size_t StringHelp::ParseInt64Column(const std::string_view *values,
+                                    size_t nCount, int64_t *pOut,
+                                    uint64_t *pNulls)
+{
+    return parseColumn(values, nCount, pOut, pNulls, parseInteger<int64_t>);
+}
+
+size_t StringHelp::ParseDoubleColumn(const std::string_view *values,
+                                     size_t nCount, double *pOut,
+                                     uint64_t *pNulls)
+{
+    return parseColumn(values, nCount, pOut, pNulls, parseDouble);
+}
+
+bool StringHelp::HasContain(const char *str, char c)
+{
+    if (!str || c == '\0') { return false; }
+    return std::strchr(str, c) != nullptr;
+}
+
+bool StringHelp::HasContainAny(const char *str, const char *c)
+{
+    if (!str || !c) { return false; }
+    return CharSet(c).ContainsAny(str);
+}
 
 }// namespace CPL
\ No newline at end of file
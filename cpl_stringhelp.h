@@ -23,6 +23,7 @@
 #include "cpl_memorymanager.h"
 #include <algorithm>
 #include <cpl_exports.h>
+#include <cstdint>
 #include <deque>
 #include <iomanip>
 #include <list>
@@ -32,6 +33,7 @@
 #include <sstream>
 #include <stack>
 #include <string>
+#include <string_view>
 #include <vector>
 
 namespace CPL {
@@ -148,6 +150,43 @@ enum CodePageID
             57011// ISCII Malayalam: Indian script for Malayalam language.
 };
 
+/// \brief Returns the iconv name of a code page, or an empty string if it is unknown
+CPL_API std::string CodePageToIconvEncoding(CodePageID cp);
+
+/// \brief Counters of the iconv descriptor cache
+struct IconvCacheStats
+{
+    unsigned long long Hits = 0;     ///< Conversions that reused a cached descriptor
+    unsigned long long Misses = 0;   ///< Conversions that had to open a descriptor
+    unsigned long long Evictions = 0;///< Descriptors closed to stay within the capacity
+    size_t Cached = 0;               ///< Idle descriptors held by the calling thread
+};
+
+/// \brief Per-thread cache of iconv conversion descriptors
+/// \details CW2A, CA2W and Encoding borrow descriptors from the cache of the calling
+/// thread instead of opening and closing one for every call, and reset the conversion
+/// state before a descriptor is reused. Each thread keeps at most Capacity() idle
+/// descriptors and closes the least recently used one beyond that. The counters are
+/// process-wide.
+class CPL_API IconvCache
+{
+public:
+    /// \brief Sets the maximum number of idle descriptors kept per thread, default 8
+    static void SetCapacity(size_t nCapacity);
+
+    /// \brief Maximum number of idle descriptors kept per thread
+    static size_t Capacity();
+
+    /// \brief Returns the cache counters
+    static IconvCacheStats Stats();
+
+    /// \brief Resets the process-wide counters to zero
+    static void ResetStats();
+
+    /// \brief Closes the idle descriptors of the calling thread
+    static void Clear();
+};
+
 
 /// \brief Class for converting wide-character strings (wchar_t) to narrow-character strings (char)
 /// This class is used to convert wide-character strings (wchar_t) to narrow-character strings (char), supporting different code pages.
@@ -312,13 +351,158 @@ public:
     /// \brief Converts a UTF-8 string to a local string.
     /// \return Returns the string converted to the local encoding.
     static std::string ToLocal(const char *str);
+
+    /// \brief Converts text between two code pages into a caller buffer
+    /// \details Writes at most nSize bytes and no terminator. When the result does not
+    /// fit, the buffer holds a prefix of it and the return value tells how large a
+    /// buffer is needed. Throws std::runtime_error if the text is invalid in eFrom or
+    /// cannot be represented in eTo.
+    /// \param src The text to convert
+    /// \param eFrom The code page of the text
+    /// \param eTo The code page to convert to
+    /// \param dst The buffer receiving the result, may be null if nSize is 0
+    /// \param nSize The size of the buffer in bytes
+    /// \return The length of the complete result in bytes
+    static size_t Convert(std::string_view src, CodePageID eFrom, CodePageID eTo,
+                          char *dst, size_t nSize);
+
+    /// \brief Converts text between two code pages into a byte buffer, replacing its content
+    /// \return The length of the result in bytes
+    static size_t Convert(std::string_view src, CodePageID eFrom, CodePageID eTo,
+                          ByteBuffer *pOut);
+
+    /// \brief Converts a wide string into a caller buffer in a code page
+    /// \details Behaves like the narrow Convert; UTF-8 is converted without iconv.
+    /// \return The length of the complete result in bytes
+    static size_t Convert(std::wstring_view src, CodePageID eTo, char *dst,
+                          size_t nSize);
+
+    /// \brief Converts text in a code page into a caller buffer of wide characters
+    /// \details Behaves like the narrow Convert; UTF-8 is converted without iconv.
+    /// \param nSize The size of the buffer in wide characters
+    /// \return The length of the complete result in wide characters
+    static size_t Convert(std::string_view src, CodePageID eFrom, wchar_t *dst,
+                          size_t nSize);
+};
+
+/// \brief Converts a wide string to a narrow one in storage of the object itself
+/// \details Results shorter than t_nBufferLength characters are kept in the object,
+/// so a conversion used as a temporary does not allocate; longer ones are converted
+/// again into a heap block of the exact size.
+template<size_t t_nBufferLength = 128>
+class CW2AEX
+{
+    char m_Buffer[t_nBufferLength];///< Inline storage for short results
+    std::unique_ptr<char[]> m_Heap;///< Storage for results that do not fit
+    char *m_psz = m_Buffer;        ///< The null-terminated result
+    size_t m_nLength = 0;          ///< Length of the result in bytes
+
+public:
+    /// \brief Converts a null-terminated wide string, a null pointer gives an empty result
+    /// \param str The string to convert
+    /// \param eCodePage The code page to convert to
+    explicit CW2AEX(const wchar_t *str, CodePageID eCodePage = CP_UTF8)
+    {
+        Init(str ? std::wstring_view(str) : std::wstring_view(), eCodePage);
+    }
+
+    /// \brief Converts a wide string
+    /// \param str The string to convert
+    /// \param eCodePage The code page to convert to
+    explicit CW2AEX(std::wstring_view str, CodePageID eCodePage = CP_UTF8)
+    {
+        Init(str, eCodePage);
+    }
+
+    CPL_DISABLE_COPY(CW2AEX)
+
+    /// \brief Returns the null-terminated result
+    operator const char *() const { return m_psz; }
+
+    /// \brief Returns the result
+    std::string_view View() const { return std::string_view(m_psz, m_nLength); }
+
+    /// \brief Returns the length of the result in bytes
+    size_t Length() const { return m_nLength; }
+
+private:
+    void Init(std::wstring_view str, CodePageID eCodePage)
+    {
+        m_nLength = Encoding::Convert(str, eCodePage, m_Buffer, t_nBufferLength - 1);
+        if (m_nLength >= t_nBufferLength)
+        {
+            m_Heap.reset(new char[m_nLength + 1]);
+            m_psz = m_Heap.get();
+            Encoding::Convert(str, eCodePage, m_psz, m_nLength);
+        }
+        m_psz[m_nLength] = '\0';
+    }
+};
+
+/// \brief Converts a narrow string to a wide one in storage of the object itself
+/// \details Results shorter than t_nBufferLength characters are kept in the object,
+/// so a conversion used as a temporary does not allocate; longer ones are converted
+/// again into a heap block of the exact size.
+template<size_t t_nBufferLength = 128>
+class CA2WEX
+{
+    wchar_t m_Buffer[t_nBufferLength];///< Inline storage for short results
+    std::unique_ptr<wchar_t[]> m_Heap;///< Storage for results that do not fit
+    wchar_t *m_psz = m_Buffer;        ///< The null-terminated result
+    size_t m_nLength = 0;             ///< Length of the result in wide characters
+
+public:
+    /// \brief Converts a null-terminated string, a null pointer gives an empty result
+    /// \param str The string to convert
+    /// \param eCodePage The code page of the string
+    explicit CA2WEX(const char *str, CodePageID eCodePage = CP_UTF8)
+    {
+        Init(str ? std::string_view(str) : std::string_view(), eCodePage);
+    }
+
+    /// \brief Converts a string
+    /// \param str The string to convert
+    /// \param eCodePage The code page of the string
+    explicit CA2WEX(std::string_view str, CodePageID eCodePage = CP_UTF8)
+    {
+        Init(str, eCodePage);
+    }
+
+    CPL_DISABLE_COPY(CA2WEX)
+
+    /// \brief Returns the null-terminated result
+    operator const wchar_t *() const { return m_psz; }
+
+    /// \brief Returns the result
+    std::wstring_view View() const { return std::wstring_view(m_psz, m_nLength); }
+
+    /// \brief Returns the length of the result in wide characters
+    size_t Length() const { return m_nLength; }
+
+private:
+    void Init(std::string_view str, CodePageID eCodePage)
+    {
+        m_nLength = Encoding::Convert(str, eCodePage, m_Buffer, t_nBufferLength - 1);
+        if (m_nLength >= t_nBufferLength)
+        {
+            m_Heap.reset(new wchar_t[m_nLength + 1]);
+            m_psz = m_Heap.get();
+            Encoding::Convert(str, eCodePage, m_psz, m_nLength);
+        }
+        m_psz[m_nLength] = L'\0';
+    }
 };
 
 /// \brief A class for converting a string to a UTF-8 encoded string.
+/// \details A C string is converted on first access, and not at all when the local
+/// code page is already UTF-8; the result then points into the original string,
+/// which must outlive the object. A std::string is converted (or copied) by the
+/// constructor, so it may be a temporary.
 class CPL_API Utf8
 {
-    const char *m_Ori;///< Original string (in its native encoding).
-    std::string m_Utf;///< UTF-8 encoded string.
+    const char *m_Ori;             ///< Original C string, null for a std::string source.
+    std::string m_Utf;             ///< UTF-8 encoded string, once converted.
+    bool m_bConverted = false;     ///< Whether m_Utf holds the result.
 
 public:
     /// \brief Constructor that initializes with a C-style string (const char *).
@@ -340,14 +524,27 @@ public:
     /// \brief Returns the UTF-8 encoded string.
     /// \return Returns the UTF-8 string stored in the object.
     std::string Str();
+
+    /// \brief Checks whether a string is well-formed UTF-8
+    /// \details Rejects overlong forms, surrogates and code points above U+10FFFF;
+    /// Transcoder::ValidateUtf8 also reports where the first error is.
+    static bool Validate(std::string_view str);
+
+private:
+    const char *Result();
 };
 
 
 /// \brief A class for converting a string to the local encoding.
+/// \details A C string is converted on first access, and not at all when the local
+/// code page is UTF-8; the result then points into the original string, which must
+/// outlive the object. A std::string is converted (or copied) by the constructor,
+/// so it may be a temporary.
 class CPL_API Local
 {
-    const char *m_Ori;///< Original string (in its native encoding).
-    std::string m_Utf;///< Local encoded string.
+    const char *m_Ori;             ///< Original C string, null for a std::string source.
+    std::string m_Utf;             ///< Local encoded string, once converted.
+    bool m_bConverted = false;     ///< Whether m_Utf holds the result.
 
 public:
     /// \brief Constructor that initializes with a C-style string (const char *).
@@ -369,6 +566,9 @@ public:
     /// \brief Returns the string in the local encoding.
     /// \return Returns the string stored in the object, converted to the local encoding.
     std::string Str();
+
+private:
+    const char *Result();
 };
 
 
@@ -384,12 +584,28 @@ public:
     static int Compare(const char *strA, const char *strB,
                        bool bIgnoreCase = true);
 
+    /// \brief Compares two length-delimited strings.
+    /// \param strA First string.
+    /// \param strB Second string.
+    /// \param bIgnoreCase Flag to indicate if comparison should ignore case (default: true).
+    /// \return Returns the result of the comparison.
+    static int Compare(std::string_view strA, std::string_view strB,
+                       bool bIgnoreCase = true);
+
     /// \brief Compares two strings, ignoring case.
     /// \param strA First string.
     /// \param strB Second string.
     /// \return Returns the result of the comparison ignoring case.
     static int CompareNoCase(const char *strA, const char *strB);
 
+    /// \brief Compares two length-delimited strings, ignoring case.
+    /// \details ASCII letters are folded block-wise; bytes outside ASCII follow the
+    /// current C locale.
+    /// \param strA First string.
+    /// \param strB Second string.
+    /// \return Returns the result of the comparison ignoring case.
+    static int CompareNoCase(std::string_view strA, std::string_view strB);
+
     /// \brief Checks if two strings are equal.
     /// \param strA First string.
     /// \param strB Second string.
@@ -398,6 +614,14 @@ public:
     static bool IsEqual(const char *strA, const char *strB,
                         bool bIgnoreCase = true);
 
+    /// \brief Checks if two length-delimited strings are equal.
+    /// \param strA First string.
+    /// \param strB Second string.
+    /// \param bIgnoreCase Flag to indicate if comparison should ignore case (default: true).
+    /// \return Returns true if the strings are equal, false otherwise.
+    static bool IsEqual(std::string_view strA, std::string_view strB,
+                        bool bIgnoreCase = true);
+
     /// \brief Converts a C-style string to a std::string object.
     /// \param str The C-style string.
     /// \return Returns the std::string object.
@@ -441,6 +665,68 @@ public:
     static std::string ToString(double v, int precision = -1, int width = 0,
                                 char thSep = 0, char decSep = 0);
 
+    /// \brief Maximum number of characters AppendTo writes for an integer.
+    static constexpr size_t MaxIntegerLength = 20;
+
+    /// \brief Appends the decimal text of an integer to a string.
+    /// \details Unlike ToString, no temporary string is created; the value
+    /// is formatted on the stack and appended in place.
+    /// \param str The string to append to.
+    /// \param v The value.
+    static void AppendTo(std::string &str, int v);
+    static void AppendTo(std::string &str, unsigned int v);
+    static void AppendTo(std::string &str, long v);
+    static void AppendTo(std::string &str, unsigned long v);
+    static void AppendTo(std::string &str, long long v);
+    static void AppendTo(std::string &str, unsigned long long v);
+    /// \brief Appends a character as is, not its numeric value.
+    static void AppendTo(std::string &str, char c);
+    /// \brief Appends the shortest round-trip text of a floating point value.
+    /// \details Accepts the same precision, width and separator options as
+    /// ToString.
+    static void AppendTo(std::string &str, float v, int precision = -1,
+                         int width = 0, char thSep = 0, char decSep = 0);
+    static void AppendTo(std::string &str, double v, int precision = -1,
+                         int width = 0, char thSep = 0, char decSep = 0);
+
+    /// \brief Appends the decimal text of a number to a byte buffer.
+    /// \param buffer The buffer to append to.
+    /// \param v The value.
+    static void AppendTo(ByteBuffer &buffer, int v);
+    static void AppendTo(ByteBuffer &buffer, unsigned int v);
+    static void AppendTo(ByteBuffer &buffer, long v);
+    static void AppendTo(ByteBuffer &buffer, unsigned long v);
+    static void AppendTo(ByteBuffer &buffer, long long v);
+    static void AppendTo(ByteBuffer &buffer, unsigned long long v);
+    /// \brief Appends a character as is, not its numeric value.
+    static void AppendTo(ByteBuffer &buffer, char c);
+    static void AppendTo(ByteBuffer &buffer, float v, int precision = -1,
+                         int width = 0, char thSep = 0, char decSep = 0);
+    static void AppendTo(ByteBuffer &buffer, double v, int precision = -1,
+                         int width = 0, char thSep = 0, char decSep = 0);
+
+    /// \brief Writes the decimal text of a number into a caller buffer.
+    /// \details The output is not null-terminated. An integer never needs
+    /// more than MaxIntegerLength characters.
+    /// \param buf The destination buffer.
+    /// \param nSize The capacity of buf in bytes.
+    /// \param v The value.
+    /// \return Returns the number of characters written, or 0 when the text
+    /// does not fit into nSize bytes.
+    static size_t AppendTo(char *buf, size_t nSize, int v);
+    static size_t AppendTo(char *buf, size_t nSize, unsigned int v);
+    static size_t AppendTo(char *buf, size_t nSize, long v);
+    static size_t AppendTo(char *buf, size_t nSize, unsigned long v);
+    static size_t AppendTo(char *buf, size_t nSize, long long v);
+    static size_t AppendTo(char *buf, size_t nSize, unsigned long long v);
+    /// \brief Writes a character as is, not its numeric value.
+    static size_t AppendTo(char *buf, size_t nSize, char c);
+    static size_t AppendTo(char *buf, size_t nSize, float v, int precision = -1,
+                           int width = 0, char thSep = 0, char decSep = 0);
+    static size_t AppendTo(char *buf, size_t nSize, double v,
+                           int precision = -1, int width = 0, char thSep = 0,
+                           char decSep = 0);
+
     /// \brief Converts a boolean value to a std::string object.
     /// \param v The boolean value.
     /// \return Returns the std::string object.
@@ -453,7 +739,10 @@ public:
     static std::string ToString(const unsigned char *blob, int nLen);
 
     /// \brief Formats a string according to the specified format and arguments.
-    /// \param nMaxLen The maximum length of the resulting string.
+    /// \details The result is never truncated; prefer the type-checked CPL::Format
+    /// from cpl_format.h in new code.
+    /// \param nMaxLen The expected length of the resulting string, used to size the
+    /// first formatting attempt.
     /// \param format The format string.
     /// \return Returns the formatted std::string object.
     static std::string Format(int nMaxLen, const char *format, ...);
@@ -480,6 +769,35 @@ public:
     /// \return Returns a vector of substrings.
     static std::vector<std::string> Split(const char *str, char sp);
 
+    /// \brief Splits a length-delimited string into substrings using a separator.
+    /// \param str The string to split.
+    /// \param strSep The separator string.
+    /// \return Returns a vector of substrings.
+    static std::vector<std::string> Split(std::string_view str,
+                                          std::string_view strSep);
+
+    /// \brief Splits a length-delimited string into substrings using a character separator.
+    /// \param str The string to split.
+    /// \param sp The separator character.
+    /// \return Returns a vector of substrings.
+    static std::vector<std::string> Split(std::string_view str, char sp);
+
+    /// \brief Splits a string into views of its substrings without copying them.
+    /// \details The views point into `str`, which must outlive them.
+    /// \param str The string to split.
+    /// \param strSep The separator string.
+    /// \param parts Receives the substrings, previous contents are cleared.
+    static void Split(std::string_view str, std::string_view strSep,
+                      std::vector<std::string_view> &parts);
+
+    /// \brief Splits a string into views of its substrings without copying them.
+    /// \details The views point into `str`, which must outlive them.
+    /// \param str The string to split.
+    /// \param sp The separator character.
+    /// \param parts Receives the substrings, previous contents are cleared.
+    static void Split(std::string_view str, char sp,
+                      std::vector<std::string_view> &parts);
+
     /// \brief Replaces a substring within a string with a new substring.
     /// \param str The original string.
     /// \param src The substring to be replaced.
@@ -488,6 +806,23 @@ public:
     static std::string Replace(const char *str, const char *src,
                                const char *dst);
 
+    /// \brief Replaces a substring within a length-delimited string with a new substring.
+    /// \param str The original string.
+    /// \param src The substring to be replaced.
+    /// \param dst The new substring.
+    /// \return Returns the string with replacements.
+    static std::string Replace(std::string_view str, std::string_view src,
+                               std::string_view dst);
+
+    /// \brief Replaces a substring and writes the result into a caller-supplied string.
+    /// \details The capacity of `out` is reused, so repeated calls do not allocate once it is large enough.
+    /// \param str The original string, must not overlap `out`.
+    /// \param src The substring to be replaced.
+    /// \param dst The new substring.
+    /// \param out Receives the string with replacements, previous contents are cleared.
+    static void Replace(std::string_view str, std::string_view src,
+                        std::string_view dst, std::string &out);
+
     /// \brief Trims whitespace characters from the beginning of a string.
     /// \param str The string to trim.
     /// \return Returns the trimmed string.
@@ -503,6 +838,21 @@ public:
     /// \return Returns the right-trimmed string.
     static std::string TrimRight(const char *str);
 
+    /// \brief Trims whitespace characters from both ends of a string without copying it.
+    /// \param str The string to trim.
+    /// \return Returns a view of `str` without the surrounding whitespace.
+    static std::string_view Trim(std::string_view str);
+
+    /// \brief Trims whitespace characters from the left side of a string without copying it.
+    /// \param str The string to trim.
+    /// \return Returns a view of `str` without the leading whitespace.
+    static std::string_view TrimLeft(std::string_view str);
+
+    /// \brief Trims whitespace characters from the right side of a string without copying it.
+    /// \param str The string to trim.
+    /// \return Returns a view of `str` without the trailing whitespace.
+    static std::string_view TrimRight(std::string_view str);
+
     /// \brief Checks if a string starts with a specified prefix.
     /// \param str The string to check.
     /// \param strHead The prefix.
@@ -519,6 +869,22 @@ public:
     static bool EndWith(const char *str, const char *strTail,
                         bool bIgnoringCase = true);
 
+    /// \brief Checks if a length-delimited string starts with a specified prefix.
+    /// \param str The string to check.
+    /// \param strHead The prefix.
+    /// \param bIgnoringCase Flag to indicate if comparison should ignore case (default: true).
+    /// \return Returns true if the string starts with the specified prefix, false otherwise.
+    static bool StartWith(std::string_view str, std::string_view strHead,
+                          bool bIgnoringCase = true);
+
+    /// \brief Checks if a length-delimited string ends with a specified suffix.
+    /// \param str The string to check.
+    /// \param strTail The suffix.
+    /// \param bIgnoringCase Flag to indicate if comparison should ignore case (default: true).
+    /// \return Returns true if the string ends with the specified suffix, false otherwise.
+    static bool EndWith(std::string_view str, std::string_view strTail,
+                        bool bIgnoringCase = true);
+
     /// \brief Checks if a string matches a wildcard pattern.
     /// \details The `*` character matches one or more characters, and `?` matches a single character.
     /// \param pattern The wildcard pattern.
@@ -545,17 +911,88 @@ public:
     /// \return Returns the lowercase string.
     static std::string ToLower(const char *str);
 
+    /// \brief Converts a length-delimited string to uppercase.
+    /// \param str The string to convert.
+    /// \return Returns the uppercase string.
+    static std::string ToUpper(std::string_view str);
+
+    /// \brief Converts a length-delimited string to lowercase.
+    /// \param str The string to convert.
+    /// \return Returns the lowercase string.
+    static std::string ToLower(std::string_view str);
+
+    /// \brief Converts a string to uppercase into a caller-supplied buffer.
+    /// \param str The string to convert.
+    /// \param pOut The output buffer, at least `str.size()` bytes; may equal `str.data()`. No terminator is written.
+    static void ToUpper(std::string_view str, char *pOut);
+
+    /// \brief Converts a string to lowercase into a caller-supplied buffer.
+    /// \param str The string to convert.
+    /// \param pOut The output buffer, at least `str.size()` bytes; may equal `str.data()`. No terminator is written.
+    static void ToLower(std::string_view str, char *pOut);
+
+    /// \brief Converts a string to uppercase in place.
+    /// \param str The string to convert.
+    /// \return Returns str.
+    static std::string &ToUpperInPlace(std::string &str);
+
+    /// \brief Converts a string to lowercase in place.
+    /// \param str The string to convert.
+    /// \return Returns str.
+    static std::string &ToLowerInPlace(std::string &str);
+
+    /// \brief Computes a hash that is equal for strings that are equal ignoring case.
+    /// \details Consistent with IsEqual(strA, strB, true), so it can key hash
+    /// containers of case-insensitive names such as protocol headers.
+    /// \param str The string to hash.
+    /// \return Returns the hash value.
+    static size_t HashNoCase(std::string_view str);
+
+    /// \brief Computes the Levenshtein distance between two strings.
+    /// \details Counts the byte insertions, deletions and substitutions turning one
+    /// string into the other, with Myers' bit-parallel algorithm: one 64-bit word per
+    /// 64 bytes of the shorter string after the common prefix and suffix are removed,
+    /// so the cost is O(n * ceil(m / 64)).
+    /// \param strA The first string.
+    /// \param strB The second string.
+    /// \return Returns the edit distance.
+    static size_t EditDistance(std::string_view strA, std::string_view strB);
+
+    /// \brief Checks whether the edit distance between two strings is at most nMax.
+    /// \details Stops as soon as the distance can no longer come down to nMax, and
+    /// returns at once when the lengths differ by more than that.
+    /// \param strA The first string.
+    /// \param strB The second string.
+    /// \param nMax The largest accepted distance.
+    /// \return Returns true if the strings are within the distance.
+    static bool WithinDistance(std::string_view strA, std::string_view strB,
+                               size_t nMax);
+
+    /// \brief Computes the edit distances from one query to many candidates.
+    /// \details The query is preprocessed once for all candidates.
+    /// \param query The query string.
+    /// \param candidates The candidate strings.
+    /// \param nCount The number of candidates.
+    /// \param pOut Receives nCount distances; those above nMax are stored as nMax + 1.
+    /// \param nMax The largest distance of interest, which lets most candidates be
+    /// rejected early; the default computes every distance exactly.
+    static void EditDistances(std::string_view query,
+                              const std::string_view *candidates, size_t nCount,
+                              size_t *pOut,
+                              size_t nMax = std::string_view::npos);
+
     /// \brief Checks if a string consists of integer characters (including a negative sign).
     /// \param str The string to check.
     /// \return Returns true if the string represents an integer, false otherwise.
     static bool IsIntString(const char *str);
 
-    /// \brief Checks if a string consists of numeric characters (including a negative sign).
+    /// \brief Checks if a string is a finite integer or floating-point number.
+    /// \details Infinity and NaN are rejected.
     /// \param str The string to check.
     /// \return Returns true if the string represents a number, false otherwise.
     static bool IsNumberString(const char *str);
 
-    /// \brief Checks if a string consists of floating-point characters (including a negative sign).
+    /// \brief Checks if a string is a finite number with a fractional part or exponent.
     /// \param str The string to check.
     /// \return Returns true if the string represents a float, false otherwise.
     static bool IsFloatString(const char *str);
@@ -634,6 +1071,58 @@ public:
     /// \return Returns true if parsing is successful, false otherwise.
     static bool TryParse(const char *strValue, double &val);
 
+    /// \brief Tries to parse a boolean value from a length-delimited string.
+    /// \details Accepts true/false, yes/no, on/off and 1/0, ignoring case and surrounding whitespace.
+    /// \param strValue The string value to parse.
+    /// \param val The parsed boolean value.
+    /// \return Returns true if parsing is successful, false otherwise.
+    static bool TryParse(std::string_view strValue, bool &val);
+
+    /// \brief Tries to parse a decimal integer value from a length-delimited string.
+    /// \details Surrounding whitespace is ignored; the rest must be an optionally signed integer in range.
+    /// \param strValue The string value to parse.
+    /// \param val The parsed integer value.
+    /// \return Returns true if parsing is successful, false otherwise.
+    static bool TryParse(std::string_view strValue, long long &val);
+
+    /// \brief Tries to parse a decimal integer value from a length-delimited string.
+    /// \param strValue The string value to parse.
+    /// \param val The parsed integer value.
+    /// \return Returns true if parsing is successful, false otherwise.
+    static bool TryParse(std::string_view strValue, int &val);
+
+    /// \brief Tries to parse a float value from a length-delimited string.
+    /// \details Surrounding whitespace is ignored; the rest must be a decimal or scientific number.
+    /// \param strValue The string value to parse.
+    /// \param val The parsed float value.
+    /// \return Returns true if parsing is successful, false otherwise.
+    static bool TryParse(std::string_view strValue, double &val);
+
+    /// \brief Parses a column of integers, such as a field read from a CSV file.
+    /// \details Empty and malformed values are treated as nulls: their output
+    /// is 0 and their bit in pNulls is set. Runs of eight digits are
+    /// converted with a single word-wide operation.
+    /// \param values The text of each value.
+    /// \param nCount The number of values.
+    /// \param pOut Receives nCount parsed values.
+    /// \param pNulls Optional bitmap of (nCount + 63) / 64 words; bit i is set
+    /// when value i is null.
+    /// \return Returns the number of non-null values.
+    static size_t ParseInt64Column(const std::string_view *values,
+                                   size_t nCount, int64_t *pOut,
+                                   uint64_t *pNulls = nullptr);
+
+    /// \brief Parses a column of floating point numbers.
+    /// \details Same null handling as ParseInt64Column.
+    /// \param values The text of each value.
+    /// \param nCount The number of values.
+    /// \param pOut Receives nCount parsed values.
+    /// \param pNulls Optional null bitmap of (nCount + 63) / 64 words.
+    /// \return Returns the number of non-null values.
+    static size_t ParseDoubleColumn(const std::string_view *values,
+                                    size_t nCount, double *pOut,
+                                    uint64_t *pNulls = nullptr);
+
     /// \brief Checks if a string contains a specific character.
     /// \param str The string to check.
     /// \param c The character to check for.
@@ -647,4 +1136,22 @@ public:
     static bool HasContainAny(const char *str, const char *c);
 };
 
+/// \brief Case-insensitive hash functor for unordered containers
+struct StringHashNoCase
+{
+    size_t operator()(std::string_view str) const
+    {
+        return StringHelp::HashNoCase(str);
+    }
+};
+
+/// \brief Case-insensitive equality functor for unordered containers
+struct StringEqualNoCase
+{
+    bool operator()(std::string_view strA, std::string_view strB) const
+    {
+        return StringHelp::IsEqual(strA, strB, true);
+    }
+};
+
 }// namespace CPL
\ No newline at end of file
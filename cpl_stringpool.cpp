@@ -0,0 +1,238 @@
+/**
+ * CPL - Common Portability Library
+ *
+ * Copyright (C) 2024 Merlot.Rain
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "cpl_stringpool.h"
+#include "cpl_hash.h"
+#include <cstring>
+#include <mutex>
+#include <stdexcept>
+#include <unordered_map>
+#include <vector>
+
+namespace CPL {
+
+static constexpr unsigned int PoolShardCount = 16;
+static constexpr unsigned int PoolPageBits = 13;
+static constexpr unsigned int PoolPageSize = 1u << PoolPageBits;
+static constexpr unsigned int PoolPageCount = 1u << 13;
+static constexpr unsigned int PoolMaxId = PoolPageSize * PoolPageCount;
+static constexpr size_t PoolBlockSize = 64 * 1024;
+
+/// Strings are stored as a 32-bit length, the bytes and a terminating zero; the
+/// directory points at the bytes.
+struct StringPool::Shard
+{
+    std::mutex Mutex;
+    std::unordered_map<std::string_view, unsigned int, StringHash> Index;
+    std::vector<char *> Blocks;
+    char *pCurrent = nullptr;
+    size_t nFree = 0;
+
+    size_t ArenaBytes = 0;
+    size_t StringBytes = 0;
+    size_t Interns = 0;
+    size_t Hits = 0;
+    size_t SavedBytes = 0;
+
+    ~Shard()
+    {
+        for (char *p: Blocks) delete[] p;
+    }
+
+    char *Allocate(size_t nLen)
+    {
+        nLen = (nLen + 3) & ~static_cast<size_t>(3);
+        if (nLen > nFree)
+        {
+            // Large strings get a block of their own so the current block keeps its space.
+            if (nLen > PoolBlockSize / 4)
+            {
+                char *p = new char[nLen];
+                Blocks.push_back(p);
+                ArenaBytes += nLen;
+                return p;
+            }
+            pCurrent = new char[PoolBlockSize];
+            Blocks.push_back(pCurrent);
+            nFree = PoolBlockSize;
+            ArenaBytes += PoolBlockSize;
+        }
+        char *p = pCurrent;
+        pCurrent += nLen;
+        nFree -= nLen;
+        return p;
+    }
+};
+
+StringPool::StringPool()
+    : m_Shards(new Shard[PoolShardCount]),
+      m_Pages(new std::atomic<std::atomic<const char *> *>[PoolPageCount]()),
+      m_nNextId(1), m_nCount(0)
+{
+}
+
+StringPool::~StringPool()
+{
+    for (unsigned int i = 0; i < PoolPageCount; ++i)
+        delete[] m_Pages[i].load(std::memory_order_relaxed);
+}
+
+StringPool &StringPool::Global()
+{
+    static StringPool pool;
+    return pool;
+}
+
+/// The index tables bucket by the low bits of the same hash, so the shard is taken
+/// from the high bits
+static size_t shardOf(unsigned long long nHash)
+{
+    return static_cast<size_t>(nHash >> 32) % PoolShardCount;
+}
+
+void StringPool::Publish(unsigned int nId, const char *pEntry)
+{
+    std::atomic<std::atomic<const char *> *> &slot = m_Pages[nId >> PoolPageBits];
+    std::atomic<const char *> *page = slot.load(std::memory_order_acquire);
+    if (!page)
+    {
+        // Shards publish concurrently, so a new page is installed with a CAS.
+        std::atomic<const char *> *fresh =
+                new std::atomic<const char *>[PoolPageSize]();
+        if (slot.compare_exchange_strong(page, fresh, std::memory_order_acq_rel))
+            page = fresh;
+        else
+            delete[] fresh;
+    }
+    page[nId & (PoolPageSize - 1)].store(pEntry, std::memory_order_release);
+}
+
+const char *StringPool::Entry(unsigned int nId) const
+{
+    if (nId == 0 || nId >= PoolMaxId) return nullptr;
+    const std::atomic<const char *> *page =
+            m_Pages[nId >> PoolPageBits].load(std::memory_order_acquire);
+    if (!page) return nullptr;
+    return page[nId & (PoolPageSize - 1)].load(std::memory_order_acquire);
+}
+
+StringHandle StringPool::Intern(std::string_view str)
+{
+    if (str.size() > 0xFFFFFFFFu)
+        throw std::length_error("StringPool: string too long");
+
+    Shard &shard = m_Shards[shardOf(Hash::String(str))];
+    std::lock_guard<std::mutex> lock(shard.Mutex);
+    ++shard.Interns;
+    auto it = shard.Index.find(str);
+    if (it != shard.Index.end())
+    {
+        ++shard.Hits;
+        shard.SavedBytes += str.size();
+        return StringHandle{it->second};
+    }
+
+    // Store the string before taking a handle, so that a failed allocation
+    // does not use one up.
+    unsigned int nLen = static_cast<unsigned int>(str.size());
+    char *p = shard.Allocate(sizeof(nLen) + nLen + size_t(1));
+    std::memcpy(p, &nLen, sizeof(nLen));
+    char *pText = p + sizeof(nLen);
+    std::memcpy(pText, str.data(), nLen);
+    pText[nLen] = '\0';
+    it = shard.Index.emplace(std::string_view(pText, nLen), 0).first;
+
+    unsigned int nId = m_nNextId.load(std::memory_order_relaxed);
+    try
+    {
+        do {
+            if (nId >= PoolMaxId)
+                throw std::length_error("StringPool: pool is full");
+        } while (!m_nNextId.compare_exchange_weak(nId, nId + 1,
+                                                  std::memory_order_relaxed));
+        Publish(nId, pText);
+    }
+    catch (...)
+    {
+        shard.Index.erase(it);
+        throw;
+    }
+    it->second = nId;
+    shard.StringBytes += nLen;
+    m_nCount.fetch_add(1, std::memory_order_relaxed);
+    return StringHandle{nId};
+}
+
+StringHandle StringPool::Find(std::string_view str) const
+{
+    Shard &shard = m_Shards[shardOf(Hash::String(str))];
+    std::lock_guard<std::mutex> lock(shard.Mutex);
+    auto it = shard.Index.find(str);
+    return it != shard.Index.end() ? StringHandle{it->second} : StringHandle();
+}
+
+std::string_view StringPool::Resolve(StringHandle handle) const
+{
+    const char *pText = Entry(handle.Id);
+    if (!pText) return std::string_view();
+    unsigned int nLen;
+    std::memcpy(&nLen, pText - sizeof(nLen), sizeof(nLen));
+    return std::string_view(pText, nLen);
+}
+
+const char *StringPool::CStr(StringHandle handle) const
+{
+    const char *pText = Entry(handle.Id);
+    return pText ? pText : "";
+}
+
+size_t StringPool::Count() const
+{
+    return m_nCount.load(std::memory_order_relaxed);
+}
+
+StringPoolStats StringPool::Stats() const
+{
+    StringPoolStats stats;
+    for (unsigned int i = 0; i < PoolShardCount; ++i)
+    {
+        Shard &shard = m_Shards[i];
+        std::lock_guard<std::mutex> lock(shard.Mutex);
+        stats.Strings += shard.Index.size();
+        stats.StringBytes += shard.StringBytes;
+        stats.ArenaBytes += shard.ArenaBytes;
+        // Buckets plus one node per entry holding the key, the id and a link.
+        stats.IndexBytes += shard.Index.bucket_count() * sizeof(void *) +
+                            shard.Index.size() *
+                                    (sizeof(std::string_view) + 2 * sizeof(void *));
+        stats.Interns += shard.Interns;
+        stats.Hits += shard.Hits;
+        stats.SavedBytes += shard.SavedBytes;
+    }
+    stats.DirectoryBytes = PoolPageCount * sizeof(void *);
+    for (unsigned int i = 0; i < PoolPageCount; ++i)
+    {
+        if (m_Pages[i].load(std::memory_order_relaxed))
+            stats.DirectoryBytes += PoolPageSize * sizeof(void *);
+    }
+    return stats;
+}
+
+}// namespace CPL
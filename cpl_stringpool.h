@@ -0,0 +1,130 @@
+/**
+ * CPL - Common Portability Library
+ *
+ * Copyright (C) 2024 Merlot.Rain
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include "cpl_object.h"
+#include <atomic>
+#include <cpl_exports.h>
+#include <functional>
+#include <memory>
+#include <string_view>
+
+namespace CPL {
+
+/// \brief Compact handle of a string interned in a StringPool
+/// \details Two handles from the same pool are equal exactly when their strings are
+/// equal, so comparing and hashing them costs one integer operation.
+struct StringHandle
+{
+    unsigned int Id = 0;///< Index of the string in its pool, 0 for the null handle
+
+    /// \brief Checks whether this is the null handle
+    bool IsNull() const { return Id == 0; }
+
+    bool operator==(StringHandle rhs) const { return Id == rhs.Id; }
+    bool operator!=(StringHandle rhs) const { return Id != rhs.Id; }
+    /// \brief Orders handles by interning order, not by string content
+    bool operator<(StringHandle rhs) const { return Id < rhs.Id; }
+};
+
+/// \brief Memory and usage statistics of a StringPool
+struct StringPoolStats
+{
+    size_t Strings = 0;       ///< Number of distinct strings
+    size_t StringBytes = 0;   ///< Total length of the distinct strings
+    size_t ArenaBytes = 0;    ///< Bytes reserved for string storage
+    size_t IndexBytes = 0;    ///< Estimated bytes used by the lookup tables
+    size_t DirectoryBytes = 0;///< Bytes used by the handle directory
+    size_t Interns = 0;       ///< Number of Intern calls
+    size_t Hits = 0;          ///< Intern calls that found an existing string
+    size_t SavedBytes = 0;    ///< String bytes not stored thanks to those hits
+};
+
+/// \brief Thread-safe pool that stores each distinct string once
+/// \details Strings are copied into arena blocks that are never moved or freed before
+/// the pool, so resolved views stay valid for its lifetime. Interning is spread over
+/// independently locked shards; resolving a handle takes no lock and reads two
+/// atomically published pointers.
+class CPL_API StringPool
+{
+public:
+    StringPool();
+    ~StringPool();
+
+    CPL_DISABLE_COPY(StringPool)
+
+    /// \brief Returns the process-wide pool
+    static StringPool &Global();
+
+    /// \brief Returns the handle of a string, adding it to the pool if needed
+    /// \details Throws std::length_error if the string is 4 GiB or longer or the pool is full.
+    /// A call that throws adds nothing to the pool.
+    /// \param str The string to intern
+    /// \return The handle of the string, never the null handle
+    StringHandle Intern(std::string_view str);
+
+    /// \brief Looks up a string without adding it
+    /// \return The handle of the string, or the null handle if it is not in the pool
+    StringHandle Find(std::string_view str) const;
+
+    /// \brief Returns the string of a handle
+    /// \details Lock-free. The null handle and handles of other pools resolve to an
+    /// empty view unless they happen to be valid in this pool.
+    std::string_view Resolve(StringHandle handle) const;
+
+    /// \brief Returns the null-terminated string of a handle
+    /// \return The string, or an empty string for the null handle
+    const char *CStr(StringHandle handle) const;
+
+    /// \brief Returns the number of distinct strings
+    size_t Count() const;
+
+    /// \brief Returns a snapshot of the memory and usage statistics
+    StringPoolStats Stats() const;
+
+private:
+    struct Shard;
+
+    const char *Entry(unsigned int nId) const;
+    void Publish(unsigned int nId, const char *pEntry);
+
+    /// \brief Locked interning shards, selected by string hash
+    std::unique_ptr<Shard[]> m_Shards;
+    /// \brief Handle directory: pages of entry pointers, allocated on demand
+    std::unique_ptr<std::atomic<std::atomic<const char *> *>[]> m_Pages;
+    /// \brief Next handle to assign
+    std::atomic<unsigned int> m_nNextId;
+    /// \brief Number of strings stored
+    std::atomic<size_t> m_nCount;
+};
+
+}// namespace CPL
+
+namespace std {
+template<>
+struct hash<CPL::StringHandle>
+{
+    size_t operator()(CPL::StringHandle handle) const noexcept
+    {
+        return std::hash<unsigned int>()(handle.Id);
+    }
+};
+}// namespace std
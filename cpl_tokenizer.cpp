@@ -0,0 +1,119 @@
+/**
+ * CPL - Common Portability Library
+ *
+ * Copyright (C) 2024 Merlot.Rain
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "cpl_tokenizer.h"
+#include "cpl_stringhelp.h"
+
+namespace CPL {
+
+/// Every byte value, so a single-character separator can be viewed without
+/// pointing into the tokenizer itself.
+static const struct ByteTable
+{
+    char Value[256];
+    ByteTable()
+    {
+        for (int i = 0; i < 256; ++i) Value[i] = static_cast<char>(i);
+    }
+} s_Bytes;
+
+Tokenizer::Tokenizer(std::string_view str, char sep, TokenizeOptions options,
+                     size_t nMaxTokens)
+    : m_Str(str), m_Sep(&s_Bytes.Value[static_cast<unsigned char>(sep)], 1),
+      m_Searcher(m_Sep), m_nMaxTokens(nMaxTokens), m_Options(options)
+{
+    Reset();
+}
+
+Tokenizer::Tokenizer(std::string_view str, std::string_view sep,
+                     TokenizeOptions options, size_t nMaxTokens)
+    : m_Str(str), m_Sep(sep), m_Searcher(m_Sep), m_nMaxTokens(nMaxTokens),
+      m_Options(options)
+{
+    Reset();
+}
+
+size_t Tokenizer::Find(size_t nFrom) const
+{
+    if (m_Sep.empty()) { return std::string_view::npos; }
+    return m_Searcher.Find(m_Str, nFrom);
+}
+
+bool Tokenizer::Next(std::string_view &token)
+{
+    const bool bSkipEmpty = m_Options.TestFlag(eSkipEmpty);
+    while (!m_bDone)
+    {
+        if (m_nMaxTokens && m_nCount + 1 >= m_nMaxTokens)
+        {
+            if (bSkipEmpty && !m_Sep.empty())
+            {
+                // Separators in front of the remainder would only produce empty tokens.
+                while (m_Str.compare(m_nPos, m_Sep.size(), m_Sep) == 0)
+                    m_nPos += m_Sep.size();
+            }
+            token = m_Str.substr(m_nPos);
+            m_nPos = m_Str.size();
+            m_bDone = true;
+        }
+        else
+        {
+            size_t nHit = Find(m_nPos);
+            if (nHit == std::string_view::npos)
+            {
+                token = m_Str.substr(m_nPos);
+                m_nPos = m_Str.size();
+                m_bDone = true;
+            }
+            else
+            {
+                token = m_Str.substr(m_nPos, nHit - m_nPos);
+                m_nPos = nHit + m_Sep.size();
+            }
+        }
+
+        if (m_Options.TestFlag(eTrim)) { token = StringHelp::Trim(token); }
+        if (bSkipEmpty && token.empty()) { continue; }
+        ++m_nCount;
+        return true;
+    }
+    return false;
+}
+
+void Tokenizer::Reset()
+{
+    m_nPos = 0;
+    m_nCount = 0;
+    m_bDone = m_Str.empty();
+}
+
+size_t Tokenizer::Count() const { return m_nCount; }
+
+std::string_view Tokenizer::Remainder() const { return m_Str.substr(m_nPos); }
+
+Tokenizer::Iterator Tokenizer::begin()
+{
+    Reset();
+    return Iterator(this);
+}
+
+Tokenizer::Iterator Tokenizer::end() { return Iterator(); }
+
+}// namespace CPL
@@ -0,0 +1,137 @@
+/**
+ * CPL - Common Portability Library
+ *
+ * Copyright (C) 2024 Merlot.Rain
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include "cpl_flags.h"
+#include "cpl_searcher.h"
+#include <cpl_exports.h>
+#include <cstddef>
+#include <iterator>
+#include <string_view>
+
+namespace CPL {
+
+/// \brief Lazily splits a string into tokens without allocating
+/// \details Tokens are views into the input string, which must outlive them. Each call
+/// to Next scans only up to the next separator with a Searcher precompiled in the
+/// constructor, so single-character separators use a vectorized byte scan.
+/// An empty input yields no token; consecutive or trailing separators yield empty tokens
+/// unless eSkipEmpty is set.
+class CPL_API Tokenizer
+{
+public:
+    /// \brief Options controlling which tokens are produced
+    enum TokenizeOption
+    {
+        eNone = 0,     ///< Return every token as found
+        eSkipEmpty = 1,///< Do not return empty tokens
+        eTrim = 2,     ///< Remove surrounding whitespace from each token, applied before eSkipEmpty
+    };
+    CPL_DECLARE_FLAGS(TokenizeOptions, TokenizeOption)
+
+    /// \brief Input iterator over the remaining tokens of a Tokenizer
+    class Iterator
+    {
+        Tokenizer *m_pTokenizer;
+        std::string_view m_Token;
+
+    public:
+        using iterator_category = std::input_iterator_tag;
+        using value_type = std::string_view;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const std::string_view *;
+        using reference = const std::string_view &;
+
+        explicit Iterator(Tokenizer *tokenizer = nullptr)
+            : m_pTokenizer(tokenizer)
+        {
+            ++*this;
+        }
+
+        reference operator*() const { return m_Token; }
+        pointer operator->() const { return &m_Token; }
+
+        Iterator &operator++()
+        {
+            if (m_pTokenizer && !m_pTokenizer->Next(m_Token))
+                m_pTokenizer = nullptr;
+            return *this;
+        }
+
+        bool operator==(const Iterator &rhs) const
+        {
+            return m_pTokenizer == rhs.m_pTokenizer;
+        }
+        bool operator!=(const Iterator &rhs) const { return !(*this == rhs); }
+    };
+
+    /// \brief Creates a tokenizer splitting on a single character
+    /// \param str The string to split
+    /// \param sep The separator character
+    /// \param options Token options
+    /// \param nMaxTokens Maximum number of tokens, the last one holds the unsplit remainder; 0 means no limit
+    Tokenizer(std::string_view str, char sep,
+              TokenizeOptions options = eNone, size_t nMaxTokens = 0);
+
+    /// \brief Creates a tokenizer splitting on a separator string
+    /// \details A one-character separator uses the single character scan; an empty
+    /// separator never matches, so the whole input is one token.
+    /// \param str The string to split
+    /// \param sep The separator string, must outlive the tokenizer
+    /// \param options Token options
+    /// \param nMaxTokens Maximum number of tokens, the last one holds the unsplit remainder; 0 means no limit
+    Tokenizer(std::string_view str, std::string_view sep,
+              TokenizeOptions options = eNone, size_t nMaxTokens = 0);
+
+    /// \brief Returns the next token
+    /// \param token Receives the token
+    /// \return True if a token was produced, false when the input is exhausted
+    bool Next(std::string_view &token);
+
+    /// \brief Restarts tokenizing from the beginning of the input
+    void Reset();
+
+    /// \brief Number of tokens returned so far
+    size_t Count() const;
+
+    /// \brief The part of the input that has not been tokenized yet
+    std::string_view Remainder() const;
+
+    /// \brief Restarts tokenizing and returns an iterator to the first token
+    Iterator begin();
+
+    /// \brief Returns the end iterator
+    Iterator end();
+
+private:
+    size_t Find(size_t nFrom) const;
+
+    std::string_view m_Str;    ///< The input string
+    std::string_view m_Sep;    ///< The separator
+    Searcher m_Searcher;       ///< Precompiled search for m_Sep
+    size_t m_nPos = 0;         ///< Start of the unscanned input
+    size_t m_nCount = 0;       ///< Tokens returned so far
+    size_t m_nMaxTokens;       ///< Token limit, 0 for none
+    TokenizeOptions m_Options; ///< Token options
+    bool m_bDone = false;      ///< Whether the input is exhausted
+};
+
+}// namespace CPL
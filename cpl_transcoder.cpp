@@ -0,0 +1,755 @@
+/**
+ * CPL - Common Portability Library
+ *
+ * Copyright (C) 2024 Merlot.Rain
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "cpl_transcoder.h"
+#include "cpl_simd.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <iconv.h>
+#include <stdexcept>
+
+namespace CPL {
+
+namespace {
+
+/// Copies the ASCII bytes at the start of src to 16- or 32-bit units, returns how many
+template<typename Unit>
+size_t widenAscii(const unsigned char *src, size_t nLen, Unit *dst)
+{
+    size_t i = 0;
+#if defined(CPL_SIMD_SSE2)
+    const __m128i zero = _mm_setzero_si128();
+    for (; i + 16 <= nLen; i += 16)
+    {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i));
+        if (_mm_movemask_epi8(v)) break;
+        __m128i lo = _mm_unpacklo_epi8(v, zero);
+        __m128i hi = _mm_unpackhi_epi8(v, zero);
+        __m128i *out = reinterpret_cast<__m128i *>(dst + i);
+        if constexpr (sizeof(Unit) == 2)
+        {
+            _mm_storeu_si128(out, lo);
+            _mm_storeu_si128(out + 1, hi);
+        }
+        else
+        {
+            _mm_storeu_si128(out, _mm_unpacklo_epi16(lo, zero));
+            _mm_storeu_si128(out + 1, _mm_unpackhi_epi16(lo, zero));
+            _mm_storeu_si128(out + 2, _mm_unpacklo_epi16(hi, zero));
+            _mm_storeu_si128(out + 3, _mm_unpackhi_epi16(hi, zero));
+        }
+    }
+#elif defined(CPL_SIMD_NEON) && defined(__aarch64__)
+    for (; i + 16 <= nLen; i += 16)
+    {
+        uint8x16_t v = vld1q_u8(src + i);
+        if (vmaxvq_u8(v) >= 0x80) break;
+        uint16x8_t lo = vmovl_u8(vget_low_u8(v));
+        uint16x8_t hi = vmovl_high_u8(v);
+        if constexpr (sizeof(Unit) == 2)
+        {
+            uint16_t *out = reinterpret_cast<uint16_t *>(dst + i);
+            vst1q_u16(out, lo);
+            vst1q_u16(out + 8, hi);
+        }
+        else
+        {
+            uint32_t *out = reinterpret_cast<uint32_t *>(dst + i);
+            vst1q_u32(out, vmovl_u16(vget_low_u16(lo)));
+            vst1q_u32(out + 4, vmovl_high_u16(lo));
+            vst1q_u32(out + 8, vmovl_u16(vget_low_u16(hi)));
+            vst1q_u32(out + 12, vmovl_high_u16(hi));
+        }
+    }
+#endif
+    for (; i < nLen && src[i] < 0x80; ++i) dst[i] = static_cast<Unit>(src[i]);
+    return i;
+}
+
+/// Copies the units below 0x80 at the start of src to bytes, returns how many
+template<typename Unit>
+size_t narrowAscii(const Unit *src, size_t nLen, unsigned char *dst)
+{
+    size_t i = 0;
+#if defined(CPL_SIMD_SSE2)
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i *in = reinterpret_cast<const __m128i *>(src);
+    if constexpr (sizeof(Unit) == 2)
+    {
+        const __m128i high = _mm_set1_epi16(static_cast<short>(0xFF80));
+        for (; i + 16 <= nLen; i += 16, in += 2)
+        {
+            __m128i a = _mm_loadu_si128(in);
+            __m128i b = _mm_loadu_si128(in + 1);
+            __m128i bits = _mm_and_si128(_mm_or_si128(a, b), high);
+            if (_mm_movemask_epi8(_mm_cmpeq_epi16(bits, zero)) != 0xFFFF) break;
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i),
+                             _mm_packus_epi16(a, b));
+        }
+    }
+    else
+    {
+        const __m128i high = _mm_set1_epi32(static_cast<int>(0xFFFFFF80));
+        for (; i + 16 <= nLen; i += 16, in += 4)
+        {
+            __m128i a = _mm_loadu_si128(in);
+            __m128i b = _mm_loadu_si128(in + 1);
+            __m128i c = _mm_loadu_si128(in + 2);
+            __m128i d = _mm_loadu_si128(in + 3);
+            __m128i bits = _mm_and_si128(
+                    _mm_or_si128(_mm_or_si128(a, b), _mm_or_si128(c, d)), high);
+            if (_mm_movemask_epi8(_mm_cmpeq_epi32(bits, zero)) != 0xFFFF) break;
+            // the values are below 0x80, so the saturating packs are exact
+            __m128i ab = _mm_packs_epi32(a, b);
+            __m128i cd = _mm_packs_epi32(c, d);
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i),
+                             _mm_packus_epi16(ab, cd));
+        }
+    }
+#elif defined(CPL_SIMD_NEON) && defined(__aarch64__)
+    if constexpr (sizeof(Unit) == 2)
+    {
+        const uint16_t *in = reinterpret_cast<const uint16_t *>(src);
+        for (; i + 16 <= nLen; i += 16)
+        {
+            uint16x8_t a = vld1q_u16(in + i);
+            uint16x8_t b = vld1q_u16(in + i + 8);
+            if (vmaxvq_u16(vorrq_u16(a, b)) >= 0x80) break;
+            vst1q_u8(dst + i, vcombine_u8(vmovn_u16(a), vmovn_u16(b)));
+        }
+    }
+    else
+    {
+        const uint32_t *in = reinterpret_cast<const uint32_t *>(src);
+        for (; i + 16 <= nLen; i += 16)
+        {
+            uint32x4_t a = vld1q_u32(in + i);
+            uint32x4_t b = vld1q_u32(in + i + 4);
+            uint32x4_t c = vld1q_u32(in + i + 8);
+            uint32x4_t d = vld1q_u32(in + i + 12);
+            if (vmaxvq_u32(vorrq_u32(vorrq_u32(a, b), vorrq_u32(c, d))) >= 0x80)
+                break;
+            uint16x8_t ab = vcombine_u16(vmovn_u32(a), vmovn_u32(b));
+            uint16x8_t cd = vcombine_u16(vmovn_u32(c), vmovn_u32(d));
+            vst1q_u8(dst + i, vcombine_u8(vmovn_u16(ab), vmovn_u16(cd)));
+        }
+    }
+#endif
+    for (; i < nLen && static_cast<uint32_t>(src[i]) < 0x80; ++i)
+        dst[i] = static_cast<unsigned char>(src[i]);
+    return i;
+}
+
+/// Decodes the multi-byte sequence at p, whose lead byte is at least 0x80.
+/// Returns the sequence length, or 0 with eStatus set if it is invalid.
+int decodeUtf8(const unsigned char *p, size_t nLeft, char32_t &cp,
+               TranscodeStatus &eStatus)
+{
+    unsigned char lead = p[0];
+    int nLen;
+    char32_t nMin;
+    if (lead < 0xC0)
+    {
+        eStatus = TranscodeStatus::eInvalidByte;
+        return 0;
+    }
+    else if (lead < 0xE0)
+    {
+        nLen = 2;
+        nMin = 0x80;
+        cp = lead & 0x1F;
+    }
+    else if (lead < 0xF0)
+    {
+        nLen = 3;
+        nMin = 0x800;
+        cp = lead & 0x0F;
+    }
+    else if (lead < 0xF8)
+    {
+        nLen = 4;
+        nMin = 0x10000;
+        cp = lead & 0x07;
+    }
+    else
+    {
+        eStatus = TranscodeStatus::eInvalidByte;
+        return 0;
+    }
+
+    for (int k = 1; k < nLen; ++k)
+    {
+        if (static_cast<size_t>(k) >= nLeft || (p[k] & 0xC0) != 0x80)
+        {
+            eStatus = TranscodeStatus::eTruncated;
+            return 0;
+        }
+        cp = (cp << 6) | (p[k] & 0x3F);
+    }
+
+    if (cp < nMin) eStatus = TranscodeStatus::eOverlong;
+    else if (cp > 0x10FFFF)
+        eStatus = TranscodeStatus::eTooLarge;
+    else if (cp >= 0xD800 && cp <= 0xDFFF)
+        eStatus = TranscodeStatus::eSurrogate;
+    else
+        return nLen;
+    return 0;
+}
+
+/// Encodes a code point of at least 0x80 as UTF-8, returns the number of bytes
+int encodeUtf8(char32_t cp, unsigned char *dst)
+{
+    if (cp < 0x800)
+    {
+        dst[0] = static_cast<unsigned char>(0xC0 | (cp >> 6));
+        dst[1] = static_cast<unsigned char>(0x80 | (cp & 0x3F));
+        return 2;
+    }
+    if (cp < 0x10000)
+    {
+        dst[0] = static_cast<unsigned char>(0xE0 | (cp >> 12));
+        dst[1] = static_cast<unsigned char>(0x80 | ((cp >> 6) & 0x3F));
+        dst[2] = static_cast<unsigned char>(0x80 | (cp & 0x3F));
+        return 3;
+    }
+    dst[0] = static_cast<unsigned char>(0xF0 | (cp >> 18));
+    dst[1] = static_cast<unsigned char>(0x80 | ((cp >> 12) & 0x3F));
+    dst[2] = static_cast<unsigned char>(0x80 | ((cp >> 6) & 0x3F));
+    dst[3] = static_cast<unsigned char>(0x80 | (cp & 0x3F));
+    return 4;
+}
+
+template<typename Unit>
+TranscodeResult utf8ToUnits(const char *src, size_t nLen, Unit *dst)
+{
+    const unsigned char *p = reinterpret_cast<const unsigned char *>(src);
+    TranscodeResult result;
+    size_t i = 0;
+    size_t o = 0;
+    while (i < nLen)
+    {
+        if (p[i] < 0x80)
+        {
+            size_t n = widenAscii(p + i, nLen - i, dst + o);
+            i += n;
+            o += n;
+            continue;
+        }
+        char32_t cp;
+        int n = decodeUtf8(p + i, nLen - i, cp, result.Status);
+        if (!n) break;
+        i += n;
+        if constexpr (sizeof(Unit) == 2)
+        {
+            if (cp >= 0x10000)
+            {
+                cp -= 0x10000;
+                dst[o++] = static_cast<Unit>(0xD800 + (cp >> 10));
+                dst[o++] = static_cast<Unit>(0xDC00 + (cp & 0x3FF));
+                continue;
+            }
+        }
+        dst[o++] = static_cast<Unit>(cp);
+    }
+    result.Read = i;
+    result.Written = o;
+    return result;
+}
+
+template<typename Unit>
+TranscodeResult unitsToUtf8(const Unit *src, size_t nLen, char *dst)
+{
+    unsigned char *out = reinterpret_cast<unsigned char *>(dst);
+    TranscodeResult result;
+    size_t i = 0;
+    size_t o = 0;
+    while (i < nLen)
+    {
+        char32_t cp = static_cast<char32_t>(src[i]);
+        if (cp < 0x80)
+        {
+            size_t n = narrowAscii(src + i, nLen - i, out + o);
+            i += n;
+            o += n;
+            continue;
+        }
+        size_t nUnits = 1;
+        if (cp >= 0xD800 && cp <= 0xDFFF)
+        {
+            // only a high surrogate followed by a low one is valid, and only in UTF-16
+            char32_t next = sizeof(Unit) == 2 && cp < 0xDC00 && i + 1 < nLen
+                                    ? static_cast<char32_t>(src[i + 1])
+                                    : 0;
+            if (next < 0xDC00 || next > 0xDFFF)
+            {
+                result.Status = TranscodeStatus::eSurrogate;
+                break;
+            }
+            cp = 0x10000 + ((cp - 0xD800) << 10) + (next - 0xDC00);
+            nUnits = 2;
+        }
+        else if (cp > 0x10FFFF)
+        {
+            result.Status = TranscodeStatus::eTooLarge;
+            break;
+        }
+        o += encodeUtf8(cp, out + o);
+        i += nUnits;
+    }
+    result.Read = i;
+    result.Written = o;
+    return result;
+}
+
+TranscodeResult validateScalar(const unsigned char *p, size_t nLen, size_t i)
+{
+    TranscodeResult result;
+    char32_t cp;
+    while (i < nLen)
+    {
+        if (p[i] < 0x80)
+        {
+            ++i;
+            continue;
+        }
+        int n = decodeUtf8(p + i, nLen - i, cp, result.Status);
+        if (!n) break;
+        i += n;
+    }
+    result.Read = i;
+    result.Written = i;
+    return result;
+}
+
+#if defined(CPL_SIMD_SSSE3) || (defined(CPL_SIMD_NEON) && defined(__aarch64__))
+#define CPL_UTF8_LOOKUP_VALIDATION 1
+
+#if defined(CPL_SIMD_SSSE3)
+using Vec = __m128i;
+inline Vec vload(const unsigned char *p)
+{
+    return _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+}
+inline Vec vdup(unsigned char c) { return _mm_set1_epi8(static_cast<char>(c)); }
+inline Vec vzero() { return _mm_setzero_si128(); }
+inline Vec vand(Vec a, Vec b) { return _mm_and_si128(a, b); }
+inline Vec vor(Vec a, Vec b) { return _mm_or_si128(a, b); }
+inline Vec vxor(Vec a, Vec b) { return _mm_xor_si128(a, b); }
+inline Vec vsubs(Vec a, Vec b) { return _mm_subs_epu8(a, b); }
+inline Vec vlookup(Vec table, Vec idx) { return _mm_shuffle_epi8(table, idx); }
+inline Vec vhigh(Vec v) { return vand(_mm_srli_epi16(v, 4), vdup(0x0F)); }
+inline Vec vlow(Vec v) { return vand(v, vdup(0x0F)); }
+template<int N>
+inline Vec vprev(Vec cur, Vec prev)
+{
+    return _mm_alignr_epi8(cur, prev, 16 - N);
+}
+inline bool vany(Vec v)
+{
+    return _mm_movemask_epi8(_mm_cmpeq_epi8(v, vzero())) != 0xFFFF;
+}
+inline bool vascii(Vec v) { return _mm_movemask_epi8(v) == 0; }
+#else
+using Vec = uint8x16_t;
+inline Vec vload(const unsigned char *p) { return vld1q_u8(p); }
+inline Vec vdup(unsigned char c) { return vdupq_n_u8(c); }
+inline Vec vzero() { return vdupq_n_u8(0); }
+inline Vec vand(Vec a, Vec b) { return vandq_u8(a, b); }
+inline Vec vor(Vec a, Vec b) { return vorrq_u8(a, b); }
+inline Vec vxor(Vec a, Vec b) { return veorq_u8(a, b); }
+inline Vec vsubs(Vec a, Vec b) { return vqsubq_u8(a, b); }
+inline Vec vlookup(Vec table, Vec idx) { return vqtbl1q_u8(table, idx); }
+inline Vec vhigh(Vec v) { return vshrq_n_u8(v, 4); }
+inline Vec vlow(Vec v) { return vand(v, vdup(0x0F)); }
+template<int N>
+inline Vec vprev(Vec cur, Vec prev)
+{
+    return vextq_u8(prev, cur, 16 - N);
+}
+inline bool vany(Vec v) { return vmaxvq_u8(v) != 0; }
+inline bool vascii(Vec v) { return vmaxvq_u8(v) < 0x80; }
+#endif
+
+// Error classes of a byte pair, after Keiser and Lemire, "Validating UTF-8 in less
+// than one instruction per byte". Each table maps a nibble of the pair to the classes
+// it allows; a pair is invalid where the three lookups share a bit.
+constexpr unsigned char kTooShort = 1 << 0; // lead or ASCII followed by a lead or ASCII
+constexpr unsigned char kTooLong = 1 << 1;  // ASCII followed by a continuation
+constexpr unsigned char kOverlong3 = 1 << 2;// E0 followed by 80..9F
+constexpr unsigned char kTooLarge = 1 << 3; // F4 followed by 90..BF, or F5..FF
+constexpr unsigned char kSurrogate = 1 << 4;// ED followed by A0..BF
+constexpr unsigned char kOverlong2 = 1 << 5;// C0 or C1
+constexpr unsigned char kTooLarge1000 = 1 << 6;// F5..FF followed by 80..8F
+constexpr unsigned char kOverlong4 = 1 << 6;   // F0 followed by 80..8F
+constexpr unsigned char kTwoConts = 1 << 7;    // continuation after a continuation
+constexpr unsigned char kCarry = kTooShort | kTooLong | kTwoConts;
+
+alignas(16) const unsigned char s_Byte1High[16] = {
+        kTooLong, kTooLong, kTooLong, kTooLong, kTooLong, kTooLong, kTooLong,
+        kTooLong, kTwoConts, kTwoConts, kTwoConts, kTwoConts,
+        kTooShort | kOverlong2, kTooShort, kTooShort | kOverlong3 | kSurrogate,
+        kTooShort | kTooLarge | kTooLarge1000 | kOverlong4};
+
+alignas(16) const unsigned char s_Byte1Low[16] = {
+        kCarry | kOverlong3 | kOverlong2 | kOverlong4,
+        kCarry | kOverlong2,
+        kCarry,
+        kCarry,
+        kCarry | kTooLarge,
+        kCarry | kTooLarge | kTooLarge1000,
+        kCarry | kTooLarge | kTooLarge1000,
+        kCarry | kTooLarge | kTooLarge1000,
+        kCarry | kTooLarge | kTooLarge1000,
+        kCarry | kTooLarge | kTooLarge1000,
+        kCarry | kTooLarge | kTooLarge1000,
+        kCarry | kTooLarge | kTooLarge1000,
+        kCarry | kTooLarge | kTooLarge1000,
+        kCarry | kTooLarge | kTooLarge1000 | kSurrogate,
+        kCarry | kTooLarge | kTooLarge1000,
+        kCarry | kTooLarge | kTooLarge1000};
+
+alignas(16) const unsigned char s_Byte2High[16] = {
+        kTooShort, kTooShort, kTooShort, kTooShort, kTooShort, kTooShort,
+        kTooShort, kTooShort,
+        kTooLong | kOverlong2 | kTwoConts | kOverlong3 | kTooLarge1000 | kOverlong4,
+        kTooLong | kOverlong2 | kTwoConts | kOverlong3 | kTooLarge,
+        kTooLong | kOverlong2 | kTwoConts | kSurrogate | kTooLarge,
+        kTooLong | kOverlong2 | kTwoConts | kSurrogate | kTooLarge, kTooShort,
+        kTooShort, kTooShort, kTooShort};
+
+// Bytes that still need continuations when they end a block: anything in the last
+// three positions that starts a sequence longer than the room left.
+alignas(16) const unsigned char s_IncompleteLimit[16] = {
+        0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+        0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xEF, 0xDF, 0xBF};
+
+struct Utf8Checker
+{
+    Vec Error = vzero();
+    Vec PrevInput = vzero();
+    Vec PrevIncomplete = vzero();
+
+    void Check(Vec input)
+    {
+        if (vascii(input))
+        {
+            Error = vor(Error, PrevIncomplete);
+            PrevIncomplete = vzero();
+        }
+        else
+        {
+            Vec prev1 = vprev<1>(input, PrevInput);
+            Vec special = vand(
+                    vand(vlookup(vload(s_Byte1High), vhigh(prev1)),
+                         vlookup(vload(s_Byte1Low), vlow(prev1))),
+                    vlookup(vload(s_Byte2High), vhigh(input)));
+            // third and fourth bytes of a sequence must be continuations; the pair
+            // check above does not see that far back
+            Vec third = vsubs(vprev<2>(input, PrevInput), vdup(0xE0 - 0x80));
+            Vec fourth = vsubs(vprev<3>(input, PrevInput), vdup(0xF0 - 0x80));
+            Vec must23 = vand(vor(third, fourth), vdup(0x80));
+            Error = vor(Error, vxor(must23, special));
+            PrevIncomplete = vsubs(input, vload(s_IncompleteLimit));
+        }
+        PrevInput = input;
+    }
+};
+#endif
+
+[[noreturn]] void throwInvalid(const char *encoding, const TranscodeResult &result)
+{
+    throw std::invalid_argument(std::string("Invalid ") + encoding + " at offset " +
+                                std::to_string(result.Read) + ": " +
+                                Transcoder::StatusText(result.Status));
+}
+
+}// namespace
+
+TranscodeResult Transcoder::ValidateUtf8(const char *src, size_t nLen)
+{
+    const unsigned char *p = reinterpret_cast<const unsigned char *>(src);
+#if defined(CPL_UTF8_LOOKUP_VALIDATION)
+    Utf8Checker checker;
+    size_t i = 0;
+    for (; i + 16 <= nLen; i += 16)
+    {
+        checker.Check(vload(p + i));
+        if (vany(checker.Error)) break;
+    }
+    if (i + 16 > nLen)
+    {
+        // the zero padding is ASCII, so a sequence cut off by the end is reported
+        if (i < nLen)
+        {
+            unsigned char tail[16] = {};
+            std::memcpy(tail, p + i, nLen - i);
+            checker.Check(vload(tail));
+        }
+        else
+            checker.Error = vor(checker.Error, checker.PrevIncomplete);
+        if (!vany(checker.Error))
+        {
+            TranscodeResult result;
+            result.Read = nLen;
+            result.Written = nLen;
+            return result;
+        }
+    }
+    // decode from the first character boundary that may start the invalid sequence
+    size_t nStart = i >= 3 ? i - 3 : 0;
+    while (nStart < i && (p[nStart] & 0xC0) == 0x80) ++nStart;
+    return validateScalar(p, nLen, nStart);
+#else
+    return validateScalar(p, nLen, 0);
+#endif
+}
+
+TranscodeResult Transcoder::Utf8ToUtf16(const char *src, size_t nLen,
+                                        char16_t *dst)
+{
+    return utf8ToUnits(src, nLen, dst);
+}
+
+TranscodeResult Transcoder::Utf8ToUtf32(const char *src, size_t nLen,
+                                        char32_t *dst)
+{
+    return utf8ToUnits(src, nLen, dst);
+}
+
+TranscodeResult Transcoder::Utf16ToUtf8(const char16_t *src, size_t nLen,
+                                        char *dst)
+{
+    return unitsToUtf8(src, nLen, dst);
+}
+
+TranscodeResult Transcoder::Utf32ToUtf8(const char32_t *src, size_t nLen,
+                                        char *dst)
+{
+    return unitsToUtf8(src, nLen, dst);
+}
+
+std::wstring Transcoder::Utf8ToWide(std::string_view utf8)
+{
+    std::wstring wide(utf8.size(), L'\0');
+    if (utf8.empty()) return wide;
+    TranscodeResult result;
+    if constexpr (sizeof(wchar_t) == 2)
+        result = Utf8ToUtf16(utf8.data(), utf8.size(),
+                             reinterpret_cast<char16_t *>(&wide[0]));
+    else
+        result = Utf8ToUtf32(utf8.data(), utf8.size(),
+                             reinterpret_cast<char32_t *>(&wide[0]));
+    if (!result.Ok()) throwInvalid("UTF-8", result);
+    wide.resize(result.Written);
+    return wide;
+}
+
+std::string Transcoder::WideToUtf8(std::wstring_view wide)
+{
+    std::string utf8(wide.size() * (sizeof(wchar_t) == 2 ? 3 : 4), '\0');
+    if (wide.empty()) return utf8;
+    TranscodeResult result;
+    if constexpr (sizeof(wchar_t) == 2)
+        result = Utf16ToUtf8(reinterpret_cast<const char16_t *>(wide.data()),
+                             wide.size(), &utf8[0]);
+    else
+        result = Utf32ToUtf8(reinterpret_cast<const char32_t *>(wide.data()),
+                             wide.size(), &utf8[0]);
+    if (!result.Ok())
+        throwInvalid(sizeof(wchar_t) == 2 ? "UTF-16" : "UTF-32", result);
+    utf8.resize(result.Written);
+    return utf8;
+}
+
+const char *Transcoder::StatusText(TranscodeStatus eStatus)
+{
+    switch (eStatus)
+    {
+        case TranscodeStatus::eOk:
+            return "ok";
+        case TranscodeStatus::eInvalidByte:
+            return "invalid lead byte";
+        case TranscodeStatus::eTruncated:
+            return "truncated sequence";
+        case TranscodeStatus::eOverlong:
+            return "overlong encoding";
+        case TranscodeStatus::eSurrogate:
+            return "surrogate code point";
+        case TranscodeStatus::eTooLarge:
+            return "code point above U+10FFFF";
+    }
+    return "unknown";
+}
+
+/* ------------------------- TranscodingInputStream ------------------------- */
+
+static constexpr size_t s_nTranscodeBlock = 16384;
+
+TranscodingInputStream::TranscodingInputStream(InputStream *inner,
+                                               CodePageID eCodePage)
+    : m_Inner(inner)
+{
+    if (eCodePage == CP_UTF8) return;
+    std::string encoding = CodePageToIconvEncoding(eCodePage);
+    iconv_t cd = encoding.empty() ? (iconv_t) -1
+                                  : iconv_open("UTF-8", encoding.c_str());
+    if (cd == (iconv_t) -1)
+        throw std::invalid_argument("Unsupported code page " +
+                                    std::to_string(eCodePage));
+    m_pIconv = cd;
+}
+
+TranscodingInputStream::~TranscodingInputStream()
+{
+    if (m_pIconv) iconv_close(static_cast<iconv_t>(m_pIconv));
+}
+
+InputStream *TranscodingInputStream::Inner() const { return m_Inner.p; }
+
+bool TranscodingInputStream::HasError() const { return m_bError; }
+
+void TranscodingInputStream::ConvertUtf8()
+{
+    // hold back a trailing sequence that the next read may complete
+    size_t nUsable = m_Input.size();
+    if (!m_bInnerEof)
+    {
+        size_t nBack = 0;
+        while (nBack < 3 && nBack < nUsable &&
+               (static_cast<unsigned char>(m_Input[nUsable - 1 - nBack]) & 0xC0) ==
+                       0x80)
+            ++nBack;
+        if (nBack < nUsable)
+        {
+            unsigned char lead =
+                    static_cast<unsigned char>(m_Input[nUsable - 1 - nBack]);
+            size_t nNeed = lead >= 0xF0 ? 4 : lead >= 0xE0 ? 3 : lead >= 0xC0 ? 2 : 1;
+            if (nNeed > nBack + 1) nUsable -= nBack + 1;
+        }
+    }
+
+    TranscodeResult result = Transcoder::ValidateUtf8(m_Input.data(), nUsable);
+    m_Output.assign(m_Input.begin(), m_Input.begin() + result.Read);
+    m_Input.erase(m_Input.begin(), m_Input.begin() + result.Read);
+    if (!result.Ok()) m_bError = true;
+}
+
+void TranscodingInputStream::ConvertIconv()
+{
+    iconv_t cd = static_cast<iconv_t>(m_pIconv);
+    m_Output.resize(m_Input.size() * 4 + 16);
+    char *pIn = m_Input.data();
+    size_t nIn = m_Input.size();
+    char *pOut = m_Output.data();
+    size_t nOut = m_Output.size();
+    size_t r = iconv(cd, &pIn, &nIn, &pOut, &nOut);
+    if (r == (size_t) -1 && errno != E2BIG)
+    {
+        // EINVAL is a character cut off by the end of the input, which is only an
+        // error if no more input follows
+        if (errno != EINVAL || m_bInnerEof) m_bError = true;
+    }
+    if (!m_bError && m_bInnerEof && !nIn)
+        iconv(cd, nullptr, nullptr, &pOut, &nOut);
+    m_Output.resize(pOut - m_Output.data());
+    m_Input.erase(m_Input.begin(), m_Input.begin() + (pIn - m_Input.data()));
+}
+
+bool TranscodingInputStream::Refill()
+{
+    m_Output.clear();
+    m_nOutPos = 0;
+    while (m_Output.empty() && !m_bError)
+    {
+        if (!m_bInnerEof)
+        {
+            size_t nHave = m_Input.size();
+            m_Input.resize(nHave + s_nTranscodeBlock);
+            int n = m_Inner->RawRead(
+                    reinterpret_cast<unsigned char *>(m_Input.data() + nHave),
+                    static_cast<int>(s_nTranscodeBlock));
+            if (n <= 0)
+            {
+                n = 0;
+                m_bInnerEof = true;
+            }
+            m_Input.resize(nHave + n);
+        }
+        else if (m_Input.empty())
+            break;
+
+        if (m_pIconv) ConvertIconv();
+        else
+            ConvertUtf8();
+    }
+    return !m_Output.empty();
+}
+
+int TranscodingInputStream::RawRead(unsigned char *buff, int nLen)
+{
+    if (!buff || nLen <= 0) return 0;
+    int nTotal = 0;
+    while (nTotal < nLen)
+    {
+        if (m_nOutPos == m_Output.size() && !Refill()) break;
+        size_t n = std::min(m_Output.size() - m_nOutPos,
+                            static_cast<size_t>(nLen - nTotal));
+        std::memcpy(buff + nTotal, m_Output.data() + m_nOutPos, n);
+        m_nOutPos += n;
+        nTotal += static_cast<int>(n);
+    }
+    m_nOffset += nTotal;
+    return nTotal;
+}
+
+int TranscodingInputStream::RawRead(unsigned char *buff, int nLen,
+                                    const unsigned char **pointer)
+{
+    if (pointer) *pointer = nullptr;
+    return RawRead(buff, nLen);
+}
+
+int TranscodingInputStream::Skip(int nLen)
+{
+    unsigned char scratch[512];
+    int nSkipped = 0;
+    while (nSkipped < nLen)
+    {
+        int n = RawRead(scratch, std::min(nLen - nSkipped,
+                                          static_cast<int>(sizeof(scratch))));
+        if (n <= 0) break;
+        nSkipped += n;
+    }
+    return nSkipped;
+}
+
+unsigned long long TranscodingInputStream::Offset() const { return m_nOffset; }
+
+bool TranscodingInputStream::Eof() const
+{
+    if (m_nOutPos != m_Output.size()) return false;
+    if (m_bError) return true;
+    return m_Input.empty() && (m_bInnerEof || m_Inner->Eof());
+}
+
+}// namespace CPL
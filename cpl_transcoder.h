@@ -0,0 +1,153 @@
+/**
+ * CPL - Common Portability Library
+ *
+ * Copyright (C) 2024 Merlot.Rain
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include "cpl_stringhelp.h"
+#include <cpl_exports.h>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace CPL {
+
+/// \brief Outcome of a Unicode transcoding step
+enum class TranscodeStatus : int
+{
+    eOk,         ///< The whole input was converted
+    eInvalidByte,///< A byte that cannot start a UTF-8 sequence, such as a stray continuation byte
+    eTruncated,  ///< A UTF-8 sequence cut short by a non-continuation byte or the end of the input
+    eOverlong,   ///< A UTF-8 sequence longer than needed for its code point
+    eSurrogate,  ///< An encoded surrogate in UTF-8 or UTF-32, or an unpaired one in UTF-16
+    eTooLarge,   ///< A code point above U+10FFFF
+};
+
+/// \brief Result of a Unicode transcoding step
+struct TranscodeResult
+{
+    TranscodeStatus Status = TranscodeStatus::eOk;///< Whether the input was valid
+    size_t Read = 0;   ///< Input units consumed; on error, the offset of the invalid sequence
+    size_t Written = 0;///< Output units written, up to the error if there is one
+
+    /// \brief Whether the whole input was converted
+    bool Ok() const { return Status == TranscodeStatus::eOk; }
+};
+
+/// \brief Conversions between UTF-8, UTF-16 and UTF-32 without iconv
+/// \details Runs of ASCII are widened or narrowed 16 units per step with SSE2 or NEON
+/// when enabled at compile time; other characters are decoded one sequence at a time
+/// with full validation. Conversion stops at the first invalid sequence and reports
+/// where it is, nothing is replaced.
+class CPL_API Transcoder
+{
+public:
+    /// \brief Checks whether text is well-formed UTF-8
+    /// \details Blocks of 16 bytes are classified with nibble lookup tables using SSSE3
+    /// or NEON when enabled at compile time; the exact position of an error is then
+    /// found by decoding from the failing block.
+    /// \param src The text
+    /// \param nLen The number of bytes
+    /// \return Read and Written hold the offset of the first invalid sequence, or nLen
+    static TranscodeResult ValidateUtf8(const char *src, size_t nLen);
+
+    /// \brief Converts UTF-8 to UTF-16
+    /// \param src The UTF-8 input
+    /// \param nLen The number of bytes
+    /// \param dst Receives at most nLen code units
+    static TranscodeResult Utf8ToUtf16(const char *src, size_t nLen, char16_t *dst);
+
+    /// \brief Converts UTF-8 to UTF-32
+    /// \param src The UTF-8 input
+    /// \param nLen The number of bytes
+    /// \param dst Receives at most nLen code units
+    static TranscodeResult Utf8ToUtf32(const char *src, size_t nLen, char32_t *dst);
+
+    /// \brief Converts UTF-16 to UTF-8
+    /// \param src The UTF-16 input
+    /// \param nLen The number of code units
+    /// \param dst Receives at most 3 * nLen bytes
+    static TranscodeResult Utf16ToUtf8(const char16_t *src, size_t nLen, char *dst);
+
+    /// \brief Converts UTF-32 to UTF-8
+    /// \param src The UTF-32 input
+    /// \param nLen The number of code units
+    /// \param dst Receives at most 4 * nLen bytes
+    static TranscodeResult Utf32ToUtf8(const char32_t *src, size_t nLen, char *dst);
+
+    /// \brief Converts UTF-8 to a wide string, UTF-16 or UTF-32 depending on wchar_t
+    /// \details Throws std::invalid_argument naming the offset of an invalid sequence.
+    static std::wstring Utf8ToWide(std::string_view utf8);
+
+    /// \brief Converts a wide string, UTF-16 or UTF-32 depending on wchar_t, to UTF-8
+    /// \details Throws std::invalid_argument naming the offset of an invalid sequence.
+    static std::string WideToUtf8(std::wstring_view wide);
+
+    /// \brief Returns a short description of a status
+    static const char *StatusText(TranscodeStatus eStatus);
+};
+
+/// \brief Input stream that converts text read from another stream to UTF-8
+/// \details The text is converted in blocks, so memory use does not depend on its
+/// size, and characters split across reads of the wrapped stream are completed by
+/// the next read. UTF-8 input is validated and passed through; other code pages are
+/// converted with iconv. Reading stops at the first invalid or truncated character;
+/// HasError then returns true.
+class CPL_API TranscodingInputStream : public InputStream
+{
+    InputStreamPtr m_Inner;           ///< Supplies the text
+    void *m_pIconv = nullptr;         ///< The iconv_t, null for UTF-8 text
+    std::vector<char> m_Input;        ///< Text read but not yet converted
+    std::vector<char> m_Output;       ///< Converted text not yet read
+    size_t m_nOutPos = 0;             ///< Read position in m_Output
+    unsigned long long m_nOffset = 0; ///< Bytes read
+    bool m_bInnerEof = false;         ///< Whether the text is exhausted
+    bool m_bError = false;            ///< Whether invalid text was found
+
+public:
+    /// \brief Wraps an input stream
+    /// \details Throws std::invalid_argument if iconv does not support the code page.
+    /// \param inner The stream supplying the text, a reference to it is held
+    /// \param eCodePage The encoding of the text
+    TranscodingInputStream(InputStream *inner, CodePageID eCodePage);
+
+    /// \brief Destructor
+    ~TranscodingInputStream();
+
+    /// \brief Returns the wrapped stream
+    InputStream *Inner() const;
+
+    /// \brief Checks whether invalid or truncated text was found
+    bool HasError() const;
+
+    virtual int Skip(int nLen);
+    virtual int RawRead(unsigned char *buff, int nLen);
+    virtual int RawRead(unsigned char *buff, int nLen,
+                        const unsigned char **pointer);
+    virtual unsigned long long Offset() const;
+    virtual bool Eof() const;
+
+private:
+    bool Refill();
+    void ConvertUtf8();
+    void ConvertIconv();
+};
+CPL_SMARTER_PTR(TranscodingInputStream)
+
+}// namespace CPL
@@ -0,0 +1,129 @@
+/**
+ * CPL - Common Portability Library
+ *
+ * Copyright (C) 2024 Merlot.Rain
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <cpl_ports.h>
+#include <gtest/gtest.h>
+
+using namespace CPL;
+
+static bool isInline(const Any &value)
+{
+    const char *p = static_cast<const char *>(value.ValuePtr());
+    const char *pObject = reinterpret_cast<const char *>(&value);
+    return p >= pObject && p < pObject + sizeof(Any);
+}
+
+TEST(Any, InlineStorage)
+{
+    const std::string shortText(Any::InlineCapacity - 1, 's');
+    const std::string longText(Any::InlineCapacity, 'l');
+
+    Any shortAny(shortText);
+    Any longAny(longText);
+    ASSERT_TRUE(isInline(shortAny));
+    ASSERT_FALSE(isInline(longAny));
+    ASSERT_EQ(shortAny.ValueSize(), Any::InlineCapacity - 1);
+    ASSERT_STREQ(shortAny.AsString(), shortText.c_str());
+    ASSERT_STREQ(longAny.AsString(), longText.c_str());
+
+    // copies and moves keep inline values inline and heap values intact
+    Any copy(shortAny);
+    ASSERT_TRUE(isInline(copy));
+    ASSERT_TRUE(copy == shortAny);
+    Any moved(std::move(copy));
+    ASSERT_TRUE(isInline(moved));
+    ASSERT_STREQ(moved.AsString(), shortText.c_str());
+    ASSERT_EQ(copy.Type, eEmpty);
+
+    moved.Swap(longAny);
+    ASSERT_STREQ(moved.AsString(), longText.c_str());
+    ASSERT_STREQ(longAny.AsString(), shortText.c_str());
+    ASSERT_TRUE(isInline(longAny));
+
+    std::vector<Any> values;
+    for (int i = 0; i < 100; ++i) values.emplace_back(std::to_string(i));
+    for (int i = 0; i < 100; ++i)
+        ASSERT_EQ(values[i].ToString(), std::to_string(i));
+
+    const unsigned char bytes[40] = {1, 0, 2, 0, 3};
+    Any smallBlob(bytes, 5);
+    Any largeBlob(bytes, 40);
+    ASSERT_TRUE(isInline(smallBlob));
+    ASSERT_FALSE(isInline(largeBlob));
+    unsigned char out[40] = {};
+    ASSERT_EQ(Any(smallBlob).AsBlob(out), 5);
+    ASSERT_EQ(std::memcmp(out, bytes, 5), 0);
+    ASSERT_EQ(Any(largeBlob).ValueSize(), 40);
+
+    Any blob(eBinary);
+    std::memcpy(blob.AllocBlob(40), bytes, 40);
+    ASSERT_TRUE(blob == largeBlob);
+    std::memcpy(blob.AllocBlob(5), bytes, 5);
+    ASSERT_TRUE(blob == smallBlob);
+    ASSERT_TRUE(isInline(blob));
+}
+
+TEST(Any, SharedPayload)
+{
+    const std::string text(100, 't');
+    Any original(text);
+    ASSERT_FALSE(original.IsShared());
+    ASSERT_TRUE(original.Share().IsShared());
+    ASSERT_STREQ(original.AsString(), text.c_str());
+    ASSERT_EQ(original.ValueSize(), 100);
+
+    // copies refer to the same payload and outlive the original
+    Any copy(original);
+    ASSERT_TRUE(copy.IsShared());
+    ASSERT_EQ(copy.ValuePtr(), original.ValuePtr());
+    std::vector<Any> rows(10, copy);
+    original = Any(1);
+    ASSERT_STREQ(rows[9].AsString(), text.c_str());
+
+    // writes give the object its own copy
+    copy.Set("xy", 2);
+    ASSERT_FALSE(copy.IsShared());
+    ASSERT_EQ(std::string(copy.AsString()), "xy" + text.substr(2));
+    ASSERT_STREQ(rows[0].AsString(), text.c_str());
+
+    unsigned char bytes[64] = {0, 1, 0, 2};
+    Any blob(bytes, 64);
+    blob.Share();
+    Any blobCopy = blob;
+    ASSERT_EQ(blobCopy.ValuePtr(), blob.ValuePtr());
+    ASSERT_EQ(blobCopy.ValueSize(), 64);
+    ASSERT_TRUE(blobCopy == blob);
+    std::memset(blobCopy.AllocBlob(64), 7, 64);
+    ASSERT_FALSE(blobCopy.IsShared());
+    ASSERT_FALSE(blobCopy == blob);
+    ASSERT_EQ(blob.ValueSize(), 64);
+    ASSERT_EQ(std::memcmp(blob.ValuePtr(), bytes, 64), 0);
+
+    // reallocating moves between inline and heap storage
+    blobCopy.AllocBlob(Any::InlineCapacity);
+    ASSERT_TRUE(isInline(blobCopy));
+    blobCopy.AllocBlob(Any::InlineCapacity + 1);
+    ASSERT_FALSE(isInline(blobCopy));
+    ASSERT_EQ(blobCopy.ValueSize(), Any::InlineCapacity + 1);
+
+    // short values stay inline
+    Any shortText("abc");
+    ASSERT_FALSE(shortText.Share().IsShared());
+}
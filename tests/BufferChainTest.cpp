@@ -0,0 +1,112 @@
+/**
+ * CPL - Common Portability Library
+ *
+ * Copyright (C) 2024 Merlot.Rain
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <cpl_ports.h>
+#include <cstdio>
+#include <gtest/gtest.h>
+
+using namespace CPL;
+
+TEST(BufferChain, PrependAppend)
+{
+    BufferChain chain(64, 16);
+    chain.Append(std::string("payload"));
+    chain.Prepend(reinterpret_cast<const unsigned char *>("hdr:"), 4);
+    ASSERT_EQ(chain.SegmentCount(), 1);
+    ASSERT_EQ(chain.ToString(), "hdr:payload");
+
+    // Exceeding the headroom links a new segment instead of moving data.
+    std::string big(32, 'x');
+    chain.Prepend(reinterpret_cast<const unsigned char *>(big.data()), 32);
+    ASSERT_EQ(chain.SegmentCount(), 2);
+    ASSERT_EQ(chain.ToString(), big + "hdr:payload");
+}
+
+TEST(BufferChain, SplitAndCoalesce)
+{
+    BufferChain chain;
+    chain.Append(std::string("0123456789"));
+    BufferChain tail;
+    tail.Append(std::string("abcdef"));
+    chain.Append(std::move(tail));
+    ASSERT_TRUE(tail.IsEmpty());
+    ASSERT_EQ(chain.Length(), 16);
+
+    BufferChain head = chain.Split(12);
+    ASSERT_EQ(head.ToString(), "0123456789ab");
+    ASSERT_EQ(chain.ToString(), "cdef");
+
+    // The shared block must not be written through the remaining chain.
+    chain.Prepend(reinterpret_cast<const unsigned char *>("--"), 2);
+    ASSERT_EQ(head.ToString(), "0123456789ab");
+    ASSERT_EQ(chain.ToString(), "--cdef");
+
+    ASSERT_TRUE(head.IsChained());
+    const unsigned char *p = head.Coalesce();
+    ASSERT_FALSE(head.IsChained());
+    ASSERT_EQ(std::string(reinterpret_cast<const char *>(p), 12),
+              "0123456789ab");
+}
+
+TEST(BufferChain, WriteTo)
+{
+    BufferChain chain;
+    chain.Append(std::string("world"));
+    chain.Prepend(reinterpret_cast<const unsigned char *>("hello "), 6);
+    std::string out;
+    MemoryOutputStream stream(out);
+    ASSERT_EQ(chain.WriteTo(&stream), 11);
+    ASSERT_EQ(out, "hello world");
+}
+
+TEST(BufferChain, WriteToFile)
+{
+    // More segments than one gathered write takes, behind buffered bytes.
+    BufferChain chain;
+    std::string expected;
+    for (int i = 0; i < 100; ++i)
+    {
+        BufferChain piece(16);
+        piece.Append(std::to_string(i) + ";");
+        expected += std::to_string(i) + ";";
+        chain.Append(std::move(piece));
+    }
+    ASSERT_EQ(chain.SegmentCount(), 100);
+
+    const char *path = "bufferchain_writev.bin";
+    {
+        FileOutputStream stream(path);
+        ASSERT_EQ(stream.RawWrite(reinterpret_cast<const unsigned char *>("<"),
+                                  1),
+                  1);
+        ASSERT_EQ(chain.WriteTo(&stream),
+                  static_cast<long long>(expected.size()));
+    }
+
+    std::string actual;
+    FILE *f = std::fopen(path, "rb");
+    ASSERT_NE(f, nullptr);
+    char buf[256];
+    size_t n;
+    while ((n = std::fread(buf, 1, sizeof(buf), f)) > 0) actual.append(buf, n);
+    std::fclose(f);
+    std::remove(path);
+    ASSERT_EQ(actual, "<" + expected);
+}
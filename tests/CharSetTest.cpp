@@ -0,0 +1,68 @@
+/**
+ * CPL - Common Portability Library
+ *
+ * Copyright (C) 2024 Merlot.Rain
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <cpl_ports.h>
+#include <gtest/gtest.h>
+
+using namespace CPL;
+
+TEST(CharSet, Find)
+{
+    static constexpr CharSet kDelimiters(",;\t\r\n");
+    static_assert(kDelimiters.Contains(';') && !kDelimiters.Contains('a'));
+
+    ASSERT_EQ(kDelimiters.FindFirstOf("abc;def"), 3u);
+    ASSERT_EQ(kDelimiters.FindFirstOf("abc;def", 4), std::string_view::npos);
+    ASSERT_EQ(kDelimiters.FindFirstNotOf(",;\t x"), 3u);
+    ASSERT_EQ(CharSet().FindFirstOf("abc"), std::string_view::npos);
+
+    ASSERT_TRUE(StringHelp::HasContain("hello", 'l'));
+    ASSERT_FALSE(StringHelp::HasContain("hello", 'z'));
+    ASSERT_TRUE(StringHelp::HasContainAny("hello world", "xyz "));
+    ASSERT_FALSE(StringHelp::HasContainAny("hello", "xyz"));
+
+    // every byte value against the scalar table, at every offset of a vector block
+    unsigned int seed = 11;
+    auto next = [&seed] { return seed = seed * 1103515245u + 12345u, seed >> 16; };
+    for (int round = 0; round < 64; ++round)
+    {
+        CharSet set;
+        for (int i = 0; i < round % 40; ++i) set.Add(static_cast<char>(next()));
+        if (round % 8 == 7) set = set | CharSet::Range(0x80, 0xFF);
+        const CharSet inverse = ~set;
+
+        std::string text(100, '\0');
+        for (char &c: text) c = static_cast<char>(next());
+        for (size_t nPos = 0; nPos <= text.size(); ++nPos)
+        {
+            size_t nOf = std::string_view::npos, nNotOf = std::string_view::npos;
+            for (size_t i = text.size(); i-- > nPos;)
+            {
+                if (set.Contains(text[i])) nOf = i;
+                else
+                    nNotOf = i;
+                ASSERT_NE(set.Contains(text[i]), inverse.Contains(text[i]));
+            }
+            ASSERT_EQ(set.FindFirstOf(text, nPos), nOf);
+            ASSERT_EQ(set.FindFirstNotOf(text, nPos), nNotOf);
+            ASSERT_EQ(inverse.FindFirstNotOf(text, nPos), nOf);
+        }
+    }
+}
@@ -0,0 +1,141 @@
+/**
+ * CPL - Common Portability Library
+ *
+ * Copyright (C) 2024 Merlot.Rain
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <cpl_ports.h>
+#include <gtest/gtest.h>
+
+using namespace CPL;
+
+static std::vector<unsigned char> codecBytes(size_t nLen)
+{
+    std::vector<unsigned char> bytes(nLen);
+    unsigned int seed = 12345;
+    for (auto &b: bytes)
+    {
+        seed = seed * 1103515245 + 12345;
+        b = static_cast<unsigned char>(seed >> 16);
+    }
+    return bytes;
+}
+
+TEST(Codec, Hex)
+{
+    const unsigned char bytes[] = {0x00, 0x1F, 0xA5, 0xFF};
+    ASSERT_EQ(Hex::Encode(bytes, 4), "001fa5ff");
+    ASSERT_EQ(Hex::Encode(bytes, 4, true), "001FA5FF");
+    ASSERT_EQ(StringHelp::FromHexString("414243"), "ABC");
+    ASSERT_EQ(StringHelp::ToHexString("AB"), "4142");
+
+    for (size_t nLen: {0, 15, 16, 31, 33, 100, 257})
+    {
+        std::vector<unsigned char> data = codecBytes(nLen);
+        std::string text = Hex::Encode(data.data(), nLen, nLen % 2 == 1);
+        std::vector<unsigned char> back(nLen);
+        ASSERT_TRUE(Hex::Decode(text.data(), text.size(), back.data()));
+        ASSERT_EQ(back, data);
+    }
+
+    std::string bad(80, 'a');
+    bad[45] = 'g';
+    std::vector<unsigned char> out(40);
+    ASSERT_FALSE(Hex::Decode(bad.data(), bad.size(), out.data()));
+    ASSERT_FALSE(Hex::Decode("abc", 3, out.data()));
+}
+
+TEST(Codec, Base64)
+{
+    const char *plain[] = {"", "f", "fo", "foo", "foob", "fooba", "foobar"};
+    const char *coded[] = {"", "Zg==", "Zm8=", "Zm9v", "Zm9vYg==", "Zm9vYmE=",
+                           "Zm9vYmFy"};
+    for (int i = 0; i < 7; ++i)
+    {
+        const unsigned char *p = reinterpret_cast<const unsigned char *>(plain[i]);
+        ASSERT_EQ(Base64::Encode(p, strlen(plain[i])), coded[i]);
+        GrowByteBuffer buffer;
+        ASSERT_TRUE(Base64::Decode(coded[i], &buffer));
+        ASSERT_EQ(std::string(buffer.PtrT<char>(), buffer.RealSize()), plain[i]);
+    }
+
+    const unsigned char url[] = {0xFB, 0xFF, 0xBF};
+    ASSERT_EQ(Base64::Encode(url, 3), "+/+/");
+    ASSERT_EQ(Base64::Encode(url, 3, Base64Alphabet::eUrlSafe), "-_-_");
+    ASSERT_EQ(Base64::Encode(url, 2, Base64Alphabet::eUrlSafe, false), "-_8");
+    ASSERT_EQ(Base64::DecodedLength("-_8", 3), 2u);
+    ASSERT_FALSE(Base64::IsValid("-_-_"));
+    ASSERT_TRUE(Base64::IsValid("-_-_", Base64Alphabet::eUrlSafe));
+    ASSERT_FALSE(Base64::IsValid("Zg=a"));
+    ASSERT_TRUE(StringHelp::IsBase64String("Zm9vYg=="));
+
+    for (auto alphabet: {Base64Alphabet::eStandard, Base64Alphabet::eUrlSafe})
+    {
+        for (size_t nLen: {11, 12, 16, 47, 48, 49, 200, 1000})
+        {
+            std::vector<unsigned char> data = codecBytes(nLen);
+            std::string text = Base64::Encode(data.data(), nLen, alphabet);
+            std::vector<unsigned char> back(nLen);
+            ASSERT_EQ(Base64::DecodedLength(text.data(), text.size()), nLen);
+            ASSERT_TRUE(Base64::Decode(text.data(), text.size(), back.data(),
+                                       alphabet));
+            ASSERT_EQ(back, data);
+
+            text[text.size() / 3] = '*';
+            ASSERT_FALSE(Base64::Decode(text.data(), text.size(), back.data(),
+                                        alphabet));
+        }
+    }
+}
+
+TEST(Codec, Streams)
+{
+    std::vector<unsigned char> data = codecBytes(10000);
+    std::string text;
+    {
+        EncodingOutputStreamPtr encoder =
+                new EncodingOutputStream(new MemoryOutputStream(text),
+                                         TextCodec::eBase64);
+        for (size_t i = 0; i < data.size(); i += 7)
+            encoder->RawWrite(data.data() + i,
+                              static_cast<int>(std::min<size_t>(7, data.size() - i)));
+        ASSERT_EQ(encoder->Offset(), data.size());
+        ASSERT_TRUE(encoder->Close());
+    }
+    ASSERT_EQ(text, Base64::Encode(data.data(), data.size()));
+
+    // Wrap the text into 76-column lines like MIME does.
+    std::string wrapped;
+    for (size_t i = 0; i < text.size(); i += 76)
+        wrapped += text.substr(i, 76) + "\r\n";
+
+    DecodingInputStreamPtr decoder = new DecodingInputStream(
+            new MemoryInputStream(wrapped, false), TextCodec::eBase64);
+    std::vector<unsigned char> back(data.size() + 10);
+    ASSERT_EQ(decoder->RawRead(back.data(), static_cast<int>(back.size())),
+              static_cast<int>(data.size()));
+    back.resize(data.size());
+    ASSERT_EQ(back, data);
+    ASSERT_FALSE(decoder->HasError());
+    ASSERT_TRUE(decoder->Eof());
+
+    DecodingInputStreamPtr bad = new DecodingInputStream(
+            new MemoryInputStream(std::string("41x2"), true), TextCodec::eHex);
+    unsigned char byte[2];
+    ASSERT_EQ(bad->RawRead(byte, 2), 0);
+    ASSERT_TRUE(bad->HasError());
+}
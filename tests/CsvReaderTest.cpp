@@ -0,0 +1,86 @@
+/**
+ * CPL - Common Portability Library
+ *
+ * Copyright (C) 2024 Merlot.Rain
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <cpl_ports.h>
+#include <gtest/gtest.h>
+
+using namespace CPL;
+
+static std::vector<std::vector<std::string>> readAll(CsvReader &reader)
+{
+    std::vector<std::vector<std::string>> records;
+    std::vector<std::string_view> fields;
+    while (reader.Next(fields))
+        records.emplace_back(fields.begin(), fields.end());
+    return records;
+}
+
+TEST(CsvReader, Fields)
+{
+    std::string text = "id,name,note\r\n"
+                       "1,plain,\"with, comma\"\n"
+                       "2,\"say \"\"hi\"\"\",\"two\nlines\"\n"
+                       "3,,\n"
+                       "4,last";
+    CsvReader reader(text);
+    auto records = readAll(reader);
+    ASSERT_EQ(records.size(), 5u);
+    ASSERT_EQ(records[0], (std::vector<std::string>{"id", "name", "note"}));
+    ASSERT_EQ(records[1], (std::vector<std::string>{"1", "plain", "with, comma"}));
+    ASSERT_EQ(records[2], (std::vector<std::string>{"2", "say \"hi\"", "two\nlines"}));
+    ASSERT_EQ(records[3], (std::vector<std::string>{"3", "", ""}));
+    ASSERT_EQ(records[4], (std::vector<std::string>{"4", "last"}));
+    ASSERT_EQ(reader.RecordCount(), 5u);
+    ASSERT_FALSE(reader.HasError());
+
+    CsvReader open("a,\"never closed\n");
+    readAll(open);
+    ASSERT_TRUE(open.HasError());
+}
+
+TEST(CsvReader, StreamAndChunks)
+{
+    // records longer than a block, quotes spanning blocks and a stream buffer refill
+    std::string text;
+    for (int i = 0; i < 5000; ++i)
+    {
+        text += std::to_string(i) + ";\"" + std::string(i % 150, 'x') + ";\n\"\"\";" +
+                std::string(i % 7, 'y') + "\n";
+    }
+
+    CsvReader memory(text, ';');
+    auto expected = readAll(memory);
+    ASSERT_EQ(expected.size(), 5000u);
+    ASSERT_EQ(expected[151][1], std::string(1, 'x') + ";\n\"");
+
+    CsvReader stream(new MemoryInputStream(text, false), ';');
+    ASSERT_EQ(readAll(stream), expected);
+
+    std::vector<std::string_view> chunks = CsvReader::SplitChunks(text, 7);
+    ASSERT_EQ(chunks.size(), 7u);
+    std::vector<std::vector<std::string>> joined;
+    for (std::string_view chunk: chunks)
+    {
+        CsvReader part(chunk, ';');
+        auto records = readAll(part);
+        joined.insert(joined.end(), records.begin(), records.end());
+    }
+    ASSERT_EQ(joined, expected);
+}
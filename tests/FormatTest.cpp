@@ -0,0 +1,67 @@
+/**
+ * CPL - Common Portability Library
+ *
+ * Copyright (C) 2024 Merlot.Rain
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <cpl_ports.h>
+#include <gtest/gtest.h>
+
+using namespace CPL;
+
+TEST(Format, Types)
+{
+    ASSERT_EQ(Format("{} {:.2f} {}", 42, 1.5, "x"), "42 1.50 x");
+    ASSERT_EQ(Format("{}", DateTime(2024, 1, 31, 8, 30, 5)),
+              "2024-01-31T08:30:05");
+    ASSERT_EQ(Format("{}", DateTime(2024, 1, 31, 8, 30, 5, 12, 3)),
+              "2024-01-31T08:30:05.012003");
+    ASSERT_EQ(Format("{:>21}", DateTime(2024, 1, 31)), "  2024-01-31T00:00:00");
+    ASSERT_EQ(Format("{}", TimeSpan(1, 2, 3, 4, 500)), "1.02:03:04.000500");
+    ASSERT_EQ(Format("{}", TimeSpan(0, 0, 0, -90, 0)), "-00:01:30");
+
+    Guid guid;
+    for (int i = 0; i < 16; ++i) guid.Data[i] = static_cast<unsigned char>(i * 17);
+    ASSERT_EQ(Format("{}", guid), guid.ToString());
+    ASSERT_EQ(Format("{:B}", guid), guid.ToString(Guid::Format::eHyphensBraces));
+
+    ASSERT_EQ(Format("[{:<4}]", Any(7)), "[7   ]");
+}
+
+TEST(Format, Sinks)
+{
+    std::string str = "a";
+    FormatTo(str, "{}-{}", 1, 2);
+    ASSERT_EQ(str, "a1-2");
+
+    GrowByteBuffer buffer;
+    ASSERT_EQ(FormatTo(buffer, "{:04x}", 255), 4u);
+    ASSERT_EQ(std::string(buffer.PtrT<char>(), buffer.RealSize()),
+              "00ff");
+
+    std::string out;
+    OutputStreamPtr stream = new MemoryOutputStream(out);
+    ASSERT_EQ(FormatTo(stream.p, "{}", "stream"), 6);
+    stream->Flush();
+    ASSERT_EQ(out, "stream");
+
+    char fixed[4];
+    ASSERT_EQ(FormatTo(fixed, sizeof(fixed), "{}", 123456), 6u);
+    ASSERT_EQ(std::string(fixed, 4), "1234");
+
+    ASSERT_EQ(StringHelp::Format(2, "%d-%s", 12345, "abc"), "12345-abc");
+}
@@ -0,0 +1,73 @@
+/**
+ * CPL - Common Portability Library
+ *
+ * Copyright (C) 2024 Merlot.Rain
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <cpl_ports.h>
+#include <gtest/gtest.h>
+#include <unordered_set>
+
+using namespace CPL;
+
+TEST(Hash, Bytes)
+{
+    // every length up to the 48-byte loop and beyond, with single-bit changes
+    std::string data(200, '\0');
+    for (size_t i = 0; i < data.size(); ++i) data[i] = static_cast<char>(i * 7);
+    std::unordered_set<unsigned long long> seen;
+    for (size_t nLen = 0; nLen <= data.size(); ++nLen)
+    {
+        std::string_view view(data.data(), nLen);
+        ASSERT_TRUE(seen.insert(Hash::String(view)).second);
+        ASSERT_NE(Hash::String(view), Hash::String(view, 1));
+        for (size_t i = 0; i < nLen; i += 13)
+        {
+            std::string flipped(view);
+            flipped[i] ^= 1;
+            ASSERT_NE(Hash::String(flipped), Hash::String(view));
+        }
+    }
+    ASSERT_NE(Hash::String("listen"), Hash::String("silent"));
+    ASSERT_EQ(Hash::Randomized("abc", 3), Hash::Bytes("abc", 3, Hash::ProcessSeed()));
+    static_assert(Hash::Mix(1) != Hash::Mix(2));
+    ASSERT_NE(Hash::Combine(1, 2), Hash::Combine(2, 1));
+}
+
+TEST(Hash, Any)
+{
+    ASSERT_NE(Any("ab").HashCode(), Any("ba").HashCode());
+    ASSERT_EQ(Any("abc").HashCode(), Any(std::string("abc")).HashCode());
+    ASSERT_EQ(Any(0.0).HashCode(), Any(-0.0).HashCode());
+    ASSERT_NE(Any(1).HashCode(), Any(1LL).HashCode());
+
+    const unsigned char blobA[] = {1, 0, 2, 0};
+    const unsigned char blobB[] = {1, 0, 3, 0};
+    Any anyA(blobA, 4);
+    Any copyA(anyA);
+    ASSERT_EQ(copyA.ValueSize(), 4);
+    ASSERT_TRUE(copyA == anyA);
+    ASSERT_EQ(copyA.HashCode(), anyA.HashCode());
+    ASSERT_NE(Any(blobB, 4).HashCode(), anyA.HashCode());
+
+    std::unordered_set<Any> values = {Any(1), Any("one"), Any(1.0)};
+    ASSERT_EQ(values.count(Any("one")), 1u);
+
+    Guid guid;
+    Guid other(guid);
+    ASSERT_EQ(std::hash<Guid>()(guid), std::hash<Guid>()(other));
+}
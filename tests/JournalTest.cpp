@@ -0,0 +1,189 @@
+/**
+ * CPL - Common Portability Library
+ *
+ * Copyright (C) 2024 Merlot.Rain
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <climits>
+#include <cpl_ports.h>
+#include <cstdint>
+#include <cstdio>
+#include <gtest/gtest.h>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+#ifdef __linux__
+#include <sys/mman.h>
+#endif
+
+using namespace CPL;
+
+TEST(Journal, Crc32C)
+{
+    ASSERT_EQ(JournalWriter::Crc32C("123456789", 9), 0xE3069283u);
+    unsigned int crc = JournalWriter::Crc32C("1234", 4);
+    ASSERT_EQ(JournalWriter::Crc32C("56789", 5, crc), 0xE3069283u);
+}
+
+TEST(Journal, ConcurrentAppend)
+{
+    const char *path = "journal_concurrent.log";
+    std::remove(path);
+    {
+        JournalOptions options;
+        options.Durable = false;
+        JournalWriter writer(path, options);
+        std::vector<std::thread> threads;
+        for (int t = 0; t < 4; ++t)
+        {
+            threads.emplace_back([&writer, t] {
+                for (int i = 0; i < 100; ++i)
+                    writer.Append(std::to_string(t * 1000 + i));
+            });
+        }
+        for (auto &th: threads) th.join();
+        JournalStats stats = writer.Stats();
+        ASSERT_EQ(stats.Records, 400u);
+        ASSERT_LE(stats.Batches, 400u);
+    }
+
+    JournalReader reader(path);
+    std::string record;
+    int count = 0;
+    while (reader.Next(record)) ++count;
+    ASSERT_EQ(count, 400);
+    ASSERT_FALSE(reader.TornTail());
+    std::remove(path);
+}
+
+TEST(Journal, TornTail)
+{
+    const char *path = "journal_torn.log";
+    std::remove(path);
+    {
+        JournalWriter writer(path);
+        writer.Append(std::string("first"));
+        writer.Append(std::string("second"));
+    }
+    // Simulate a crash in the middle of a record.
+    FILE *f = std::fopen(path, "ab");
+    std::fwrite("\x10\x00\x00\x00\x01\x02", 1, 6, f);
+    std::fclose(f);
+
+    {
+        JournalWriter writer(path);
+        writer.Append(std::string("third"));
+    }
+    JournalReader reader(path);
+    std::string record;
+    std::vector<std::string> records;
+    while (reader.Next(record)) records.push_back(record);
+    ASSERT_FALSE(reader.TornTail());
+    ASSERT_EQ(records, (std::vector<std::string>{"first", "second", "third"}));
+    std::remove(path);
+}
+
+TEST(Journal, MaxRecordSize)
+{
+    const char *path = "journal_limit.log";
+    std::remove(path);
+    JournalOptions options;
+    options.Durable = false;
+    options.MaxRecordSize = 16;
+    const std::string largest(16, 'x');
+    {
+        JournalWriter writer(path, options);
+        writer.Append(largest);
+        ASSERT_THROW(writer.Append(std::string(17, 'y')), std::length_error);
+        writer.Append(std::string("after"));
+    }
+
+    // Recovery must keep records of exactly the limit.
+    {
+        JournalWriter writer(path, options);
+        writer.Append(std::string("reopened"));
+    }
+    JournalReader reader(path, options.MaxRecordSize);
+    std::string record;
+    std::vector<std::string> records;
+    while (reader.Next(record)) records.push_back(record);
+    ASSERT_FALSE(reader.TornTail());
+    ASSERT_EQ(records,
+              (std::vector<std::string>{largest, "after", "reopened"}));
+    std::remove(path);
+
+    options.MaxRecordSize = static_cast<unsigned int>(INT_MAX) + 1;
+    ASSERT_THROW(JournalWriter(path, options), std::invalid_argument);
+    ASSERT_THROW(JournalReader(path, options.MaxRecordSize),
+                 std::invalid_argument);
+    std::remove(path);
+}
+
+#if defined(__linux__) && SIZE_MAX > UINT_MAX
+/// Counts the bytes written without storing them
+class CountingOutputStream : public OutputStream
+{
+public:
+    unsigned long long Bytes = 0;
+    int Calls = 0;
+    bool BadLength = false;
+
+    int RawWrite(const unsigned char *, int nLen) override
+    {
+        if (nLen <= 0) BadLength = true;
+        if (nLen <= 0) return 0;
+        Bytes += nLen;
+        ++Calls;
+        return nLen;
+    }
+
+    unsigned long long Offset() const override { return Bytes; }
+};
+
+TEST(Journal, BatchLargerThanInt)
+{
+    // Untouched anonymous pages read as zeros without using memory.
+    const unsigned int nLen = 1u << 30;
+    void *pZero = mmap(nullptr, nLen, PROT_READ, MAP_PRIVATE | MAP_ANONYMOUS,
+                       -1, 0);
+    ASSERT_NE(pZero, MAP_FAILED);
+
+    CountingOutputStream stream;
+    JournalOptions options;
+    options.Durable = false;
+    options.MaxBatchDelay = 60 * 1000 * 1000;
+    options.MaxBatchBytes = 2 * (nLen + 8);
+    {
+        // Both records join one batch of more than INT_MAX bytes.
+        JournalWriter writer(&stream, options);
+        auto append = [&writer, pZero, nLen] {
+            writer.Append(static_cast<const unsigned char *>(pZero), nLen);
+        };
+        std::thread first(append), second(append);
+        first.join();
+        second.join();
+        JournalStats stats = writer.Stats();
+        ASSERT_EQ(stats.Records, 2u);
+        ASSERT_EQ(stats.Batches, 1u);
+        ASSERT_EQ(stats.Bytes, 2ULL * (nLen + 8));
+    }
+    munmap(pZero, nLen);
+    ASSERT_FALSE(stream.BadLength);
+    ASSERT_EQ(stream.Bytes, 2ULL * (nLen + 8));
+    ASSERT_GE(stream.Calls, 2);
+}
+#endif
@@ -0,0 +1,64 @@
+/**
+ * CPL - Common Portability Library
+ *
+ * Copyright (C) 2024 Merlot.Rain
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <cpl_ports.h>
+#include <gtest/gtest.h>
+#include <stdexcept>
+
+using namespace CPL;
+
+TEST(LargeByteBuffer, Threshold)
+{
+#ifdef __linux__
+    unsigned long long nHuge = LargeByteBuffer::HugePageAllocations();
+#endif
+    unsigned long long nRegular = LargeByteBuffer::RegularAllocations();
+
+    LargeByteBuffer small(1024);
+    ASSERT_FALSE(small.IsHugePageBacked());
+    ASSERT_EQ(LargeByteBuffer::RegularAllocations(), nRegular + 1);
+
+    LargeByteBuffer large(4 * 1024 * 1024 + 1);
+#ifdef __linux__
+    ASSERT_TRUE(large.IsHugePageBacked());
+    ASSERT_EQ(LargeByteBuffer::HugePageAllocations(), nHuge + 1);
+    ASSERT_EQ(reinterpret_cast<uintptr_t>(large.Ptr()) %
+                      LargeByteBuffer::HugePageSize,
+              0u);
+    ASSERT_EQ(large.BufferSize(), 6u * 1024 * 1024);
+#endif
+}
+
+TEST(LargeByteBuffer, Grow)
+{
+    LargeByteBuffer buffer;
+    std::string chunk(1 << 20, 'x');
+    for (int i = 0; i < 4; ++i) buffer.Append(chunk);
+    buffer.Insert(0, reinterpret_cast<const unsigned char *>("ab"), 2);
+    ASSERT_EQ(buffer.RealSize(), 4u * (1 << 20) + 2);
+    ASSERT_EQ(buffer.Ptr()[0], 'a');
+    ASSERT_EQ(buffer.Ptr()[buffer.RealSize() - 1], 'x');
+    ASSERT_THROW(buffer.Append(buffer.Ptr(), -1), std::length_error);
+    ASSERT_EQ(buffer.RealSize(), 4u * (1 << 20) + 2);
+
+    LargeByteBuffer moved(std::move(buffer));
+    ASSERT_EQ(buffer.Ptr(), nullptr);
+    ASSERT_EQ(moved.RealSize(), 4u * (1 << 20) + 2);
+}
@@ -0,0 +1,66 @@
+/**
+ * CPL - Common Portability Library
+ *
+ * Copyright (C) 2024 Merlot.Rain
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <cpl_ports.h>
+#include <gtest/gtest.h>
+
+using namespace CPL;
+
+TEST(LikePattern, Classify)
+{
+    ASSERT_EQ(LikePattern("abc").Kind(), LikePattern::LikeKind::eExact);
+    ASSERT_EQ(LikePattern("abc%").Kind(), LikePattern::LikeKind::ePrefix);
+    ASSERT_EQ(LikePattern("%abc").Kind(), LikePattern::LikeKind::eSuffix);
+    ASSERT_EQ(LikePattern("%%abc%").Kind(), LikePattern::LikeKind::eContains);
+    ASSERT_EQ(LikePattern("%").Kind(), LikePattern::LikeKind::eContains);
+    ASSERT_EQ(LikePattern("a_c").Kind(), LikePattern::LikeKind::eGeneral);
+    ASSERT_EQ(LikePattern("100!%%", '!').Kind(), LikePattern::LikeKind::ePrefix);
+}
+
+TEST(LikePattern, Match)
+{
+    ASSERT_TRUE(StringHelp::IsLike("a%c", "abbbc", 0));
+    ASSERT_FALSE(StringHelp::IsLike("a%c", "abbbcd", 0));
+    ASSERT_TRUE(StringHelp::IsLike("%b_b%", "aabxbaa", 0));
+    ASSERT_TRUE(StringHelp::IsLike("a%b%a", "aba", 0));
+    ASSERT_FALSE(StringHelp::IsLike("a%a%a", "aa", 0));
+    ASSERT_TRUE(StringHelp::IsLike("_", "x", 0));
+    ASSERT_FALSE(StringHelp::IsLike("_", "", 0));
+    ASSERT_TRUE(StringHelp::IsLike("100!%", "100%", '!'));
+    ASSERT_FALSE(StringHelp::IsLike("100!%", "1000", '!'));
+    ASSERT_TRUE(StringHelp::IsLike("%", "", 0));
+}
+
+TEST(LikePattern, MatchAll)
+{
+    std::vector<std::string> rows;
+    for (int i = 0; i < 100; ++i) rows.push_back("row" + std::to_string(i));
+    std::vector<std::string_view> views(rows.begin(), rows.end());
+
+    unsigned long long bitmap[2];
+    LikePattern pattern("%7%");
+    ASSERT_EQ(pattern.MatchAll(views.data(), views.size(), bitmap), 19u);
+    ASSERT_TRUE(bitmap[0] & (1ULL << 7));
+    ASSERT_TRUE(bitmap[1] & (1ULL << (77 - 64)));
+    ASSERT_FALSE(bitmap[0] & (1ULL << 8));
+
+    LikePattern copy = pattern;
+    ASSERT_TRUE(copy.Match("x7"));
+}
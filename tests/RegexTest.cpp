@@ -0,0 +1,66 @@
+/**
+ * CPL - Common Portability Library
+ *
+ * Copyright (C) 2024 Merlot.Rain
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <cpl_ports.h>
+#include <gtest/gtest.h>
+
+using namespace CPL;
+
+TEST(Regex, MatchAndSearch)
+{
+    Regex re("(\\w+)@(\\w+)\\.com");
+    ASSERT_EQ(re.CaptureCount(), 2u);
+    ASSERT_TRUE(re.Match("user@example.com"));
+    ASSERT_FALSE(re.Match("mail user@example.com"));
+    ASSERT_TRUE(re.Search("mail user@example.com"));
+
+    std::vector<std::string_view> groups;
+    std::string subject = "to: alice@corp.com";
+    ASSERT_TRUE(re.Search(subject, groups));
+    ASSERT_EQ(groups[1], "alice");
+    ASSERT_EQ(groups[2], "corp");
+    ASSERT_EQ(groups[0].data(), subject.data() + 4);
+
+    ASSERT_THROW(Regex("(unclosed"), std::invalid_argument);
+}
+
+TEST(Regex, Iterate)
+{
+    Regex re("\\d*");
+    std::vector<std::string_view> groups;
+    std::vector<std::string> matches;
+    auto it = re.Iterate("a12b3");
+    while (it.Next(groups)) matches.emplace_back(groups[0]);
+    ASSERT_EQ(matches, (std::vector<std::string>{"", "12", "", "3", ""}));
+}
+
+TEST(Regex, WildcardCache)
+{
+    Regex::ClearCache();
+    ASSERT_TRUE(StringHelp::IsMatch("*.TXT", "notes.txt"));
+    ASSERT_FALSE(StringHelp::IsMatch("*.TXT", "notes.txt", false));
+    ASSERT_FALSE(StringHelp::IsMatch("*.txt", ".txt"));
+    ASSERT_TRUE(StringHelp::IsMatch("file?.(1)", "file7.(1)"));
+    ASSERT_EQ(Regex::CacheSize(), 4u);
+
+    Regex::SetCacheCapacity(1);
+    ASSERT_EQ(Regex::CacheSize(), 1u);
+    Regex::SetCacheCapacity(64);
+}
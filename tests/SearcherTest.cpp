@@ -0,0 +1,94 @@
+/**
+ * CPL - Common Portability Library
+ *
+ * Copyright (C) 2024 Merlot.Rain
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <algorithm>
+#include <cpl_ports.h>
+#include <gtest/gtest.h>
+#include <stdexcept>
+
+using namespace CPL;
+
+TEST(Searcher, Find)
+{
+    std::string text(100, 'a');
+    text += "needle";
+    text += std::string(40, 'b');
+    text += "needle";
+
+    Searcher searcher("needle");
+    ASSERT_EQ(searcher.Find(text), 100u);
+    ASSERT_EQ(searcher.Find(text, 101), 146u);
+    ASSERT_EQ(searcher.Find(text, 147), std::string_view::npos);
+    ASSERT_EQ(searcher.Count(text), 2u);
+
+    // Compare with std::string::find around block boundaries.
+    for (size_t len = 2; len < 40; ++len)
+    {
+        std::string pattern = text.substr(95, len);
+        ASSERT_EQ(Searcher(pattern).Find(text), text.find(pattern));
+    }
+}
+
+TEST(Searcher, MultiReplace)
+{
+    MultiReplacer replacer({
+            {    "he",  "1"},
+            {   "she",  "2"},
+            {  "hers",  "3"},
+            {"sherry",  "4"},
+            {     "&", "&amp;"}
+    });
+    ASSERT_EQ(replacer.Replace("ushers & sherr she"), "u2rs &amp; 2rr 2");
+    ASSERT_EQ(replacer.Replace("sherry hers he"), "4 3 1");
+
+    std::string out;
+    ASSERT_EQ(replacer.Replace("nothing", out), 0u);
+    ASSERT_EQ(out, "nothing");
+
+    std::string streamed;
+    OutputStreamPtr stream = new MemoryOutputStream(streamed);
+    ASSERT_EQ(replacer.Replace("he & she", stream.p), 3u);
+    ASSERT_EQ(streamed, "1 &amp; 2");
+
+    // A stream taking a few bytes per call and failing at a fixed size.
+    class ShortWriteStream : public OutputStream
+    {
+    public:
+        std::string Data;
+        size_t Limit = 0;
+
+        int RawWrite(const unsigned char *buff, int nLen) override
+        {
+            int n = static_cast<int>(
+                    std::min<size_t>({size_t(nLen), 3, Limit - Data.size()}));
+            Data.append(reinterpret_cast<const char *>(buff), n);
+            return n;
+        }
+        unsigned long long Offset() const override { return Data.size(); }
+    };
+    ShortWriteStream shortStream;
+    shortStream.Limit = 100;
+    ASSERT_EQ(replacer.Replace("he & she", &shortStream), 3u);
+    ASSERT_EQ(shortStream.Data, "1 &amp; 2");
+    shortStream.Data.clear();
+    shortStream.Limit = 4;
+    ASSERT_THROW(replacer.Replace("he & she", &shortStream),
+                 std::runtime_error);
+}
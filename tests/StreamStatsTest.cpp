@@ -0,0 +1,66 @@
+/**
+ * CPL - Common Portability Library
+ *
+ * Copyright (C) 2024 Merlot.Rain
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <cpl_ports.h>
+#include <gtest/gtest.h>
+
+using namespace CPL;
+
+TEST(StreamStats, Input)
+{
+    std::string data(100, 'a');
+    StatsInputStreamPtr stream =
+            new StatsInputStream(new MemoryInputStream(data, false));
+    unsigned char buff[64];
+    ASSERT_EQ(stream->RawRead(buff, 64), 64);
+    ASSERT_EQ(stream->RawRead(buff, 64), 36);
+
+    InputStreamStats stats = stream->Stats();
+    ASSERT_EQ(stats.Read.Calls, 2u);
+    ASSERT_EQ(stats.Read.Bytes, 100u);
+    ASSERT_EQ(stats.Read.ShortCalls, 1u);
+    unsigned long long nBucketed = 0;
+    for (unsigned long long n: stats.Read.Histogram) nBucketed += n;
+    ASSERT_EQ(nBucketed, 2u);
+
+    stream->SetEnabled(false);
+    stream->Seek(0, StreamSeekOrigin::eSet);
+    ASSERT_EQ(stream->RawRead(buff, 10), 10);
+    ASSERT_EQ(stream->Stats().Read.Calls, 2u);
+}
+
+TEST(StreamStats, Output)
+{
+    std::string out;
+    StatsOutputStreamPtr stream =
+            new StatsOutputStream(new MemoryOutputStream(out));
+    stream->WriteString("hello");
+    IoVec vec[2] = {{reinterpret_cast<const unsigned char *>(" "), 1},
+                    {reinterpret_cast<const unsigned char *>("world"), 5}};
+    ASSERT_EQ(stream->RawWriteV(vec, 2), 6);
+    stream->Flush();
+    ASSERT_EQ(out, "hello world");
+
+    OutputStreamStats stats = stream->Stats();
+    ASSERT_EQ(stats.Write.Calls, 2u);
+    ASSERT_EQ(stats.Write.Bytes, 11u);
+    ASSERT_EQ(stats.Flush.Calls, 1u);
+    ASSERT_LE(stats.Write.Percentile(0.5), stats.Write.MaxNanos);
+}
@@ -0,0 +1,73 @@
+/**
+ * CPL - Common Portability Library
+ *
+ * Copyright (C) 2024 Merlot.Rain
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <cpl_ports.h>
+#include <gtest/gtest.h>
+#include <thread>
+
+using namespace CPL;
+
+TEST(StringPool, Intern)
+{
+    StringPool pool;
+    StringHandle a = pool.Intern("field_name");
+    StringHandle b = pool.Intern(std::string("field_") + "name");
+    StringHandle c = pool.Intern("");
+    ASSERT_FALSE(a.IsNull());
+    ASSERT_EQ(a, b);
+    ASSERT_NE(a, c);
+    ASSERT_EQ(pool.Resolve(a), "field_name");
+    ASSERT_EQ(pool.Resolve(c), "");
+    ASSERT_STREQ(pool.CStr(a), "field_name");
+    ASSERT_EQ(pool.Resolve(StringHandle()), "");
+    ASSERT_EQ(pool.Find("field_name"), a);
+    ASSERT_TRUE(pool.Find("missing").IsNull());
+
+    std::string big(100000, 'x');
+    ASSERT_EQ(pool.Resolve(pool.Intern(big)), big);
+
+    StringPoolStats stats = pool.Stats();
+    ASSERT_EQ(stats.Strings, 3u);
+    ASSERT_EQ(pool.Count(), 3u);
+    ASSERT_EQ(stats.Interns, 4u);
+    ASSERT_EQ(stats.Hits, 1u);
+    ASSERT_EQ(stats.SavedBytes, 10u);
+    ASSERT_EQ(stats.StringBytes, 10u + big.size());
+}
+
+TEST(StringPool, Concurrent)
+{
+    StringPool pool;
+    std::vector<std::vector<StringHandle>> handles(4);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t)
+    {
+        threads.emplace_back([&pool, &handles, t] {
+            for (int i = 0; i < 20000; ++i)
+                handles[t].push_back(pool.Intern("value" + std::to_string(i)));
+        });
+    }
+    for (auto &thread: threads) thread.join();
+
+    ASSERT_EQ(pool.Count(), 20000u);
+    for (int t = 1; t < 4; ++t) ASSERT_EQ(handles[t], handles[0]);
+    for (int i = 0; i < 20000; i += 997)
+        ASSERT_EQ(pool.Resolve(handles[0][i]), "value" + std::to_string(i));
+}
@@ -41,4 +41,284 @@ TEST(String, Split)
     std::string str3 = "";
     auto string_list3 = StringHelp::Split(str3.c_str(), ',');
     ASSERT_EQ(string_list3.size(), 0);
-}
\ No newline at end of file
+}
+
+TEST(String, StringView)
+{
+    std::string_view line = "  Key=Value;Other  ";
+    std::string_view trimmed = StringHelp::Trim(line);
+    ASSERT_EQ(trimmed, "Key=Value;Other");
+    ASSERT_EQ(trimmed.data(), line.data() + 2);
+
+    std::vector<std::string_view> parts;
+    StringHelp::Split(trimmed, ';', parts);
+    ASSERT_EQ(parts.size(), 2);
+    ASSERT_TRUE(StringHelp::StartWith(parts[0], "key=", true));
+    ASSERT_FALSE(StringHelp::StartWith(parts[0], "key=", false));
+    ASSERT_TRUE(StringHelp::EndWith(parts[0], "=Value", false));
+    ASSERT_TRUE(StringHelp::IsEqual(parts[1], "OTHER"));
+    ASSERT_LT(StringHelp::Compare(std::string_view("abc"), "abd"), 0);
+
+    std::string out;
+    StringHelp::Replace(trimmed, "=", " := ", out);
+    ASSERT_EQ(out, "Key := Value;Other");
+    ASSERT_EQ(StringHelp::ToUpper(parts[1]), "OTHER");
+}
+
+TEST(String, TryParse)
+{
+    long long n = 0;
+    ASSERT_TRUE(StringHelp::TryParse(std::string_view("123456;", 6), n));
+    ASSERT_EQ(n, 123456);
+    ASSERT_TRUE(StringHelp::TryParse(" +42 ", n));
+    ASSERT_EQ(n, 42);
+    ASSERT_FALSE(StringHelp::TryParse("12x", n));
+
+    int i = 0;
+    ASSERT_FALSE(StringHelp::TryParse("99999999999", i));
+
+    double d = 0;
+    ASSERT_TRUE(StringHelp::TryParse("-1.5e3", d));
+    ASSERT_DOUBLE_EQ(d, -1500.0);
+
+    bool b = false;
+    ASSERT_TRUE(StringHelp::TryParse("Yes", b));
+    ASSERT_TRUE(b);
+    ASSERT_EQ(StringHelp::ParseInteger("bad", -1), -1);
+}
+
+TEST(String, AppendTo)
+{
+    std::string str = "v=";
+    StringHelp::AppendTo(str, -42);
+    StringHelp::AppendTo(str, ',');
+    str += ';';
+    StringHelp::AppendTo(str, 18446744073709551615ULL);
+    ASSERT_EQ(str, "v=-42,;18446744073709551615");
+    char chr[1];
+    ASSERT_EQ(StringHelp::AppendTo(chr, sizeof(chr), 'x'), 1u);
+    ASSERT_EQ(chr[0], 'x');
+
+    ASSERT_EQ(StringHelp::ToString(1234567.891, -1, 0, ','), "1,234,567.891");
+    ASSERT_EQ(StringHelp::ToString(-1234.5, -1, 0, '.', ','), "-1.234,5");
+    ASSERT_EQ(StringHelp::ToString(9.999, 2), "10.00");
+    ASSERT_EQ(StringHelp::ToString(1.5, 3, 8), "   1.500");
+    ASSERT_EQ(StringHelp::ToString(0.1), "0.1");
+
+    char buf[8];
+    ASSERT_EQ(StringHelp::AppendTo(buf, sizeof(buf), 2.25), 4u);
+    ASSERT_EQ(std::string(buf, 4), "2.25");
+    ASSERT_EQ(StringHelp::AppendTo(buf, sizeof(buf), 1234567890), 0u);
+
+    GrowByteBuffer buffer;
+    StringHelp::AppendTo(buffer, 7LL);
+    StringHelp::AppendTo(buffer, 0.5f);
+    ASSERT_EQ(std::string(buffer.PtrT<char>(), buffer.RealSize()), "70.5");
+
+    std::string sized;
+    StringHelp::AppendTo(sized, std::numeric_limits<size_t>::max());
+    ASSERT_EQ(sized, std::to_string(std::numeric_limits<size_t>::max()));
+    sized.clear();
+    StringHelp::AppendTo(sized, std::numeric_limits<int64_t>::min());
+    StringHelp::AppendTo(sized, ',');
+    StringHelp::AppendTo(sized, -5L);
+    ASSERT_EQ(sized, "-9223372036854775808,-5");
+    ASSERT_EQ(StringHelp::AppendTo(buf, sizeof(buf), size_t(1234567)), 7u);
+    ASSERT_EQ(std::string(buf, 7), "1234567");
+    StringHelp::AppendTo(buffer, int64_t(-3));
+    StringHelp::AppendTo(buffer, 9UL);
+    ASSERT_EQ(std::string(buffer.PtrT<char>(), buffer.RealSize()), "70.5-39");
+}
+
+TEST(String, ParseColumn)
+{
+    long long n = 0;
+    ASSERT_TRUE(StringHelp::TryParse("-9223372036854775808", n));
+    ASSERT_EQ(n, std::numeric_limits<long long>::min());
+    ASSERT_FALSE(StringHelp::TryParse("9223372036854775808", n));
+    ASSERT_TRUE(StringHelp::TryParse("000000000000000000000012", n));
+    ASSERT_EQ(n, 12);
+
+    double d = 0;
+    ASSERT_TRUE(StringHelp::TryParse("1234.5678", d));
+    ASSERT_EQ(d, 1234.5678);
+    ASSERT_TRUE(StringHelp::TryParse("1.7976931348623157e308", d));
+    ASSERT_EQ(d, std::numeric_limits<double>::max());
+    ASSERT_FALSE(StringHelp::TryParse("1e", d));
+    ASSERT_TRUE(StringHelp::IsIntString(" -12 "));
+    ASSERT_FALSE(StringHelp::IsIntString("1.5"));
+    ASSERT_TRUE(StringHelp::IsFloatString("1.5"));
+    ASSERT_TRUE(StringHelp::IsFloatString("2e3"));
+    ASSERT_FALSE(StringHelp::IsFloatString("15"));
+    ASSERT_TRUE(StringHelp::IsNumberString("15"));
+    ASSERT_FALSE(StringHelp::IsNumberString("nan"));
+    ASSERT_FALSE(StringHelp::IsNumberString("inf"));
+
+    std::string_view values[] = {"12345678901", "", "-7", "x1", "42"};
+    int64_t ints[5];
+    uint64_t nulls = 0;
+    ASSERT_EQ(StringHelp::ParseInt64Column(values, 5, ints, &nulls), 3u);
+    ASSERT_EQ(ints[0], INT64_C(12345678901));
+    ASSERT_EQ(ints[2], -7);
+    ASSERT_EQ(nulls, 0b01010u);
+
+    double reals[5];
+    ASSERT_EQ(StringHelp::ParseDoubleColumn(values, 5, reals, &nulls), 3u);
+    ASSERT_EQ(reals[4], 42.0);
+}
+
+TEST(String, CaseFolding)
+{
+    std::string text = "Content-Type: TEXT/html; Charset=UTF-8 [0123456789]";
+    ASSERT_EQ(StringHelp::ToLower(text),
+              "content-type: text/html; charset=utf-8 [0123456789]");
+    ASSERT_EQ(StringHelp::ToUpper(text),
+              "CONTENT-TYPE: TEXT/HTML; CHARSET=UTF-8 [0123456789]");
+    std::string mixed = "abc\xC3\xA9" + text;
+    StringHelp::ToUpperInPlace(mixed);
+    ASSERT_EQ(mixed.substr(0, 5), "ABC\xC3\xA9");
+    ASSERT_EQ(mixed.substr(5), StringHelp::ToUpper(text));
+
+    std::string a = text + text;
+    std::string b = StringHelp::ToUpper(a);
+    ASSERT_TRUE(StringHelp::IsEqual(a, b, true));
+    ASSERT_EQ(StringHelp::CompareNoCase(a, b), 0);
+    b[40] = '#';
+    ASSERT_FALSE(StringHelp::IsEqual(a, b, true));
+    ASSERT_LT(StringHelp::CompareNoCase(b, a), 0);
+
+    ASSERT_EQ(StringHelp::HashNoCase(a), StringHelp::HashNoCase(StringHelp::ToUpper(a)));
+    ASSERT_NE(StringHelp::HashNoCase("Accept"), StringHelp::HashNoCase("Accepts"));
+    std::unordered_map<std::string, int, StringHashNoCase, StringEqualNoCase> headers;
+    headers["Content-Length"] = 42;
+    ASSERT_EQ(headers.count("CONTENT-LENGTH"), 1u);
+}
+
+TEST(String, IconvCache)
+{
+    IconvCache::Clear();
+    IconvCache::ResetStats();
+    for (int i = 0; i < 3; ++i)
+    {
+        ASSERT_EQ(CA2W("caf\xe9", CP_ISO_8859_1).m_WStr, L"café");
+    }
+    IconvCacheStats stats = IconvCache::Stats();
+    ASSERT_EQ(stats.Misses, 1u);
+    ASSERT_EQ(stats.Hits, 2u);
+    ASSERT_EQ(stats.Cached, 1u);
+
+    // the code page is honored, and each direction has its own descriptor
+    ASSERT_EQ(CW2A(L"café", CP_ISO_8859_1).m_Str, "caf\xe9");
+    ASSERT_EQ(IconvCache::Stats().Cached, 2u);
+
+    IconvCache::SetCapacity(1);
+    ASSERT_EQ(IconvCache::Stats().Cached, 1u);
+    ASSERT_EQ(IconvCache::Stats().Evictions, 1u);
+    IconvCache::SetCapacity(8);
+    IconvCache::Clear();
+    ASSERT_EQ(IconvCache::Stats().Cached, 0u);
+}
+
+TEST(String, ConvertIntoBuffer)
+{
+    // the needed length is returned when the buffer is too small
+    char small[4];
+    ASSERT_EQ(Encoding::Convert(L"héllo", CP_UTF8, small, sizeof(small)), 6u);
+    ASSERT_EQ(std::string(small, 4), "h\xc3\xa9l");
+    ASSERT_EQ(Encoding::Convert("caf\xc3\xa9", CP_UTF8, CP_ISO_8859_1, small,
+                                sizeof(small)),
+              4u);
+    ASSERT_EQ(std::string(small, 4), "caf\xe9");
+    ASSERT_EQ(Encoding::Convert("caf\xe9!", CP_ISO_8859_1, CP_UTF8, small,
+                                sizeof(small)),
+              6u);
+
+    wchar_t wide[3];
+    ASSERT_EQ(Encoding::Convert(std::string(300, 'a'), CP_UTF8, wide, 3), 300u);
+    ASSERT_EQ(std::wstring(wide, 3), L"aaa");
+    std::string cjk;
+    for (int i = 0; i < 200; ++i) cjk += "\xe4\xb8\xad";
+    ASSERT_EQ(Encoding::Convert(cjk, CP_UTF8, wide, 3), 200u);
+
+    GrowByteBuffer buffer;
+    ASSERT_EQ(Encoding::Convert(std::string(100, '\xe9'), CP_ISO_8859_1, CP_UTF8,
+                                &buffer),
+              200u);
+    ASSERT_EQ(buffer.RealSize(), 200u);
+
+    CW2AEX<8> shortA(L"été");
+    ASSERT_STREQ(shortA, "\xc3\xa9t\xc3\xa9");
+    CW2AEX<8> longA(std::wstring(20, L'é'));
+    ASSERT_EQ(longA.Length(), 40u);
+    CA2WEX<> wideW("caf\xe9", CP_ISO_8859_1);
+    ASSERT_EQ(wideW.View(), L"café");
+    ASSERT_THROW(CA2WEX<>("\xff"), std::runtime_error);
+
+    ASSERT_STREQ(Utf8("abc"), "abc");
+    ASSERT_EQ(Local("abc").Str(), "abc");
+
+    // built from a temporary, which is gone before the first access
+    Utf8 utf8(std::string(64, 'x'));
+    ASSERT_EQ(utf8.Str(), std::string(64, 'x'));
+    Local local(std::string(64, 'y'));
+    ASSERT_STREQ(local, std::string(64, 'y').c_str());
+}
+
+static size_t naiveEditDistance(const std::string &a, const std::string &b)
+{
+    std::vector<size_t> row(b.size() + 1);
+    for (size_t j = 0; j <= b.size(); ++j) row[j] = j;
+    for (size_t i = 1; i <= a.size(); ++i)
+    {
+        size_t diag = row[0];
+        row[0] = i;
+        for (size_t j = 1; j <= b.size(); ++j)
+        {
+            size_t next = std::min({row[j] + 1, row[j - 1] + 1,
+                                    diag + (a[i - 1] == b[j - 1] ? 0 : 1)});
+            diag = row[j];
+            row[j] = next;
+        }
+    }
+    return row[b.size()];
+}
+
+TEST(String, EditDistance)
+{
+    ASSERT_EQ(StringHelp::EditDistance("kitten", "sitting"), 3u);
+    ASSERT_EQ(StringHelp::EditDistance("", "abc"), 3u);
+    ASSERT_EQ(StringHelp::EditDistance("same", "same"), 0u);
+    ASSERT_TRUE(StringHelp::WithinDistance("flaw", "lawn", 2));
+    ASSERT_FALSE(StringHelp::WithinDistance("flaw", "lawn", 1));
+    ASSERT_FALSE(StringHelp::WithinDistance("a", "abcdef", 3));
+
+    // random strings over a small alphabet, across the one-word and blocked paths
+    unsigned int seed = 7;
+    auto next = [&seed] { return seed = seed * 1103515245u + 12345u, seed >> 16; };
+    std::vector<std::string> words;
+    for (size_t nLen: {0, 1, 5, 63, 64, 65, 100, 130, 200})
+    {
+        for (int k = 0; k < 3; ++k)
+        {
+            std::string word;
+            for (size_t i = 0; i < nLen; ++i) word += static_cast<char>('a' + next() % 4);
+            words.push_back(word);
+        }
+    }
+    std::vector<std::string_view> views(words.begin(), words.end());
+    std::vector<size_t> distances(words.size());
+    for (const std::string &query: words)
+    {
+        StringHelp::EditDistances(query, views.data(), views.size(), distances.data());
+        for (size_t i = 0; i < words.size(); ++i)
+        {
+            size_t nExpected = naiveEditDistance(query, words[i]);
+            ASSERT_EQ(StringHelp::EditDistance(query, words[i]), nExpected);
+            ASSERT_EQ(distances[i], nExpected);
+            ASSERT_EQ(StringHelp::WithinDistance(query, words[i], 20), nExpected <= 20);
+        }
+        StringHelp::EditDistances(query, views.data(), views.size(), distances.data(), 10);
+        for (size_t i = 0; i < words.size(); ++i)
+            ASSERT_EQ(distances[i], std::min<size_t>(naiveEditDistance(query, words[i]), 11));
+    }
+}
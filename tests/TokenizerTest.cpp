@@ -0,0 +1,60 @@
+/**
+ * CPL - Common Portability Library
+ *
+ * Copyright (C) 2024 Merlot.Rain
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <cpl_ports.h>
+#include <gtest/gtest.h>
+
+using namespace CPL;
+
+TEST(Tokenizer, SingleChar)
+{
+    std::string str = "a,,bb,ccccccccccccccccccccccccccccccccccc,";
+    std::vector<std::string_view> tokens;
+    for (std::string_view token: Tokenizer(str, ','))
+        tokens.push_back(token);
+    ASSERT_EQ(tokens.size(), 5);
+    ASSERT_EQ(tokens[1], "");
+    ASSERT_EQ(tokens[3].size(), 35);
+    ASSERT_EQ(tokens[4], "");
+
+    Tokenizer skip(str, ',', Tokenizer::eSkipEmpty);
+    std::string_view token;
+    int count = 0;
+    while (skip.Next(token)) ++count;
+    ASSERT_EQ(count, 3);
+}
+
+TEST(Tokenizer, MultiChar)
+{
+    Tokenizer tokenizer(" a :: b ::::c", "::", {Tokenizer::eTrim, Tokenizer::eSkipEmpty});
+    std::vector<std::string_view> tokens(tokenizer.begin(), tokenizer.end());
+    ASSERT_EQ(tokens, (std::vector<std::string_view>{"a", "b", "c"}));
+}
+
+TEST(Tokenizer, MaxTokens)
+{
+    Tokenizer tokenizer("k=v=w", '=', Tokenizer::eNone, 2);
+    std::string_view key, value, extra;
+    ASSERT_TRUE(tokenizer.Next(key));
+    ASSERT_TRUE(tokenizer.Next(value));
+    ASSERT_FALSE(tokenizer.Next(extra));
+    ASSERT_EQ(key, "k");
+    ASSERT_EQ(value, "v=w");
+}
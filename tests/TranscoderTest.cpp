@@ -0,0 +1,142 @@
+/**
+ * CPL - Common Portability Library
+ *
+ * Copyright (C) 2024 Merlot.Rain
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <cpl_ports.h>
+#include <gtest/gtest.h>
+
+using namespace CPL;
+
+TEST(Transcoder, RoundTrip)
+{
+    // long ASCII runs around multi-byte characters of every length
+    std::string utf8 = std::string(40, 'a') + "\xc3\xa9" + std::string(17, 'b') +
+                       "\xe4\xb8\xad\xf0\x9f\x98\x80" + std::string(33, 'c');
+    std::wstring wide = std::wstring(40, L'a') + L"é" + std::wstring(17, L'b') +
+                        L"中\U0001F600" + std::wstring(33, L'c');
+    ASSERT_EQ(Transcoder::Utf8ToWide(utf8), wide);
+    ASSERT_EQ(Transcoder::WideToUtf8(wide), utf8);
+    ASSERT_EQ(Encoding::Utf8ToUnicode(utf8.c_str()), wide);
+    ASSERT_EQ(Encoding::ToUtf8(wide.c_str()), utf8);
+
+    std::u16string utf16(utf8.size(), u'\0');
+    TranscodeResult result = Transcoder::Utf8ToUtf16(utf8.data(), utf8.size(), &utf16[0]);
+    ASSERT_TRUE(result.Ok());
+    utf16.resize(result.Written);
+    ASSERT_EQ(utf16.size(), 40u + 1 + 17 + 1 + 2 + 33);
+    ASSERT_EQ(utf16[59], 0xD83D);
+    ASSERT_EQ(utf16[60], 0xDE00);
+
+    std::string back(utf16.size() * 3, '\0');
+    result = Transcoder::Utf16ToUtf8(utf16.data(), utf16.size(), &back[0]);
+    ASSERT_TRUE(result.Ok());
+    back.resize(result.Written);
+    ASSERT_EQ(back, utf8);
+}
+
+TEST(Transcoder, Errors)
+{
+    char32_t out[64];
+    auto check = [&](const std::string &text, TranscodeStatus eStatus, size_t nAt) {
+        TranscodeResult result = Transcoder::Utf8ToUtf32(text.data(), text.size(), out);
+        ASSERT_EQ(result.Status, eStatus) << text;
+        ASSERT_EQ(result.Read, nAt) << text;
+        ASSERT_EQ(result.Written, nAt) << text;
+    };
+    std::string pad(20, 'x');
+    check(pad + "\x80", TranscodeStatus::eInvalidByte, 20);
+    check(pad + "\xc3", TranscodeStatus::eTruncated, 20);
+    check(pad + "\xe4\xb8x", TranscodeStatus::eTruncated, 20);
+    check(pad + "\xc0\xaf", TranscodeStatus::eOverlong, 20);
+    check(pad + "\xed\xa0\x80", TranscodeStatus::eSurrogate, 20);
+    check(pad + "\xf4\x90\x80\x80", TranscodeStatus::eTooLarge, 20);
+
+    char16_t lone[] = {u'a', 0xD800, u'b'};
+    char utf8[16];
+    TranscodeResult result = Transcoder::Utf16ToUtf8(lone, 3, utf8);
+    ASSERT_EQ(result.Status, TranscodeStatus::eSurrogate);
+    ASSERT_EQ(result.Read, 1u);
+
+    ASSERT_THROW(Transcoder::Utf8ToWide("ab\xff"), std::invalid_argument);
+    ASSERT_THROW(CA2W("ab\xff"), std::runtime_error);
+}
+
+TEST(Transcoder, Validate)
+{
+    ASSERT_TRUE(Utf8::Validate(""));
+    ASSERT_TRUE(Utf8::Validate("plain ascii"));
+    std::string text;
+    for (int i = 0; i < 20; ++i) text += "ab\xc3\xa9\xe4\xb8\xad\xf0\x9f\x98\x80";
+    ASSERT_TRUE(Utf8::Validate(text));
+
+    // every error kind, at every offset around the 16-byte blocks
+    const char *bad[] = {"\x80", "\xc3", "\xe4\xb8", "\xc1\xbf", "\xe0\x9f\xbf",
+                         "\xed\xa0\x80", "\xf4\x90\x80\x80", "\xf8\x88\x80\x80\x80",
+                         "\xc3\xa9\xa9"};
+    for (const char *seq: bad)
+    {
+        for (size_t nAt = 0; nAt < 40; ++nAt)
+        {
+            std::string str = std::string(nAt, 'x') + seq + std::string(20, 'y');
+            std::string end = std::string(nAt, 'x') + seq;
+            TranscodeResult result = Transcoder::ValidateUtf8(str.data(), str.size());
+            ASSERT_FALSE(result.Ok()) << nAt;
+            ASSERT_GE(result.Read, nAt);
+            ASSERT_LE(result.Read, nAt + 2);
+            ASSERT_FALSE(Utf8::Validate(end)) << nAt;
+        }
+    }
+}
+
+TEST(Transcoder, InputStream)
+{
+    // the wrapped stream is read in 16 KiB blocks; an odd prefix splits the
+    // two-byte characters across the block boundary
+    std::string gbk = "x";
+    std::string utf8 = "x";
+    for (int i = 0; i < 20000; ++i)
+    {
+        gbk += "\xd6\xd0";
+        utf8 += "\xe4\xb8\xad";
+    }
+
+    TranscodingInputStreamPtr stream =
+            new TranscodingInputStream(new MemoryInputStream(gbk, false), CP_GBK);
+    std::string out;
+    unsigned char buff[1000];
+    int n;
+    while ((n = stream->RawRead(buff, sizeof(buff))) > 0)
+        out.append(reinterpret_cast<char *>(buff), n);
+    ASSERT_FALSE(stream->HasError());
+    ASSERT_TRUE(stream->Eof());
+    ASSERT_EQ(out, utf8);
+
+    std::string split = std::string(16383, 'a') + "\xc3\xa9";
+    stream = new TranscodingInputStream(new MemoryInputStream(split, false), CP_UTF8);
+    out.clear();
+    while ((n = stream->RawRead(buff, sizeof(buff))) > 0)
+        out.append(reinterpret_cast<char *>(buff), n);
+    ASSERT_FALSE(stream->HasError());
+    ASSERT_EQ(out, split);
+
+    std::string truncated = "abc\xe4\xb8";
+    stream = new TranscodingInputStream(new MemoryInputStream(truncated, false), CP_UTF8);
+    ASSERT_EQ(stream->RawRead(buff, sizeof(buff)), 3);
+    ASSERT_TRUE(stream->HasError());
+}